@@ -1537,6 +1537,12 @@ mpegts_base_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
   mpegts_packetizer_push (base->packetizer, buf);
 
+  /* Unless all packets are looked at, let the packetizer skip the ones we
+   * would drop below before parsing them */
+  if (!base->push_unknown && !klass->inspect_packet)
+    mpegts_packetizer_set_pid_filter (packetizer, base->is_pes,
+        base->known_psi);
+
   while (res == GST_FLOW_OK) {
     pret = mpegts_packetizer_next_packet (base->packetizer, &packet);
 
@@ -1586,6 +1592,8 @@ mpegts_base_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     mpegts_packetizer_clear_packet (base->packetizer, &packet);
   }
 
+  mpegts_packetizer_set_pid_filter (packetizer, NULL, NULL);
+
   if (res == GST_FLOW_OK && klass->input_done)
     res = klass->input_done (base);
 
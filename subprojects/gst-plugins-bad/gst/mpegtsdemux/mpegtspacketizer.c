@@ -60,6 +60,8 @@ static GstClockTime calculate_skew (MpegTSPacketizer2 * packetizer,
 static void _close_current_group (MpegTSPCR * pcrtable);
 static void record_pcr (MpegTSPacketizer2 * packetizer, MpegTSPCR * pcrtable,
     guint64 pcr, guint64 offset);
+static void mpegts_packetizer_flush_bytes (MpegTSPacketizer2 * packetizer,
+    gsize size);
 
 #define CONTINUITY_UNSET 255
 #define VERSION_NUMBER_UNSET 255
@@ -296,6 +298,7 @@ mpegts_packetizer_dispose (GObject * object)
       g_free (packetizer->streams);
     }
 
+    mpegts_packetizer_flush_bytes (packetizer, 0);
     gst_adapter_clear (packetizer->adapter);
     g_object_unref (packetizer->adapter);
     g_mutex_clear (&packetizer->group_lock);
@@ -601,13 +604,11 @@ mpegts_packetizer_clear (MpegTSPacketizer2 * packetizer)
     memset (packetizer->streams, 0, 8192 * sizeof (MpegTSPacketizerStream *));
   }
 
+  mpegts_packetizer_flush_bytes (packetizer, 0);
   gst_adapter_clear (packetizer->adapter);
   packetizer->offset = 0;
   packetizer->empty = TRUE;
   packetizer->need_sync = FALSE;
-  packetizer->map_data = NULL;
-  packetizer->map_size = 0;
-  packetizer->map_offset = 0;
   packetizer->last_in_time = GST_CLOCK_TIME_NONE;
   packetizer->last_pts = GST_CLOCK_TIME_NONE;
   packetizer->last_dts = GST_CLOCK_TIME_NONE;
@@ -642,14 +643,12 @@ mpegts_packetizer_flush (MpegTSPacketizer2 * packetizer, gboolean hard)
       }
     }
   }
+  mpegts_packetizer_flush_bytes (packetizer, 0);
   gst_adapter_clear (packetizer->adapter);
 
   packetizer->offset = 0;
   packetizer->empty = TRUE;
   packetizer->need_sync = FALSE;
-  packetizer->map_data = NULL;
-  packetizer->map_size = 0;
-  packetizer->map_offset = 0;
   packetizer->last_in_time = GST_CLOCK_TIME_NONE;
   packetizer->last_pts = GST_CLOCK_TIME_NONE;
   packetizer->last_dts = GST_CLOCK_TIME_NONE;
@@ -721,6 +720,12 @@ mpegts_packetizer_push (MpegTSPacketizer2 * packetizer, GstBuffer * buffer)
 static void
 mpegts_packetizer_flush_bytes (MpegTSPacketizer2 * packetizer, gsize size)
 {
+  if (packetizer->map_buffer) {
+    gst_buffer_unmap (packetizer->map_buffer, &packetizer->map_info);
+    gst_buffer_unref (packetizer->map_buffer);
+    packetizer->map_buffer = NULL;
+  }
+
   if (size > 0) {
     GST_LOG ("flushing %" G_GSIZE_FORMAT " bytes from adapter", size);
     gst_adapter_flush (packetizer->adapter, size);
@@ -745,11 +750,18 @@ mpegts_packetizer_map (MpegTSPacketizer2 * packetizer, gsize size)
   if (available < size)
     return FALSE;
 
-  packetizer->map_data =
-      (guint8 *) gst_adapter_map (packetizer->adapter, available);
-  if (!packetizer->map_data)
+  /* Keep the buffer around instead of using gst_adapter_map() so payloads
+   * can be shared with the input, see mpegts_packetizer_share_data() */
+  packetizer->map_buffer =
+      gst_adapter_get_buffer (packetizer->adapter, available);
+  if (!gst_buffer_map (packetizer->map_buffer, &packetizer->map_info,
+          GST_MAP_READ)) {
+    gst_buffer_unref (packetizer->map_buffer);
+    packetizer->map_buffer = NULL;
     return FALSE;
+  }
 
+  packetizer->map_data = packetizer->map_info.data;
   packetizer->map_size = available;
   packetizer->map_offset = 0;
 
@@ -814,6 +826,24 @@ out:
   return TRUE;
 }
 
+/* Whether the packet is on one of the filtered PIDs. Packets with a PCR are
+ * always wanted, the PCR observations and skew calculation need all of them */
+static inline gboolean
+mpegts_packetizer_want_packet (MpegTSPacketizer2 * packetizer,
+    const guint8 * data)
+{
+  guint16 pid = GST_READ_UINT16_BE (data + 1) & 0x1FFF;
+
+  if (MPEGTS_BIT_IS_SET (packetizer->pid_filter[0], pid))
+    return TRUE;
+  if (packetizer->pid_filter[1]
+      && MPEGTS_BIT_IS_SET (packetizer->pid_filter[1], pid))
+    return TRUE;
+
+  /* adaptation field with a non-zero length and the PCR flag */
+  return (data[3] & 0x20) && data[4] > 0 && (data[5] & MPEGTS_AFC_PCR_FLAG);
+}
+
 static gboolean
 mpegts_packetizer_sync (MpegTSPacketizer2 * packetizer)
 {
@@ -836,8 +866,18 @@ mpegts_packetizer_sync (MpegTSPacketizer2 * packetizer)
     sync_offset = 0;
 
   for (i = sync_offset; i + 2 * packet_size < size; i++) {
-    if (data[i] == PACKET_SYNC_BYTE &&
-        data[i + packet_size] == PACKET_SYNC_BYTE &&
+    guint8 *p;
+
+    /* let memchr() skip over the garbage, it is a lot faster than checking
+     * byte by byte */
+    p = memchr (data + i, PACKET_SYNC_BYTE, size - 2 * packet_size - i);
+    if (p == NULL) {
+      i = size - 2 * packet_size;
+      break;
+    }
+    i = p - data;
+
+    if (data[i + packet_size] == PACKET_SYNC_BYTE &&
         data[i + 2 * packet_size] == PACKET_SYNC_BYTE) {
       found = TRUE;
       break;
@@ -898,6 +938,11 @@ mpegts_packetizer_next_packet (MpegTSPacketizer2 * packetizer,
     if (G_UNLIKELY (*packet_data != PACKET_SYNC_BYTE)) {
       GST_DEBUG ("lost sync");
       packetizer->need_sync = TRUE;
+    } else if (packetizer->pid_filter[0]
+        && !mpegts_packetizer_want_packet (packetizer, packet_data)) {
+      /* skip it without parsing */
+      packetizer->offset += packet_size;
+      mpegts_packetizer_clear_packet (packetizer, packet);
     } else {
       /* ALL mpeg-ts variants contain 188 bytes of data. Those with bigger
        * packet sizes contain either extra data (timesync, FEC, ..) either
@@ -940,6 +985,30 @@ mpegts_packetizer_clear_packet (MpegTSPacketizer2 * packetizer,
   }
 }
 
+/* Returns a memory sharing @size bytes at @data with the input, or NULL if
+ * @data doesn't point into the input or the input can't be shared. Only valid
+ * for data of the current packet */
+GstMemory *
+mpegts_packetizer_share_data (MpegTSPacketizer2 * packetizer,
+    const guint8 * data, gsize size)
+{
+  GstMemory *mem;
+
+  if (packetizer->map_buffer == NULL
+      || gst_buffer_n_memory (packetizer->map_buffer) != 1)
+    return NULL;
+
+  if (data < packetizer->map_info.data
+      || data + size > packetizer->map_info.data + packetizer->map_info.size)
+    return NULL;
+
+  mem = gst_buffer_peek_memory (packetizer->map_buffer, 0);
+  if (GST_MEMORY_FLAG_IS_SET (mem, GST_MEMORY_FLAG_NO_SHARE))
+    return NULL;
+
+  return gst_memory_share (mem, data - packetizer->map_info.data, size);
+}
+
 gboolean
 mpegts_packetizer_has_packets (MpegTSPacketizer2 * packetizer)
 {
@@ -2581,6 +2650,17 @@ mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
   PACKETIZER_GROUP_UNLOCK (packetizer);
 }
 
+/* Only parse packets whose PID is set in @pids1 or @pids2 (which can be NULL).
+ * The bitmaps are not copied and must stay valid until the filter is reset
+ * with NULL @pids1 */
+void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+    const guint8 * pids1, const guint8 * pids2)
+{
+  packetizer->pid_filter[0] = pids1;
+  packetizer->pid_filter[1] = pids1 ? pids2 : NULL;
+}
+
 void
 mpegts_packetizer_set_current_pcr_offset (MpegTSPacketizer2 * packetizer,
     GstClockTime offset, guint16 pcr_pid)
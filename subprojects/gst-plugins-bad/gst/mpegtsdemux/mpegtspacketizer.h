@@ -264,11 +264,17 @@ struct _MpegTSPacketizer2 {
   gboolean       calculate_offset;
 
   /* Shortcuts for adapter usage */
+  GstBuffer *map_buffer;
+  GstMapInfo map_info;
   guint8 *map_data;
   gsize map_offset;
   gsize map_size;
   gboolean need_sync;
 
+  /* PID bitmaps of the packets to parse, not owned. Packets on other PIDs are
+   * skipped before parsing unless they carry a PCR. NULL to parse all */
+  const guint8 *pid_filter[2];
+
   /* Reference offset */
   guint64 refoffset;
 
@@ -357,6 +363,8 @@ G_GNUC_INTERNAL MpegTSPacketizerPacketReturn
 mpegts_packetizer_process_next_packet(MpegTSPacketizer2 * packetizer);
 G_GNUC_INTERNAL void mpegts_packetizer_clear_packet (MpegTSPacketizer2 *packetizer,
 				     MpegTSPacketizerPacket *packet);
+G_GNUC_INTERNAL GstMemory *mpegts_packetizer_share_data (MpegTSPacketizer2 *packetizer,
+				     const guint8 *data, gsize size);
 G_GNUC_INTERNAL void mpegts_packetizer_remove_stream(MpegTSPacketizer2 *packetizer,
   gint16 pid);
 
@@ -388,6 +396,9 @@ mpegts_packetizer_set_reference_offset (MpegTSPacketizer2 * packetizer,
 G_GNUC_INTERNAL void
 mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
 					GstClockTime threshold);
+G_GNUC_INTERNAL void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+				  const guint8 * pids1, const guint8 * pids2);
 G_END_DECLS
 
 #endif /* GST_MPEGTS_PACKETIZER_H */
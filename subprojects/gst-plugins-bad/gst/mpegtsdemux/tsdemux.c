@@ -172,6 +172,16 @@ struct _TSDemuxStream
   /* Data being reconstructed (allocated) */
   guint8 *data;
 
+  /* Data being reconstructed as memories shared with the input, used instead
+   * of ->data as long as the input can be shared. Each buffer holds up to
+   * gst_buffer_get_max_memory() memories */
+  GstBufferList *payload;
+  /* Whether the payload can be pushed as is, without being parsed */
+  gboolean zero_copy;
+  /* Whether the payload can be pushed as several buffers, as downstream
+   * parses it anyway. Otherwise it is merged into one buffer if needed */
+  gboolean split_payload;
+
   /* Size of data being reconstructed (if known, else 0) */
   guint expected_size;
 
@@ -2181,6 +2191,21 @@ gst_ts_demux_stream_added (MpegTSBase * base, MpegTSBaseStream * bstream,
 
     stream->active = FALSE;
 
+    stream->zero_copy = !((bstream->stream_type ==
+            GST_MPEGTS_STREAM_TYPE_PRIVATE_PES_PACKETS
+            && bstream->registration_id == DRF_ID_OPUS)
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_JP2K
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_AUDIO_AAC_ADTS
+        || (bstream->stream_type == GST_MPEGTS_STREAM_TYPE_METADATA_PES_PACKETS
+            && bstream->registration_id == DRF_ID_KLVA)
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_JPEG_XS);
+    stream->split_payload =
+        bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_MPEG1
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_MPEG2
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_MPEG4
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_H264
+        || bstream->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_HEVC;
+
     stream->need_newsegment = TRUE;
     /* Reset segment if we're not doing an accurate seek */
     demux->reset_segment =
@@ -2281,6 +2306,7 @@ gst_ts_demux_stream_flush (TSDemuxStream * stream, GstTSDemux * tsdemux,
 
   g_free (stream->data);
   stream->data = NULL;
+  gst_clear_buffer_list (&stream->payload);
   g_free (stream->pending_header_data);
   stream->pending_header_data = NULL;
   stream->pending_header_size = 0;
@@ -2731,6 +2757,22 @@ check_pending_buffers (GstTSDemux * demux)
   return TRUE;
 }
 
+/* Add @mem to the payload, in a new buffer once the last one is full */
+static void
+gst_ts_demux_stream_append_payload (TSDemuxStream * stream, GstMemory * mem)
+{
+  guint n = gst_buffer_list_length (stream->payload);
+  GstBuffer *buf = NULL;
+
+  if (n > 0)
+    buf = gst_buffer_list_get_writable (stream->payload, n - 1);
+  if (buf == NULL || gst_buffer_n_memory (buf) >= gst_buffer_get_max_memory ()) {
+    buf = gst_buffer_new ();
+    gst_buffer_list_add (stream->payload, buf);
+  }
+  gst_buffer_append_memory (buf, mem);
+}
+
 static void
 gst_ts_demux_parse_pes_header (GstTSDemux * demux, TSDemuxStream * stream,
     guint8 * data, guint32 length, guint64 bufferoffset)
@@ -2806,16 +2848,36 @@ gst_ts_demux_parse_pes_header (GstTSDemux * demux, TSDemuxStream * stream,
   data += header.header_size;
   length -= header.header_size;
 
+  g_assert (stream->data == NULL && stream->payload == NULL);
+
+  /* Try to reference the payload in the input instead of copying it */
+  if (stream->zero_copy && !stream->needs_keyframe) {
+    GstMemory *mem = NULL;
+
+    if (length > 0)
+      mem = mpegts_packetizer_share_data (MPEG_TS_BASE_PACKETIZER (demux),
+          data, length);
+
+    if (length == 0 || mem) {
+      stream->payload = gst_buffer_list_new ();
+      if (mem)
+        gst_ts_demux_stream_append_payload (stream, mem);
+      stream->allocated_size = 0;
+      stream->current_size = length;
+    }
+  }
+
   /* Create the output buffer */
-  if (stream->expected_size)
-    stream->allocated_size = MAX (stream->expected_size, length);
-  else
-    stream->allocated_size = MAX (8192, length);
+  if (stream->payload == NULL) {
+    if (stream->expected_size)
+      stream->allocated_size = MAX (stream->expected_size, length);
+    else
+      stream->allocated_size = MAX (8192, length);
 
-  g_assert (stream->data == NULL);
-  stream->data = g_malloc (stream->allocated_size);
-  memcpy (stream->data, data, length);
-  stream->current_size = length;
+    stream->data = g_malloc (stream->allocated_size);
+    memcpy (stream->data, data, length);
+    stream->current_size = length;
+  }
 
   stream->state = PENDING_PACKET_BUFFER;
 
@@ -2837,6 +2899,41 @@ discont:
   return;
 }
 
+/* Copy the payload gathered so far into ->data */
+static void
+gst_ts_demux_stream_merge_payload (TSDemuxStream * stream)
+{
+  guint i, n, offset = 0;
+
+  n = gst_buffer_list_length (stream->payload);
+  GST_LOG ("merging %u bytes in %u buffers", stream->current_size, n);
+
+  stream->allocated_size = MAX (stream->expected_size,
+      MAX (8192, stream->current_size));
+  stream->data = g_malloc (stream->allocated_size);
+  for (i = 0; i < n; i++) {
+    GstBuffer *buf = gst_buffer_list_get (stream->payload, i);
+
+    offset += gst_buffer_extract (buf, 0, stream->data + offset,
+        stream->current_size - offset);
+  }
+  g_assert (offset == stream->current_size);
+  gst_clear_buffer_list (&stream->payload);
+}
+
+/* Whether the payload can be pushed in the buffers it was gathered in */
+static gboolean
+gst_ts_demux_stream_can_push_payload (TSDemuxStream * stream)
+{
+  guint n;
+
+  if (stream->payload == NULL)
+    return FALSE;
+
+  n = gst_buffer_list_length (stream->payload);
+  return n == 1 || (n > 1 && stream->split_payload);
+}
+
  /* ONLY CALL THIS:
   * * WITH packet->payload != NULL
   * * WITH pending/current flushed out if beginning of new PES packet
@@ -2876,6 +2973,7 @@ gst_ts_demux_queue_data (GstTSDemux * demux, TSDemuxStream * stream,
           g_free (stream->data);
           stream->data = NULL;
         }
+        gst_clear_buffer_list (&stream->payload);
         if (G_UNLIKELY (stream->pending_header_data)) {
           g_free (stream->pending_header_data);
           stream->pending_header_data = NULL;
@@ -2920,6 +3018,20 @@ gst_ts_demux_queue_data (GstTSDemux * demux, TSDemuxStream * stream,
     case PENDING_PACKET_BUFFER:
     {
       GST_LOG_OBJECT (demux, "BUFFER: appending data");
+      if (stream->payload) {
+        GstMemory *mem;
+
+        mem = mpegts_packetizer_share_data (MPEG_TS_BASE_PACKETIZER (demux),
+            data, size);
+        if (mem) {
+          gst_ts_demux_stream_append_payload (stream, mem);
+          stream->current_size += size;
+          break;
+        }
+
+        /* The input can't be shared, continue with a copy */
+        gst_ts_demux_stream_merge_payload (stream);
+      }
       if (G_UNLIKELY (stream->current_size + size > stream->allocated_size)) {
         GST_LOG_OBJECT (demux, "resizing buffer");
         do {
@@ -2938,6 +3050,7 @@ gst_ts_demux_queue_data (GstTSDemux * demux, TSDemuxStream * stream,
         g_free (stream->data);
         stream->data = NULL;
       }
+      gst_clear_buffer_list (&stream->payload);
       if (G_UNLIKELY (stream->pending_header_data)) {
         g_free (stream->pending_header_data);
         stream->pending_header_data = NULL;
@@ -3595,7 +3708,7 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
       "stream:%p, pid:0x%04x stream_type:%d state:%d", stream, bs->pid,
       bs->stream_type, stream->state);
 
-  if (G_UNLIKELY (stream->data == NULL)) {
+  if (G_UNLIKELY (stream->data == NULL && stream->payload == NULL)) {
     GST_LOG_OBJECT (stream->pad, "stream->data == NULL");
     goto beach;
   }
@@ -3619,6 +3732,10 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
   if (stream->needs_keyframe) {
     MpegTSBase *base = (MpegTSBase *) demux;
 
+    /* The keyframe scanning needs contiguous data */
+    if (stream->payload)
+      gst_ts_demux_stream_merge_payload (stream);
+
     if ((gst_ts_demux_adjust_seek_offset_for_keyframe (stream, stream->data,
                 stream->current_size)) || demux->last_seek_offset == 0) {
       GST_DEBUG_OBJECT (stream->pad,
@@ -3666,6 +3783,7 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
         if (cand->data)
           g_free (cand->data);
         cand->data = NULL;
+        gst_clear_buffer_list (&cand->payload);
         cand->allocated_size = 0;
         cand->current_size = 0;
       }
@@ -3687,7 +3805,13 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
       buffer_list = parse_pes_metadata_frame (stream);
     } else if (bs->stream_type == GST_MPEGTS_STREAM_TYPE_VIDEO_JPEG_XS) {
       buffer = parse_jpegxs_access_unit (stream);
+    } else if (gst_ts_demux_stream_can_push_payload (stream)) {
+      buffer_list = stream->payload;
+      stream->payload = NULL;
     } else {
+      /* The memories don't fit in one buffer, merge them once */
+      if (stream->payload)
+        gst_ts_demux_stream_merge_payload (stream);
       buffer = gst_buffer_new_wrapped (stream->data, stream->current_size);
     }
     if (buffer == NULL && buffer_list == NULL) {
@@ -3875,6 +3999,7 @@ beach:
       stream->expected_size -= stream->current_size;
   }
   stream->data = NULL;
+  gst_clear_buffer_list (&stream->payload);
   stream->allocated_size = 0;
   stream->current_size = 0;
 
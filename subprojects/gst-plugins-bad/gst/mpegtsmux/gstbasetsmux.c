@@ -369,6 +369,50 @@ steal_si_section (GstMpegtsSectionType * type, TsMuxSection * section,
   return TRUE;
 }
 
+static void
+gst_base_ts_mux_clear_pool (GstBufferPool ** pool)
+{
+  if (*pool) {
+    gst_buffer_pool_set_active (*pool, FALSE);
+    gst_clear_object (pool);
+  }
+}
+
+/* Acquires a buffer of @size bytes from @pool, (re)creating the pool if
+ * needed. Must be called with mux->lock held */
+static GstBuffer *
+gst_base_ts_mux_acquire_buffer (GstBaseTsMux * mux, GstBufferPool ** pool,
+    guint size)
+{
+  GstBuffer *buf = NULL;
+  GstStructure *config;
+
+  if (*pool) {
+    if (gst_buffer_pool_acquire_buffer (*pool, &buf, NULL) == GST_FLOW_OK) {
+      if (gst_buffer_get_size (buf) == size)
+        return buf;
+      gst_buffer_unref (buf);
+      buf = NULL;
+    }
+    gst_base_ts_mux_clear_pool (pool);
+  }
+
+  *pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (*pool);
+  gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+
+  if (!gst_buffer_pool_set_config (*pool, config)
+      || !gst_buffer_pool_set_active (*pool, TRUE)
+      || gst_buffer_pool_acquire_buffer (*pool, &buf, NULL) != GST_FLOW_OK) {
+    GST_WARNING_OBJECT (mux, "Failed to set up a pool of %u bytes buffers",
+        size);
+    gst_base_ts_mux_clear_pool (pool);
+    buf = gst_buffer_new_and_alloc (size);
+  }
+
+  return buf;
+}
+
 /* Must be called with mux->lock held */
 static void
 gst_base_ts_mux_reset (GstBaseTsMux * mux, gboolean alloc)
@@ -390,6 +434,8 @@ gst_base_ts_mux_reset (GstBaseTsMux * mux, gboolean alloc)
 
   if (mux->out_adapter)
     gst_adapter_clear (mux->out_adapter);
+  gst_base_ts_mux_clear_pool (&mux->packet_pool);
+  gst_base_ts_mux_clear_pool (&mux->out_pool);
   mux->output_ts_offset = GST_CLOCK_STIME_NONE;
 
   if (mux->tsmux) {
@@ -1268,7 +1314,8 @@ new_packet_common_init (GstBaseTsMux * mux, GstBuffer * buf, guint8 * data,
         hbuf = gst_buffer_new_and_alloc (len);
         gst_buffer_fill (hbuf, 0, data, len);
       } else {
-        hbuf = gst_buffer_copy (buf);
+        /* don't keep the memory of the pooled packet */
+        hbuf = gst_buffer_copy_deep (buf);
       }
       GST_LOG_OBJECT (mux,
           "Collecting packet with pid 0x%04x into streamheaders", pid);
@@ -1305,6 +1352,7 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
   gint av, packet_size;
   GstFlowReturn flow_ret;
   GstClockTime pts;
+  GstMapInfo map;
 
   packet_size = mux->packet_size;
 
@@ -1344,7 +1392,18 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
     GstBuffer *buf;
 
     pts = gst_adapter_prev_pts (mux->out_adapter, NULL);
-    buf = gst_adapter_take_buffer (mux->out_adapter, align);
+    if (gst_adapter_available_fast (mux->out_adapter) >= align) {
+      /* can be shared with the collected buffer */
+      buf = gst_adapter_take_buffer (mux->out_adapter, align);
+    } else {
+      /* the packets need to be copied together, do that into a recycled
+       * buffer instead of a newly allocated one */
+      buf = gst_base_ts_mux_acquire_buffer (mux, &mux->out_pool, align);
+      gst_buffer_map (buf, &map, GST_MAP_WRITE);
+      gst_adapter_copy (mux->out_adapter, map.data, 0, align);
+      gst_buffer_unmap (buf, &map);
+      gst_adapter_flush (mux->out_adapter, align);
+    }
 
     GST_BUFFER_PTS (buf) = pts;
 
@@ -1357,16 +1416,15 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
     guint8 *data;
     guint32 header;
     gint dummy;
-    GstMapInfo map;
 
     GST_LOG_OBJECT (mux, "handling %d leftover bytes", av);
 
     pts = gst_adapter_prev_pts (mux->out_adapter, NULL);
-    buf = gst_buffer_new_and_alloc (align);
+    buf = gst_base_ts_mux_acquire_buffer (mux, &mux->out_pool, align);
 
     GST_BUFFER_PTS (buf) = pts;
 
-    gst_buffer_map (buf, &map, GST_MAP_READ);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
     data = map.data;
 
     gst_adapter_copy (mux->out_adapter, data, 0, av);
@@ -3016,7 +3074,10 @@ gst_base_ts_mux_default_allocate_packet (GstBaseTsMux * mux,
 {
   GstBuffer *buf;
 
-  buf = gst_buffer_new_and_alloc (mux->packet_size);
+  /* packets return to the pool once they were copied into the output or
+   * released downstream */
+  buf = gst_base_ts_mux_acquire_buffer (mux, &mux->packet_pool,
+      mux->packet_size);
 
   *buffer = buf;
 }
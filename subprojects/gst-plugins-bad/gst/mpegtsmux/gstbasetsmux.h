@@ -186,6 +186,9 @@ struct GstBaseTsMux {
   /* output buffer aggregation */
   GstAdapter *out_adapter;
   GstBuffer *out_buffer;
+  /* recycled packets and aligned output buffers */
+  GstBufferPool *packet_pool;
+  GstBufferPool *out_pool;
   GstClockTimeDiff output_ts_offset;
 
   /* protects the tsmux object, the programs hash table, and pad streams */
@@ -21,6 +21,7 @@
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
+#include <gst/mpegts/mpegts.h>
 
 #define PACKETSIZE 188
 
@@ -377,6 +378,257 @@ GST_START_TEST (test_tsdemux_simple)
 
 GST_END_TEST;
 
+/* Appends a packet on @pid that is not part of the program, with only an
+ * adaptation field carrying a PCR if @pcr, or else with a PES header */
+static void
+append_unwanted_packet (GByteArray * ts, guint16 pid, gboolean pcr)
+{
+  guint8 packet[PACKETSIZE];
+
+  packet[0] = 0x47;
+  GST_WRITE_UINT16_BE (packet + 1, 0x4000 | pid);
+  if (pcr) {
+    packet[3] = 0x20;
+    packet[4] = PACKETSIZE - 5;
+    packet[5] = 0x10;
+    memset (packet + 6, 0, 6);
+    memset (packet + 12, 0xff, PACKETSIZE - 12);
+  } else {
+    static const guint8 pes_header[] = { 0x00, 0x00, 0x01, 0xe0, 0x00, 0x00,
+      0x80, 0x00, 0x00
+    };
+
+    packet[3] = 0x10;
+    memcpy (packet + 4, pes_header, sizeof pes_header);
+    memset (packet + 4 + sizeof pes_header, 0x47,
+        PACKETSIZE - 4 - sizeof pes_header);
+  }
+
+  g_byte_array_append (ts, packet, PACKETSIZE);
+}
+
+GST_START_TEST (test_tsdemux_pid_filter)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("tsdemux", "sink", NULL);
+  guint8 garbage[60];
+  GByteArray *ts;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstSegment segment;
+
+  caps = gst_caps_from_string ("video/mpegts,systemstream=true");
+  gst_harness_push_event (h, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_harness_push_event (h, gst_event_new_segment (&segment));
+
+  gst_harness_set_sink_caps_str (h,
+      "audio/mpeg,mpegversion=4,stream-format=adts");
+
+  g_signal_connect (h->element, "pad-added",
+      G_CALLBACK (tsdemux_simple_pad_added), h);
+
+  /* Garbage with a few stray sync bytes */
+  memset (garbage, 0xaa, sizeof garbage);
+  garbage[5] = garbage[20] = garbage[41] = 0x47;
+
+  /* Leading garbage, then the PAT and PMT, packets on PIDs that are not in
+   * the program, with and without a PCR, between the PES packets, and more
+   * garbage in the middle to make the packetizer resync */
+  ts = g_byte_array_new ();
+  g_byte_array_append (ts, garbage, sizeof garbage);
+  g_byte_array_append (ts, aac_ts, 2 * PACKETSIZE);
+  append_unwanted_packet (ts, 0x100, FALSE);
+  append_unwanted_packet (ts, 0x101, TRUE);
+  g_byte_array_append (ts, aac_ts + 2 * PACKETSIZE, PACKETSIZE);
+  append_unwanted_packet (ts, 0x100, FALSE);
+  g_byte_array_append (ts, garbage, 30);
+  g_byte_array_append (ts, aac_ts + 3 * PACKETSIZE, PACKETSIZE);
+  append_unwanted_packet (ts, 0x101, TRUE);
+  append_unwanted_packet (ts, 0x100, FALSE);
+  g_byte_array_append (ts, aac_ts + 4 * PACKETSIZE, PACKETSIZE);
+  g_byte_array_append (ts, padding_ts, PACKETSIZE);
+
+  buf = gst_buffer_new_wrapped (ts->data, ts->len);
+  g_byte_array_free (ts, FALSE);
+  fail_unless (gst_harness_push (h, buf) == GST_FLOW_OK);
+  gst_harness_push_event (h, gst_event_new_eos ());
+
+  /* Only the payload of the program is output */
+  buf = gst_harness_take_all_data_as_buffer (h);
+  gst_check_buffer_data (buf, aac_data, sizeof aac_data);
+  gst_buffer_unref (buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* Position of the stream type and CRC of the PMT in the second packet */
+#define PMT_STREAM_TYPE_OFFSET (PACKETSIZE + 173)
+#define PMT_CRC_OFFSET (PACKETSIZE + 184)
+
+GST_START_TEST (test_tsdemux_zero_copy)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("tsdemux", "sink", NULL);
+  const guint8 *expected = aac_data;
+  guint8 *data;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstSegment segment;
+  guint n_buffers = 0;
+
+  caps = gst_caps_from_string ("video/mpegts,systemstream=true");
+  gst_harness_push_event (h, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_harness_push_event (h, gst_event_new_segment (&segment));
+
+  gst_harness_set_sink_caps_str (h, "audio/mpeg,mpegversion=1");
+
+  g_signal_connect (h->element, "pad-added",
+      G_CALLBACK (tsdemux_simple_pad_added), h);
+
+  /* Announce the stream as MPEG-1 audio, which is pushed without parsing the
+   * payload, unlike AAC */
+  data = g_memdup2 (aac_ts, sizeof aac_ts);
+  data[PMT_STREAM_TYPE_OFFSET] = GST_MPEGTS_STREAM_TYPE_AUDIO_MPEG1;
+  GST_WRITE_UINT32_BE (data + PMT_CRC_OFFSET, 0xc274551d);
+
+  buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, data,
+      sizeof aac_ts, 0, sizeof aac_ts, NULL, NULL);
+  fail_unless (gst_harness_push (h, buf) == GST_FLOW_OK);
+  gst_harness_push_event (h, gst_event_new_eos ());
+
+  /* The payloads are output as is and reference the input data */
+  while ((buf = gst_harness_try_pull (h))) {
+    GstMapInfo map;
+
+    fail_unless_equals_int (gst_buffer_n_memory (buf), 1);
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+    fail_unless (map.data >= data && map.data < data + sizeof aac_ts);
+    fail_unless (expected + map.size <= aac_data + sizeof aac_data);
+    fail_unless (memcmp (map.data, expected, map.size) == 0);
+    expected += map.size;
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_unref (buf);
+    n_buffers++;
+  }
+  fail_unless_equals_int (n_buffers, 3);
+  fail_unless (expected == aac_data + sizeof aac_data);
+
+  gst_harness_teardown (h);
+  g_free (data);
+}
+
+GST_END_TEST;
+
+static void
+tsdemux_video_pad_added (GstElement * tsdemux, GstPad * pad, GstHarness * h)
+{
+  fail_unless (g_strcmp0 (GST_PAD_NAME (pad), "video_0_0041") == 0);
+  gst_harness_add_element_src_pad (h, pad);
+}
+
+#define N_VIDEO_PES_PACKETS 40
+
+GST_START_TEST (test_tsdemux_zero_copy_video)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("tsdemux", "sink", NULL);
+  /* Adaptation field with a PCR, then a PES header with a PTS */
+  static const guint8 pes_start[] = { 0x07, 0x10, 0x09, 0xa7, 0xd6, 0x87,
+    0x7e, 0x00, 0x00, 0x00, 0x01, 0xe0, 0x00, 0x00, 0x80, 0x80, 0x05, 0x21,
+    0x4d, 0x3f, 0xb2, 0x01
+  };
+  guint8 *data, *payload, *expected;
+  gsize size, payload_size = 0;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstSegment segment;
+  guint max_memory = gst_buffer_get_max_memory ();
+  guint i, n_buffers = 0;
+
+  caps = gst_caps_from_string ("video/mpegts,systemstream=true");
+  gst_harness_push_event (h, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_harness_push_event (h, gst_event_new_segment (&segment));
+
+  gst_harness_set_sink_caps_str (h, "video/x-h264");
+
+  g_signal_connect (h->element, "pad-added",
+      G_CALLBACK (tsdemux_video_pad_added), h);
+
+  /* The PAT and the PMT, announcing an H.264 stream, followed by one video
+   * PES spanning many more packets than a buffer can hold memories */
+  size = 2 * PACKETSIZE + N_VIDEO_PES_PACKETS * PACKETSIZE;
+  data = g_malloc (size);
+  memcpy (data, aac_ts, 2 * PACKETSIZE);
+  data[PMT_STREAM_TYPE_OFFSET] = GST_MPEGTS_STREAM_TYPE_VIDEO_H264;
+  GST_WRITE_UINT32_BE (data + PMT_CRC_OFFSET, 0xb3d0f935);
+
+  expected = g_malloc (N_VIDEO_PES_PACKETS * PACKETSIZE);
+  for (i = 0; i < N_VIDEO_PES_PACKETS; i++) {
+    guint8 *packet = data + (2 + i) * PACKETSIZE;
+    guint header_size = 4;
+
+    packet[0] = 0x47;
+    packet[1] = i == 0 ? 0x40 : 0x00;
+    packet[2] = 0x41;
+    packet[3] = (i == 0 ? 0x30 : 0x10) | (i & 0xf);
+    if (i == 0) {
+      memcpy (packet + 4, pes_start, sizeof pes_start);
+      header_size += sizeof pes_start;
+    }
+
+    payload = packet + header_size;
+    memset (payload, i, PACKETSIZE - header_size);
+    memcpy (expected + payload_size, payload, PACKETSIZE - header_size);
+    payload_size += PACKETSIZE - header_size;
+  }
+
+  buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, data, size, 0,
+      size, NULL, NULL);
+  fail_unless (gst_harness_push (h, buf) == GST_FLOW_OK);
+  gst_harness_push_event (h, gst_event_new_eos ());
+
+  /* The PES is output as several buffers referencing the input data */
+  payload = expected;
+  while ((buf = gst_harness_try_pull (h))) {
+    guint n_memory = gst_buffer_n_memory (buf);
+
+    fail_unless (n_memory <= max_memory);
+    if (n_buffers == 0)
+      fail_unless (GST_BUFFER_PTS_IS_VALID (buf));
+
+    for (i = 0; i < n_memory; i++) {
+      GstMemory *mem = gst_buffer_peek_memory (buf, i);
+      GstMapInfo map;
+
+      fail_unless (gst_memory_map (mem, &map, GST_MAP_READ));
+      fail_unless (map.data >= data && map.data < data + size);
+      fail_unless (payload + map.size <= expected + payload_size);
+      fail_unless (memcmp (map.data, payload, map.size) == 0);
+      payload += map.size;
+      gst_memory_unmap (mem, &map);
+    }
+    gst_buffer_unref (buf);
+    n_buffers++;
+  }
+  fail_unless_equals_int (n_buffers,
+      (N_VIDEO_PES_PACKETS + max_memory - 1) / max_memory);
+  fail_unless (payload == expected + payload_size);
+
+  gst_harness_teardown (h);
+  g_free (expected);
+  g_free (data);
+}
+
+GST_END_TEST;
+
 static Suite *
 mpegtsdemux_suite (void)
 {
@@ -394,6 +646,9 @@ mpegtsdemux_suite (void)
   tc = tcase_create ("tsdemux");
   suite_add_tcase (s, tc);
   tcase_add_test (tc, test_tsdemux_simple);
+  tcase_add_test (tc, test_tsdemux_pid_filter);
+  tcase_add_test (tc, test_tsdemux_zero_copy);
+  tcase_add_test (tc, test_tsdemux_zero_copy_video);
 
   return s;
 }
@@ -19,6 +19,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <string.h>
 #include <gst/video/video.h>
 
@@ -557,6 +558,86 @@ GST_START_TEST (test_align)
 
 GST_END_TEST;
 
+/* Muxes @n_bufs small audio buffers with an alignment of 7 packets and checks
+ * that every output buffer holds 7 packets, the last one completed with null
+ * packets. Returns the number of null packets */
+static guint
+check_aligned_output (gboolean m2ts, guint n_bufs)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("mpegtsmux", "sink_%d", "src");
+  guint packet_size = m2ts ? 192 : 188;
+  guint sync_offset = m2ts ? 4 : 0;
+  guint n_packets = 0, n_null = 0;
+  gboolean last = FALSE;
+  GstBuffer *buf;
+  guint i;
+
+  g_object_set (h->element, "alignment", 7, "m2ts-mode", m2ts, NULL);
+  gst_harness_set_src_caps_str (h, AUDIO_CAPS_STRING);
+
+  for (i = 0; i < n_bufs; i++) {
+    buf = gst_buffer_new_and_alloc (100);
+    gst_buffer_memset (buf, 0, i, 100);
+    GST_BUFFER_PTS (buf) = i * 40 * GST_MSECOND;
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  gst_harness_push_event (h, gst_event_new_eos ());
+
+  while ((buf = gst_harness_try_pull (h))) {
+    GstMapInfo map;
+    guint8 *data;
+
+    /* nothing after the buffer completed with null packets */
+    fail_if (last);
+
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+    fail_unless_equals_int (map.size, 7 * packet_size);
+
+    for (data = map.data; data < map.data + map.size; data += packet_size) {
+      guint16 pid;
+
+      fail_unless_equals_int (data[sync_offset], 0x47);
+      pid = GST_READ_UINT16_BE (data + sync_offset + 1) & 0x1fff;
+      if (pid == 0x1fff) {
+        n_null++;
+        last = TRUE;
+      } else {
+        /* the null packets only come after all the others */
+        fail_if (last);
+        n_packets++;
+      }
+    }
+
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_unref (buf);
+  }
+
+  fail_unless (n_packets > 0);
+  fail_unless_equals_int (n_null, (7 - n_packets % 7) % 7);
+
+  gst_harness_teardown (h);
+
+  return n_null;
+}
+
+GST_START_TEST (test_align_leftover)
+{
+  /* fewer packets than the alignment, only the padded buffer */
+  fail_unless (check_aligned_output (FALSE, 2) > 0);
+  /* full buffers, possibly followed by a padded one */
+  check_aligned_output (FALSE, 50);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_align_m2ts)
+{
+  fail_unless (check_aligned_output (TRUE, 2) > 0);
+  check_aligned_output (TRUE, 50);
+}
+
+GST_END_TEST;
+
 static void
 test_keyframe_propagation_check_output (GList * bufs)
 {
@@ -598,6 +679,8 @@ mpegtsmux_suite (void)
   tcase_add_test (tc_chain, test_video);
   tcase_add_test (tc_chain, test_multiple_state_change);
   tcase_add_test (tc_chain, test_align);
+  tcase_add_test (tc_chain, test_align_leftover);
+  tcase_add_test (tc_chain, test_align_m2ts);
   tcase_add_test (tc_chain, test_keyframe_flag_propagation);
   tcase_add_test (tc_chain, test_reappearing_pad_while_playing);
   tcase_add_test (tc_chain, test_reappearing_pad_while_stopped);
@@ -0,0 +1,157 @@
+/* GStreamer
+ *
+ * ts-demux-benchmark.c: measure tsdemux ingest throughput on recorded files
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Demuxes each of the given transport stream captures (typically full DVB
+ * multiplexes) as fast as possible into fakesinks and reports the throughput.
+ * With a program number only that program is exposed, which shows the cost of
+ * skipping the packets of all the other programs. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+
+static void
+on_pad_added (GstElement * demux, GstPad * pad, GstElement * pipeline)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (GST_BIN (pipeline), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+static gboolean
+do_benchmark (const gchar * location, gint program, gboolean push_mode,
+    guint iterations)
+{
+  GstElement *pipeline, *src, *demux;
+  GstClockTime start, elapsed = 0;
+  gint64 size = 0;
+  gboolean res = TRUE;
+  gchar *desc;
+  guint i;
+
+  desc = g_strdup_printf ("filesrc name=src ! %s tsdemux name=demux",
+      push_mode ? "queue !" : "");
+
+  for (i = 0; i < iterations && res; i++) {
+    GstMessage *msg;
+    GError *err = NULL;
+
+    pipeline = gst_parse_launch (desc, &err);
+    if (pipeline == NULL) {
+      gst_printerrln ("Could not create pipeline: %s", err->message);
+      g_clear_error (&err);
+      g_free (desc);
+      return FALSE;
+    }
+
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    demux = gst_bin_get_by_name (GST_BIN (pipeline), "demux");
+    g_object_set (src, "location", location, NULL);
+    if (program >= 0)
+      g_object_set (demux, "program-number", program, NULL);
+    g_signal_connect (demux, "pad-added", G_CALLBACK (on_pad_added), pipeline);
+
+    start = gst_util_get_timestamp ();
+    gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+        GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    elapsed += gst_util_get_timestamp () - start;
+
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+      gst_message_parse_error (msg, &err, NULL);
+      gst_printerrln ("%s: %s", location, err->message);
+      g_clear_error (&err);
+      res = FALSE;
+    } else if (size == 0
+        && !gst_element_query_duration (src, GST_FORMAT_BYTES, &size)) {
+      size = 0;
+    }
+    gst_message_unref (msg);
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (demux);
+    gst_object_unref (src);
+    gst_object_unref (pipeline);
+  }
+
+  if (res) {
+    gst_println ("%s: %" G_GINT64_FORMAT " bytes, %" GST_TIME_FORMAT
+        " per run, %.1f Mbit/s", location, size,
+        GST_TIME_ARGS (elapsed / iterations),
+        (gdouble) size * iterations * 8 * 1000 / MAX (elapsed, 1));
+  }
+
+  g_free (desc);
+
+  return res;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint program = -1;
+  gint iterations = 5;
+  gboolean push_mode = FALSE;
+  GOptionContext *ctx;
+  gboolean res = TRUE;
+  gint i;
+  GOptionEntry options[] = {
+    {"program-number", 'p', 0, G_OPTION_ARG_INT, &program,
+        "Only demux this program (default: all)", "N"},
+    {"iterations", 'n', 0, G_OPTION_ARG_INT, &iterations,
+        "Number of runs for each file", "N"},
+    {"push", 0, 0, G_OPTION_ARG_NONE, &push_mode,
+        "Run tsdemux in push mode instead of pull mode", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("FILE...");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (argc < 2 || iterations <= 0) {
+    gst_printerrln ("usage: %s [-p N] [-n N] [--push] FILE...", argv[0]);
+    return 1;
+  }
+
+  for (i = 1; i < argc; i++)
+    res &= do_benchmark (argv[i], program, push_mode, iterations);
+
+  return res ? 0 : 1;
+}
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "audio-channel-mixer.h"
+#include "gstaudioutilsprivate.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -1194,3 +1195,22 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
 
   mix->func (mix, in, out, samples);
 }
+
+/* Copy the mix matrix of @mix into @matrix, which must have room for
+ * in_channels * out_channels values. The result is transposed compared to
+ * the internal representation, m[out_channels][in_channels], so that the
+ * coefficients for one output channel are contiguous. */
+void
+__gst_audio_channel_mixer_get_matrix (GstAudioChannelMixer * mix,
+    gfloat * matrix)
+{
+  gint i, j;
+
+  g_return_if_fail (mix != NULL);
+  g_return_if_fail (mix->matrix != NULL);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    for (i = 0; i < mix->in_channels; i++)
+      matrix[j * mix->in_channels + i] = mix->matrix[i][j];
+  }
+}
@@ -29,6 +29,7 @@
 
 #include "audio-converter.h"
 #include "gstaudiopack.h"
+#include "gstaudioutilsprivate.h"
 
 /**
  * SECTION:gstaudioconverter
@@ -76,6 +77,8 @@ typedef gboolean (*AudioConvertSamplesFunc) (GstAudioConverter * convert,
     gpointer out[], gsize out_frames);
 typedef void (*AudioConvertEndianFunc) (gpointer dst, const gpointer src,
     gint count);
+typedef void (*AudioConvertFusedFunc) (GstAudioConverter * convert,
+    gconstpointer src, gfloat * dst, gsize frames);
 
 /*                           int/int    int/float  float/int float/float
  *
@@ -90,6 +93,12 @@ typedef void (*AudioConvertEndianFunc) (gpointer dst, const gpointer src,
  *  interleave
  *  deinterleave
  *  resample
+ *
+ * For some common conversions to interleaved F32 the unpack, convert and
+ * channel mix steps are done in one fused pass over the input, without
+ * intermediate buffers. When resampling is allowed by the fused-resample
+ * option, this is done in blocks of FUSED_BLOCK_FRAMES that are fed to an
+ * F32 resampler while still in cache.
  */
 struct _GstAudioConverter
 {
@@ -146,6 +155,11 @@ struct _GstAudioConverter
   AudioConvertEndianFunc swap_endian;
 
   AudioConvertSamplesFunc convert;
+
+  /* fused unpack/convert/mix, m[out_channels][in_channels] */
+  AudioConvertFusedFunc fused_func;
+  gfloat *fused_matrix;
+  gfloat *fused_tmp;
 };
 
 static GstAudioConverter *
@@ -282,6 +296,15 @@ get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
   return res;
 }
 
+static gboolean
+get_opt_bool (GstAudioConverter * convert, const gchar * opt, gboolean def)
+{
+  gboolean res;
+  if (!gst_structure_get_boolean (convert->config, opt, &res))
+    res = def;
+  return res;
+}
+
 static const GValue *
 get_opt_value (GstAudioConverter * convert, const gchar * opt)
 {
@@ -293,6 +316,8 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
 #define DEFAULT_OPT_DITHER_THRESHOLD 20
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_FUSED TRUE
+#define DEFAULT_OPT_FUSED_RESAMPLE FALSE
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -309,6 +334,10 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
 #define GET_OPT_MIX_MATRIX(c) get_opt_value(c, \
     GST_AUDIO_CONVERTER_OPT_MIX_MATRIX)
+#define GET_OPT_FUSED(c) get_opt_bool(c, \
+    GST_AUDIO_CONVERTER_OPT_FUSED, DEFAULT_OPT_FUSED)
+#define GET_OPT_FUSED_RESAMPLE(c) get_opt_bool(c, \
+    GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE, DEFAULT_OPT_FUSED_RESAMPLE)
 
 static gboolean
 copy_config (const GstIdStr * fieldname, const GValue * value,
@@ -845,8 +874,8 @@ mix_matrix_from_g_value (guint in_channels, guint out_channels,
   return matrix;
 }
 
-static AudioChain *
-chain_mix (GstAudioConverter * convert, AudioChain * prev)
+static void
+setup_mix (GstAudioConverter * convert)
 {
   GstAudioInfo *in = &convert->in;
   GstAudioInfo *out = &convert->out;
@@ -890,6 +919,12 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
   GST_INFO ("mix format %s, passthrough %d, in_channels %d, out_channels %d",
       gst_audio_format_to_string (format), convert->mix_passthrough,
       in->channels, out->channels);
+}
+
+static AudioChain *
+chain_mix (GstAudioConverter * convert, AudioChain * prev)
+{
+  setup_mix (convert);
 
   if (!convert->mix_passthrough) {
     prev = audio_chain_new (prev, convert);
@@ -900,8 +935,8 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
   return prev;
 }
 
-static AudioChain *
-chain_resample (GstAudioConverter * convert, AudioChain * prev)
+static gboolean
+setup_resample (GstAudioConverter * convert)
 {
   GstAudioInfo *in = &convert->in;
   GstAudioInfo *out = &convert->out;
@@ -913,26 +948,35 @@ chain_resample (GstAudioConverter * convert, AudioChain * prev)
 
   variable_rate = convert->flags & GST_AUDIO_CONVERTER_FLAG_VARIABLE_RATE;
 
-  if (in->rate != out->rate || variable_rate) {
-    method = GET_OPT_RESAMPLER_METHOD (convert);
+  if (in->rate == out->rate && !variable_rate)
+    return FALSE;
 
-    flags = 0;
-    if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
-      flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN;
-    }
-    /* if the resampler is activated, it is optimal to change layout here */
-    if (out->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
-      flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT;
-    }
-    convert->current_layout = out->layout;
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+
+  flags = 0;
+  if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN;
+  }
+  /* if the resampler is activated, it is optimal to change layout here */
+  if (out->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    flags |= GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT;
+  }
+  convert->current_layout = out->layout;
 
-    if (variable_rate)
-      flags |= GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE;
+  if (variable_rate)
+    flags |= GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE;
 
-    convert->resampler =
-        gst_audio_resampler_new (method, flags, format, channels, in->rate,
-        out->rate, convert->config);
+  convert->resampler =
+      gst_audio_resampler_new (method, flags, format, channels, in->rate,
+      out->rate, convert->config);
 
+  return TRUE;
+}
+
+static AudioChain *
+chain_resample (GstAudioConverter * convert, AudioChain * prev)
+{
+  if (setup_resample (convert)) {
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = FALSE;
     prev->pass_alloc = FALSE;
@@ -1319,6 +1363,180 @@ converter_resample (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* number of frames processed per block by the fused converter when
+ * resampling, small enough to keep the mixed samples in L1 cache */
+#define FUSED_BLOCK_FRAMES 256
+
+#define CONVERT_S16(s) ((s) * (1.0 / 32768.0))
+#define CONVERT_F32(s) (s)
+
+/* unpack, convert and mix @frames interleaved frames from @src into
+ * interleaved F32 in @dst in one pass. This uses the same intermediate
+ * precision as the staged chain, so the results are identical. */
+#define MAKE_FUSED_FUNC(name, intype, restype, conv) \
+static void \
+fused_##name (GstAudioConverter * convert, gconstpointer src, \
+    gfloat * dst, gsize frames) \
+{ \
+  const intype *in = src; \
+  const gfloat *m = convert->fused_matrix; \
+  gint in_channels = convert->in.channels; \
+  gint out_channels = convert->out.channels; \
+  restype res; \
+  gsize n; \
+  gint i, j; \
+  \
+  if (convert->mix_passthrough) { \
+    for (n = 0; n < frames * in_channels; n++) \
+      dst[n] = conv (in[n]); \
+  } else if (in_channels == 2 && out_channels == 1) { \
+    restype m0 = m[0], m1 = m[1]; \
+    for (n = 0; n < frames; n++, in += 2) { \
+      res = 0.0; \
+      res += conv (in[0]) * m0; \
+      res += conv (in[1]) * m1; \
+      dst[n] = res; \
+    } \
+  } else { \
+    for (n = 0; n < frames; n++) { \
+      for (j = 0; j < out_channels; j++) { \
+        const gfloat *row = &m[j * in_channels]; \
+        res = 0.0; \
+        for (i = 0; i < in_channels; i++) \
+          res += conv (in[i]) * row[i]; \
+        dst[j] = res; \
+      } \
+      in += in_channels; \
+      dst += out_channels; \
+    } \
+  } \
+}
+
+MAKE_FUSED_FUNC (s16_f32, gint16, gdouble, CONVERT_S16);
+MAKE_FUSED_FUNC (f32_f32, gfloat, gfloat, CONVERT_F32);
+
+static gboolean
+converter_fused (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  GstAudioResampler *resampler = convert->resampler;
+  const guint8 *src = in ? in[0] : NULL;
+  gfloat *dst = out[0];
+  gint out_channels = convert->out.channels;
+  gsize out_left;
+
+  if (resampler == NULL) {
+    GST_LOG ("fused: %" G_GSIZE_FORMAT " frames", in_frames);
+
+    /* no intermediate buffer needed, write straight into the output */
+    if (src)
+      convert->fused_func (convert, src, dst, in_frames);
+    else
+      gst_audio_format_info_fill_silence (convert->out.finfo, dst,
+          in_frames * convert->out.bpf);
+    return TRUE;
+  }
+
+  GST_LOG ("fused resample: %" G_GSIZE_FORMAT " -> %" G_GSIZE_FORMAT " frames",
+      in_frames, out_frames);
+
+  out_left = out_frames;
+  while (in_frames > 0) {
+    gsize block_in, block_out;
+    gpointer tmp[1], out_block[1];
+
+    block_in = MIN (in_frames, FUSED_BLOCK_FRAMES);
+    in_frames -= block_in;
+
+    /* the last block takes whatever output is left so that we always
+     * produce exactly @out_frames */
+    if (in_frames == 0)
+      block_out = out_left;
+    else
+      block_out = MIN (gst_audio_resampler_get_out_frames (resampler,
+              block_in), out_left);
+
+    if (src) {
+      convert->fused_func (convert, src, convert->fused_tmp, block_in);
+      src += block_in * convert->in.bpf;
+      tmp[0] = convert->fused_tmp;
+    }
+    out_block[0] = dst;
+
+    gst_audio_resampler_resample (resampler, src ? tmp : NULL, block_in,
+        out_block, block_out);
+
+    dst += block_out * out_channels;
+    out_left -= block_out;
+  }
+  return TRUE;
+}
+
+/* set up a fused converter for @convert if the formats allow it, this
+ * replaces the complete chain */
+static gboolean
+setup_fused (GstAudioConverter * convert)
+{
+  GstAudioInfo *in = &convert->in;
+  GstAudioInfo *out = &convert->out;
+  GstAudioFormat in_format = in->finfo->format;
+
+  if (!GET_OPT_FUSED (convert))
+    return FALSE;
+
+  if (out->finfo->format != GST_AUDIO_FORMAT_F32 ||
+      (in_format != GST_AUDIO_FORMAT_S16 && in_format != GST_AUDIO_FORMAT_F32))
+    return FALSE;
+
+  if (in->layout != GST_AUDIO_LAYOUT_INTERLEAVED ||
+      out->layout != GST_AUDIO_LAYOUT_INTERLEAVED)
+    return FALSE;
+
+  /* resampling in F32 does not give the same result as the staged chain,
+   * only do that when asked for */
+  if ((in->rate != out->rate ||
+          (convert->flags & GST_AUDIO_CONVERTER_FLAG_VARIABLE_RATE)) &&
+      !GET_OPT_FUSED_RESAMPLE (convert))
+    return FALSE;
+
+  convert->current_format = GST_AUDIO_FORMAT_F32;
+  convert->current_layout = GST_AUDIO_LAYOUT_INTERLEAVED;
+  convert->current_channels = in->channels;
+
+  setup_mix (convert);
+
+  /* F32 with an identity matrix is handled by passthrough or plain
+   * resampling already */
+  if (in_format == GST_AUDIO_FORMAT_F32 && convert->mix_passthrough) {
+    gst_audio_channel_mixer_free (convert->mix);
+    convert->mix = NULL;
+    return FALSE;
+  }
+
+  convert->fused_matrix = g_new (gfloat, in->channels * out->channels);
+  __gst_audio_channel_mixer_get_matrix (convert->mix, convert->fused_matrix);
+
+  if (setup_resample (convert))
+    convert->fused_tmp = g_new (gfloat, FUSED_BLOCK_FRAMES * out->channels);
+
+  if (in_format == GST_AUDIO_FORMAT_S16)
+    convert->fused_func = fused_s16_f32;
+  else
+    convert->fused_func = fused_f32_f32;
+
+  GST_INFO ("fused conversion %s -> %s, resample %d",
+      gst_audio_format_to_string (in_format),
+      gst_audio_format_to_string (out->finfo->format),
+      convert->resampler != NULL);
+
+  convert->convert = converter_fused;
+  convert->in_place = FALSE;
+  convert->passthrough = FALSE;
+
+  return TRUE;
+}
+
 #define GST_AUDIO_FORMAT_IS_ENDIAN_CONVERSION(info1, info2) \
 		( \
 			!(((info1)->flags ^ (info2)->flags) & (~GST_AUDIO_FORMAT_FLAG_UNPACK)) && \
@@ -1380,6 +1598,10 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 
   GST_INFO ("unitsizes: %d -> %d", in_info->bpf, out_info->bpf);
 
+  /* try a single pass conversion first */
+  if (setup_fused (convert))
+    return convert;
+
   /* step 1, unpack */
   prev = chain_unpack (convert);
   /* step 2, optional convert from S32 to F64 for channel mix */
@@ -1496,6 +1718,8 @@ gst_audio_converter_free (GstAudioConverter * convert)
     gst_audio_channel_mixer_free (convert->mix);
   if (convert->resampler)
     gst_audio_resampler_free (convert->resampler);
+  g_free (convert->fused_matrix);
+  g_free (convert->fused_tmp);
   gst_audio_info_init (&convert->in);
   gst_audio_info_init (&convert->out);
 
@@ -117,6 +117,37 @@ typedef struct _GstAudioConverter GstAudioConverter;
  */
 #define GST_AUDIO_CONVERTER_OPT_DITHER_THRESHOLD   "GstAudioConverter.dither-threshold"
 
+/**
+ * GST_AUDIO_CONVERTER_OPT_FUSED:
+ *
+ * #G_TYPE_BOOLEAN, allow the converter to use fused single-pass kernels that
+ * unpack, convert and mix the samples in one go instead of running each step
+ * over the whole input. The output is identical to the staged conversion.
+ *
+ * Fused kernels are only available for some common combinations, such as
+ * native endian S16 or F32 interleaved input to native endian F32
+ * interleaved output. They are not used when resampling unless
+ * #GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE is also set.
+ *
+ * Default is %TRUE.
+ *
+ * Since: 1.28
+ */
+#define GST_AUDIO_CONVERTER_OPT_FUSED   "GstAudioConverter.fused"
+
+/**
+ * GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE:
+ *
+ * #G_TYPE_BOOLEAN, also use the fused kernels when resampling, feeding the
+ * resampler in cache-sized blocks. The resampler then runs in F32 precision,
+ * so the output differs slightly from the staged conversion.
+ *
+ * Default is %FALSE.
+ *
+ * Since: 1.28
+ */
+#define GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE   "GstAudioConverter.fused-resample"
+
 /**
  * GstAudioConverterFlags:
  * @GST_AUDIO_CONVERTER_FLAG_NONE: no flag
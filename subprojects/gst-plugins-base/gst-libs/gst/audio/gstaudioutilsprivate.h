@@ -48,6 +48,11 @@ gboolean __gst_audio_set_thread_priority   (gpointer * handle);
 G_GNUC_INTERNAL
 gboolean __gst_audio_restore_thread_priority (gpointer handle);
 
+/* Channel mixer helpers */
+G_GNUC_INTERNAL
+void     __gst_audio_channel_mixer_get_matrix (GstAudioChannelMixer * mix,
+                                               gfloat * matrix);
+
 G_END_DECLS
 
 #endif
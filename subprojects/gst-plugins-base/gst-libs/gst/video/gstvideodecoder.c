@@ -428,6 +428,11 @@ struct _GstVideoDecoderPrivate
   gdouble proportion;           /* OBJECT_LOCK */
   GstClockTime earliest_time;   /* OBJECT_LOCK */
   GstClockTime qos_frame_duration;      /* OBJECT_LOCK */
+
+  /* Output grid announced by a downstream drop hint event */
+  GstClockTime drop_hint_ts;    /* OBJECT_LOCK */
+  gint drop_hint_fps_n;         /* OBJECT_LOCK */
+  gint drop_hint_fps_d;         /* OBJECT_LOCK */
   gboolean discont;
   /* qos messages: frames dropped/processed */
   guint dropped;
@@ -1106,6 +1111,9 @@ gst_video_decoder_push_event (GstVideoDecoder * decoder, GstEvent * event)
           gst_segment_is_equal (&decoder->input_segment, &segment);
       decoder->priv->last_timestamp_out = GST_CLOCK_TIME_NONE;
       decoder->priv->earliest_time = GST_CLOCK_TIME_NONE;
+      GST_OBJECT_LOCK (decoder);
+      decoder->priv->drop_hint_fps_n = 0;
+      GST_OBJECT_UNLOCK (decoder);
       GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
       break;
     }
@@ -1856,6 +1864,33 @@ gst_video_decoder_src_event_default (GstVideoDecoder * decoder,
       res = gst_pad_push_event (decoder->sinkpad, event);
       break;
     }
+    case GST_EVENT_CUSTOM_UPSTREAM:
+    {
+      GstClockTime timestamp;
+      gint fps_n, fps_d;
+
+      if (!gst_video_event_parse_drop_hint (event, &timestamp, &fps_n, &fps_d)) {
+        res = gst_pad_push_event (decoder->sinkpad, event);
+        break;
+      }
+
+      GST_DEBUG_OBJECT (decoder, "got drop hint %" GST_TIME_FORMAT ", %d/%d",
+          GST_TIME_ARGS (timestamp), fps_n, fps_d);
+
+      GST_OBJECT_LOCK (decoder);
+      if (GST_CLOCK_TIME_IS_VALID (timestamp) && fps_n > 0 && fps_d > 0) {
+        priv->drop_hint_ts = timestamp;
+        priv->drop_hint_fps_n = fps_n;
+        priv->drop_hint_fps_d = fps_d;
+      } else {
+        priv->drop_hint_fps_n = 0;
+      }
+      GST_OBJECT_UNLOCK (decoder);
+
+      gst_event_unref (event);
+      res = TRUE;
+      break;
+    }
     default:
       res = gst_pad_push_event (decoder->sinkpad, event);
       break;
@@ -2340,6 +2375,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     GST_OBJECT_LOCK (decoder);
     priv->earliest_time = GST_CLOCK_TIME_NONE;
     priv->proportion = 0.5;
+    priv->drop_hint_fps_n = 0;
     priv->decode_flags_override = FALSE;
 
     priv->request_sync_point_flags = 0;
@@ -3194,6 +3230,62 @@ gst_video_decoder_release_frame (GstVideoDecoder * dec,
   gst_video_codec_frame_unref (frame);
 }
 
+/* called with STREAM_LOCK. Returns %TRUE if downstream announced with a drop
+ * hint event that it will not use @frame because another frame is closer to
+ * one of its output slots */
+static gboolean
+gst_video_decoder_is_hinted_drop (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = dec->priv;
+  GstClockTime origin, duration, slot_dist, slot, next_slot, dist;
+  gint fps_n, fps_d;
+  guint64 k;
+
+  if (!GST_CLOCK_TIME_IS_VALID (frame->pts) || dec->input_segment.rate < 0.0
+      || gst_video_decoder_get_subframe_mode (dec))
+    return FALSE;
+
+  GST_OBJECT_LOCK (dec);
+  origin = priv->drop_hint_ts;
+  fps_n = priv->drop_hint_fps_n;
+  fps_d = priv->drop_hint_fps_d;
+  GST_OBJECT_UNLOCK (dec);
+
+  if (fps_n == 0 || frame->pts < origin)
+    return FALSE;
+
+  duration = frame->duration;
+  if (!GST_CLOCK_TIME_IS_VALID (duration) && priv->input_state
+      && priv->input_state->info.fps_n > 0 && priv->input_state->info.fps_d > 0)
+    duration = gst_util_uint64_scale (GST_SECOND,
+        priv->input_state->info.fps_d, priv->input_state->info.fps_n);
+  if (!GST_CLOCK_TIME_IS_VALID (duration))
+    duration = gst_video_decoder_get_frame_duration (dec, frame);
+  if (!GST_CLOCK_TIME_IS_VALID (duration) || duration == 0)
+    return FALSE;
+
+  /* Find the distance to the nearest output slot */
+  k = gst_util_uint64_scale (frame->pts - origin, fps_n, fps_d * GST_SECOND);
+  slot = origin + gst_util_uint64_scale (k, fps_d * GST_SECOND, fps_n);
+  next_slot = origin + gst_util_uint64_scale (k + 1, fps_d * GST_SECOND,
+      fps_n);
+  slot_dist = frame->pts - slot;
+  dist = next_slot - frame->pts;
+  dist = MIN (slot_dist, dist);
+
+  /* With regularly spaced input, the closest frame to a slot is never more
+   * than half a frame away from it. Leave some margin for jitter. */
+  if (dist <= duration / 2 + duration / 8)
+    return FALSE;
+
+  GST_LOG_OBJECT (dec, "frame %" GST_TIME_FORMAT " is %" GST_TIME_FORMAT
+      " away from the nearest output slot, dropping",
+      GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (dist));
+
+  return TRUE;
+}
+
 /* called with STREAM_LOCK */
 static void
 gst_video_decoder_post_qos_drop (GstVideoDecoder * dec, GstClockTime timestamp)
@@ -3467,6 +3559,14 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
     goto done;
   }
 
+  if (gst_video_decoder_is_hinted_drop (decoder, frame)) {
+    GST_DEBUG_OBJECT (decoder,
+        "dropping frame %" GST_TIME_FORMAT " because of the downstream drop "
+        "hint", GST_TIME_ARGS (frame->pts));
+    gst_video_decoder_post_qos_drop (decoder, frame->pts);
+    goto done;
+  }
+
   /* Mark output as corrupted if the subclass requested so and we're either
    * still before the sync point after the request, or we don't even know the
    * frame number of the sync point yet (it is 0) */
@@ -3975,6 +4075,19 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
     GST_OBJECT_UNLOCK (decoder);
 
     priv->distance_from_sync++;
+
+    /* Frames that nothing references and that downstream announced it will
+     * drop anyway don't even need to be decoded */
+    if (GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
+            GST_BUFFER_FLAG_DROPPABLE)
+        && gst_video_decoder_is_hinted_drop (decoder, frame)) {
+      GST_DEBUG_OBJECT (decoder, "skipping decoding of droppable frame %"
+          GST_TIME_FORMAT " because of the downstream drop hint",
+          GST_TIME_ARGS (frame->pts));
+      gst_video_decoder_post_qos_drop (decoder, frame->pts);
+      gst_video_decoder_release_frame (decoder, frame);
+      return GST_FLOW_OK;
+    }
   }
 
   frame->distance_from_sync = priv->distance_from_sync;
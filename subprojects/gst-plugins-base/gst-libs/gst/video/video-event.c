@@ -330,3 +330,90 @@ gst_video_event_parse_upstream_force_key_unit (GstEvent * event,
 
   return TRUE;
 }
+
+#define GST_VIDEO_EVENT_DROP_HINT_NAME "GstVideoDropHint"
+
+/**
+ * gst_video_event_new_drop_hint:
+ * @timestamp: the timestamp of the first output frame of the grid
+ * @fps_n: the numerator of the output framerate, or 0 to clear the hint
+ * @fps_d: the denominator of the output framerate
+ *
+ * Creates a new upstream drop hint event. A downstream element that will only
+ * keep the frames closest to the grid defined by @timestamp and the
+ * @fps_n/@fps_d framerate (for example videorate reducing the framerate)
+ * can send this event upstream so that decoders can avoid outputting, and
+ * where possible decoding, frames that would be dropped anyway.
+ *
+ * A drop hint with @fps_n set to 0 clears any previously sent hint. Hints are
+ * also implicitly cleared by flushes and new segments.
+ *
+ * To parse an event created by gst_video_event_new_drop_hint() use
+ * gst_video_event_parse_drop_hint().
+ *
+ * Returns: The new GstEvent
+ *
+ * Since: 1.28
+ */
+GstEvent *
+gst_video_event_new_drop_hint (GstClockTime timestamp, gint fps_n, gint fps_d)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (fps_n >= 0, NULL);
+  g_return_val_if_fail (fps_n == 0 || fps_d > 0, NULL);
+
+  s = gst_structure_new (GST_VIDEO_EVENT_DROP_HINT_NAME,
+      "timestamp", G_TYPE_UINT64, timestamp,
+      "fps-n", G_TYPE_INT, fps_n, "fps-d", G_TYPE_INT, fps_d, NULL);
+
+  return gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM, s);
+}
+
+/**
+ * gst_video_event_parse_drop_hint:
+ * @event: A #GstEvent to parse
+ * @timestamp: (out) (optional): A pointer to the timestamp in the event
+ * @fps_n: (out) (optional): A pointer to the framerate numerator in the event
+ * @fps_d: (out) (optional): A pointer to the framerate denominator in the event
+ *
+ * Get timestamp and framerate from a drop hint event. See
+ * gst_video_event_new_drop_hint() for a full description of the drop hint
+ * event.
+ *
+ * Returns: %TRUE if the event is a valid drop hint event. %FALSE if not
+ *
+ * Since: 1.28
+ */
+gboolean
+gst_video_event_parse_drop_hint (GstEvent * event, GstClockTime * timestamp,
+    gint * fps_n, gint * fps_d)
+{
+  const GstStructure *s;
+  GstClockTime ev_timestamp;
+  gint ev_fps_n, ev_fps_d;
+
+  g_return_val_if_fail (event != NULL, FALSE);
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CUSTOM_UPSTREAM)
+    return FALSE;               /* Not a drop hint event */
+
+  s = gst_event_get_structure (event);
+  if (s == NULL || !gst_structure_has_name (s, GST_VIDEO_EVENT_DROP_HINT_NAME))
+    return FALSE;
+
+  if (!gst_structure_get_clock_time (s, "timestamp", &ev_timestamp))
+    ev_timestamp = GST_CLOCK_TIME_NONE;
+  if (!gst_structure_get_int (s, "fps-n", &ev_fps_n)
+      || !gst_structure_get_int (s, "fps-d", &ev_fps_d))
+    return FALSE;
+
+  if (timestamp)
+    *timestamp = ev_timestamp;
+  if (fps_n)
+    *fps_n = ev_fps_n;
+  if (fps_d)
+    *fps_d = ev_fps_d;
+
+  return TRUE;
+}
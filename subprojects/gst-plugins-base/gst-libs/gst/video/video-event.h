@@ -64,6 +64,19 @@ gboolean gst_video_event_parse_upstream_force_key_unit (GstEvent * event,
 GST_VIDEO_API
 gboolean gst_video_event_is_force_key_unit(GstEvent *event);
 
+/* video drop hint event creation and parsing */
+
+GST_VIDEO_API
+GstEvent * gst_video_event_new_drop_hint   (GstClockTime timestamp,
+                                            gint fps_n,
+                                            gint fps_d);
+
+GST_VIDEO_API
+gboolean   gst_video_event_parse_drop_hint (GstEvent * event,
+                                            GstClockTime * timestamp,
+                                            gint * fps_n,
+                                            gint * fps_d);
+
 G_END_DECLS
 
 #endif /* __GST_VIDEO_EVENT_H__ */
@@ -568,6 +568,8 @@ static gboolean gst_decodebin3_send_event (GstElement * element,
     GstEvent * event);
 
 static void gst_decode_bin_update_factories_list (GstDecodebin3 * dbin);
+static GList *create_decoder_factory_list (GstDecodebin3 * dbin,
+    GstCaps * caps);
 
 static DecodebinCollection *db_collection_new (GstStreamCollection *
     collection);
@@ -1908,12 +1910,7 @@ gst_decodebin_input_requires_parsebin (DecodebinInput * input,
     GList *decoder_list;
     /* If the incoming caps are compatible with a decoder, we don't need to
      * process it before */
-    g_mutex_lock (&dbin->factories_lock);
-    gst_decode_bin_update_factories_list (dbin);
-    decoder_list =
-        gst_element_factory_list_filter (dbin->decoder_factories, newcaps,
-        GST_PAD_SINK, TRUE);
-    g_mutex_unlock (&dbin->factories_lock);
+    decoder_list = create_decoder_factory_list (dbin, newcaps);
     if (decoder_list) {
       GST_FIXME_OBJECT (sinkpad, "parsebin not needed (available decoders) !");
       gst_plugin_feature_list_free (decoder_list);
@@ -2688,6 +2685,7 @@ handle_stream_collection_locked (GstDecodebin3 * dbin,
     GstStreamCollection * collection, DecodebinInput * input)
 {
   GstMessage *message = NULL;
+  GstCaps *raw_caps;
   gboolean is_update = FALSE;
 #ifndef GST_DISABLE_GST_DEBUG
   const gchar *upstream_id;
@@ -2738,6 +2736,23 @@ handle_stream_collection_locked (GstDecodebin3 * dbin,
   }
 #endif
 
+  /* Look up (and load) the decoders for all streams in parallel, so they are
+   * ready by the time the streams reach the outputs */
+  GST_OBJECT_LOCK (dbin);
+  raw_caps = dbin->caps ? gst_caps_ref (dbin->caps) : NULL;
+  GST_OBJECT_UNLOCK (dbin);
+  for (guint idx = 0; idx < gst_stream_collection_get_size (collection);
+      idx++) {
+    GstStream *stream = gst_stream_collection_get_stream (collection, idx);
+    GstCaps *caps = gst_stream_get_caps (stream);
+
+    if (caps && (!raw_caps || !gst_caps_can_intersect (caps, raw_caps)))
+      gst_playback_utils_prefetch_factories (GST_ELEMENT_FACTORY_TYPE_DECODER,
+          GST_RANK_MARGINAL, gst_plugin_feature_rank_compare_func, caps);
+    gst_clear_caps (&caps);
+  }
+  gst_clear_caps (&raw_caps);
+
   SELECTION_LOCK (dbin);
   /* If collection is same as current input collection, leave */
   if (dbin->input_collection) {
@@ -3646,17 +3661,14 @@ gst_decodebin_input_link_to_slot (DecodebinInputStream * input_stream)
   slot->input = input_stream;
 }
 
+/* Same list as filtering dbin->decoder_factories, but shared with all other
+ * decodebin3 instances */
 static GList *
 create_decoder_factory_list (GstDecodebin3 * dbin, GstCaps * caps)
 {
-  GList *res;
-
-  g_mutex_lock (&dbin->factories_lock);
-  gst_decode_bin_update_factories_list (dbin);
-  res = gst_element_factory_list_filter (dbin->decoder_factories,
-      caps, GST_PAD_SINK, TRUE);
-  g_mutex_unlock (&dbin->factories_lock);
-  return res;
+  return gst_playback_utils_factory_list_filter
+      (GST_ELEMENT_FACTORY_TYPE_DECODER, GST_RANK_MARGINAL,
+      gst_plugin_feature_rank_compare_func, caps, TRUE);
 }
 
 static GstPadProbeReturn
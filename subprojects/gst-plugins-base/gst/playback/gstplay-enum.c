@@ -72,6 +72,9 @@ gst_play_flags_get_type (void)
     {C_FLAGS (GST_PLAY_FLAG_FORCE_SW_DECODERS),
           "Force only software-based decoders (no effect for playbin3)",
         "force-sw-decoders"},
+    {C_FLAGS (GST_PLAY_FLAG_PROCESSING),
+          "Process streams as fast as possible instead of rendering them",
+        "processing"},
     {0, NULL, NULL}
   };
   static GType id = 0;
@@ -62,6 +62,10 @@ GType gst_autoplug_select_result_get_type (void);
  *   set.
  * @GST_PLAY_FLAG_FORCE_SW_DECODERS: force to use only software-based
  *   decoders ignoring those with hardware class.
+ * @GST_PLAY_FLAG_PROCESSING: process the streams as fast as possible instead
+ *   of rendering them: sinks don't synchronise against the clock and software
+ *   volume, colour balance, deinterlacing and visualisations are not used.
+ *   Since: 1.28
  *
  * Extra flags to configure the behaviour of the sinks.
  */
@@ -79,6 +83,7 @@ typedef enum {
   GST_PLAY_FLAG_SOFT_COLORBALANCE = (1 << 10),
   GST_PLAY_FLAG_FORCE_FILTERS = (1 << 11),
   GST_PLAY_FLAG_FORCE_SW_DECODERS = (1 << 12),
+  GST_PLAY_FLAG_PROCESSING    = (1 << 13),
 } GstPlayFlags;
 
 #define GST_TYPE_PLAY_FLAGS (gst_play_flags_get_type())
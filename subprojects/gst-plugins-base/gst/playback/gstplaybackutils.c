@@ -198,3 +198,193 @@ gst_playback_utils_stream_in_list (GList * streams, GstStream * stream)
 
   return FALSE;
 }
+
+/* Autoplug decision cache
+ *
+ * Filtering the registry for the factories handling some caps requires
+ * intersecting the caps with the pad templates of every decodable factory.
+ * Applications creating many playback bins for the same handful of formats
+ * redo this for every stream, so the filtered lists are cached process-wide,
+ * keyed by the list parameters and the caps. The whole cache is dropped as
+ * soon as the registry changes. */
+
+#define FACTORY_CACHE_MAX_ENTRIES 256
+
+GST_DEBUG_CATEGORY_STATIC (playback_utils_debug);
+#define GST_CAT_DEFAULT playback_utils_debug
+
+static GMutex factory_cache_lock;
+static guint32 factory_cache_cookie;
+/* list key -> sorted GList of GstElementFactory */
+static GHashTable *factory_lists = NULL;
+/* list key + caps -> filtered GList of GstElementFactory */
+static GHashTable *factory_cache = NULL;
+
+static GThreadPool *prefetch_pool = NULL;
+
+typedef struct
+{
+  GstElementFactoryListType type;
+  GstRank minrank;
+  GCompareFunc sort_func;
+  GstCaps *caps;
+} PrefetchTask;
+
+/* With factory_cache_lock */
+static void
+factory_cache_check_cookie (void)
+{
+  guint32 cookie;
+
+  if (factory_cache == NULL) {
+    GST_DEBUG_CATEGORY_INIT (playback_utils_debug, "playbackutils", 0,
+        "Playback autoplug cache");
+    factory_lists = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) gst_plugin_feature_list_free);
+    factory_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) gst_plugin_feature_list_free);
+  }
+
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+  if (cookie != factory_cache_cookie) {
+    GST_DEBUG ("registry changed, dropping %u cached lookups",
+        g_hash_table_size (factory_cache));
+    g_hash_table_remove_all (factory_lists);
+    g_hash_table_remove_all (factory_cache);
+    factory_cache_cookie = cookie;
+  }
+}
+
+/* gst_playback_utils_factory_list_filter:
+ * @type: a #GstElementFactoryListType
+ * @minrank: Minimum rank
+ * @sort_func: (nullable): function used to sort the factories
+ * @caps: a #GstCaps
+ * @subsetonly: whether to filter on caps subsets or not.
+ *
+ * Equivalent to calling gst_element_factory_list_filter() on the list of
+ * factories of @type with at least @minrank, sorted with @sort_func, for
+ * @caps on their sink pads. Results are cached and shared by all elements.
+ *
+ * Returns: (transfer full): a #GList of #GstElementFactory elements, free with
+ * gst_plugin_feature_list_free().
+ */
+GList *
+gst_playback_utils_factory_list_filter (GstElementFactoryListType type,
+    GstRank minrank, GCompareFunc sort_func, const GstCaps * caps,
+    gboolean subsetonly)
+{
+  gchar *list_key, *key, *caps_str;
+  GList *factories, *res;
+  guint32 cookie;
+
+  list_key = g_strdup_printf ("%" G_GINT64_MODIFIER "x:%d:%p",
+      (guint64) type, minrank, sort_func);
+  caps_str = gst_caps_to_string (caps);
+  key = g_strdup_printf ("%s:%d:%s", list_key, subsetonly, caps_str);
+  g_free (caps_str);
+
+  g_mutex_lock (&factory_cache_lock);
+  factory_cache_check_cookie ();
+  cookie = factory_cache_cookie;
+
+  res = g_hash_table_lookup (factory_cache, key);
+  if (res || g_hash_table_contains (factory_cache, key)) {
+    GST_LOG ("using cached factories for %" GST_PTR_FORMAT, caps);
+    res = gst_plugin_feature_list_copy (res);
+    g_mutex_unlock (&factory_cache_lock);
+    g_free (list_key);
+    g_free (key);
+    return res;
+  }
+
+  factories = g_hash_table_lookup (factory_lists, list_key);
+  if (!factories) {
+    factories = gst_element_factory_list_get_elements (type, minrank);
+    if (sort_func)
+      factories = g_list_sort (factories, sort_func);
+    g_hash_table_insert (factory_lists, g_strdup (list_key), factories);
+  }
+  factories = gst_plugin_feature_list_copy (factories);
+  g_mutex_unlock (&factory_cache_lock);
+
+  /* Filter without the lock so that different caps can be handled in
+   * parallel */
+  res = gst_element_factory_list_filter (factories, caps, GST_PAD_SINK,
+      subsetonly);
+  gst_plugin_feature_list_free (factories);
+
+  g_mutex_lock (&factory_cache_lock);
+  factory_cache_check_cookie ();
+  if (cookie == factory_cache_cookie) {
+    if (g_hash_table_size (factory_cache) >= FACTORY_CACHE_MAX_ENTRIES)
+      g_hash_table_remove_all (factory_cache);
+    g_hash_table_replace (factory_cache, key,
+        gst_plugin_feature_list_copy (res));
+    key = NULL;
+  }
+  g_mutex_unlock (&factory_cache_lock);
+
+  g_free (list_key);
+  g_free (key);
+
+  return res;
+}
+
+static void
+prefetch_task_func (PrefetchTask * task, gpointer user_data)
+{
+  GList *factories;
+
+  factories = gst_playback_utils_factory_list_filter (task->type,
+      task->minrank, task->sort_func, task->caps, TRUE);
+
+  GST_DEBUG ("prefetched %u factories for %" GST_PTR_FORMAT,
+      g_list_length (factories), task->caps);
+
+  /* Make sure the plugin of the best candidate is loaded by the time the
+   * element gets created */
+  if (factories) {
+    GstPluginFeature *feature =
+        gst_plugin_feature_load (GST_PLUGIN_FEATURE (factories->data));
+    if (feature)
+      gst_object_unref (feature);
+  }
+
+  gst_plugin_feature_list_free (factories);
+  gst_caps_unref (task->caps);
+  g_free (task);
+}
+
+/* gst_playback_utils_prefetch_factories:
+ * @type: a #GstElementFactoryListType
+ * @minrank: Minimum rank
+ * @sort_func: (nullable): function used to sort the factories
+ * @caps: a #GstCaps
+ *
+ * Asynchronously fills the cache used by
+ * gst_playback_utils_factory_list_filter() for @caps and loads the plugin of
+ * the best matching factory. This allows handling the streams of a
+ * collection in parallel before their elements are actually needed.
+ */
+void
+gst_playback_utils_prefetch_factories (GstElementFactoryListType type,
+    GstRank minrank, GCompareFunc sort_func, const GstCaps * caps)
+{
+  static gsize init = 0;
+  PrefetchTask *task;
+
+  if (g_once_init_enter (&init)) {
+    prefetch_pool = g_thread_pool_new ((GFunc) prefetch_task_func, NULL,
+        g_get_num_processors (), FALSE, NULL);
+    g_once_init_leave (&init, 1);
+  }
+
+  task = g_new0 (PrefetchTask, 1);
+  task->type = type;
+  task->minrank = minrank;
+  task->sort_func = sort_func;
+  task->caps = gst_caps_copy (caps);
+
+  g_thread_pool_push (prefetch_pool, task, NULL);
+}
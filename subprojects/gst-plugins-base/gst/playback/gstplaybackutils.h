@@ -40,6 +40,19 @@ gint gst_playback_utils_compare_factories_func(gconstpointer p1,
 G_GNUC_INTERNAL
 gboolean gst_playback_utils_stream_in_list(GList *streams, GstStream *stream);
 
+G_GNUC_INTERNAL
+GList * gst_playback_utils_factory_list_filter (GstElementFactoryListType type,
+                                                GstRank minrank,
+                                                GCompareFunc sort_func,
+                                                const GstCaps * caps,
+                                                gboolean subsetonly);
+
+G_GNUC_INTERNAL
+void gst_playback_utils_prefetch_factories (GstElementFactoryListType type,
+                                            GstRank minrank,
+                                            GCompareFunc sort_func,
+                                            const GstCaps * caps);
+
 G_END_DECLS
 
 #endif /* __GST_PLAYBACK_UTILS_H__ */
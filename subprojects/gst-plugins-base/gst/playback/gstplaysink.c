@@ -93,6 +93,8 @@ typedef struct
   gboolean added;
   gboolean activated;
   gboolean raw;
+  gboolean sync_disabled;       /* sync disabled on the sink for processing */
+  gboolean saved_sync;          /* sync value of the sink before that */
 } GstPlayChain;
 
 typedef struct
@@ -1424,6 +1426,36 @@ gst_play_sink_find_property (GstPlaySink * playsink, GstElement * obj,
   return result;
 }
 
+/* in processing mode the sinks consume data as fast as it arrives, restore
+ * the sink's own sync setting when a chain is reused after leaving processing
+ * mode */
+static void
+gst_play_sink_setup_processing_sink (GstPlaySink * playsink,
+    GstPlayChain * chain, GstElement * sink)
+{
+  gboolean processing = (playsink->flags & GST_PLAY_FLAG_PROCESSING) != 0;
+  GstElement *elem;
+
+  if (processing == chain->sync_disabled)
+    return;
+
+  elem = gst_play_sink_find_property_sinks (playsink, sink, "sync",
+      G_TYPE_BOOLEAN);
+  if (elem) {
+    GST_DEBUG_OBJECT (playsink, "%s sync on element %s",
+        processing ? "disabling" : "restoring", GST_ELEMENT_NAME (elem));
+    if (processing) {
+      g_object_get (elem, "sync", &chain->saved_sync, NULL);
+      g_object_set (elem, "sync", FALSE, NULL);
+    } else {
+      g_object_set (elem, "sync", chain->saved_sync, NULL);
+    }
+    chain->sync_disabled = processing;
+  } else {
+    GST_DEBUG_OBJECT (playsink, "no sync property on the sink");
+  }
+}
+
 static void
 do_async_start (GstPlaySink * playsink)
 {
@@ -1755,6 +1787,7 @@ gen_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
   GstPlayVideoChain *chain;
   GstBin *bin;
   GstPad *pad;
+  gboolean soft_balance;
   GstElement *head = NULL, *prev = NULL, *elem = NULL;
 
   chain = g_new0 (GstPlayVideoChain, 1);
@@ -1816,6 +1849,9 @@ gen_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
       gst_play_sink_find_property_sinks (playsink, chain->sink, "ts-offset",
           G_TYPE_INT64));
 
+  gst_play_sink_setup_processing_sink (playsink, GST_PLAY_CHAIN (chain),
+      chain->sink);
+
   /* create a bin to hold objects, as we create them we add them to this bin so
    * that when something goes wrong we only need to unref the bin */
   chain->chain.bin = gst_bin_new ("vbin");
@@ -1938,12 +1974,16 @@ gen_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
   }
   GST_OBJECT_UNLOCK (playsink);
 
+  /* no colorbalance in processing mode. The converters stay, they run in
+   * passthrough when the sink handles the stream as it is and are still
+   * there if the caps change later */
+  soft_balance = (playsink->flags & GST_PLAY_FLAG_SOFT_COLORBALANCE)
+      && !(playsink->flags & GST_PLAY_FLAG_PROCESSING);
+
   if (!(playsink->flags & GST_PLAY_FLAG_NATIVE_VIDEO)
-      || (!playsink->colorbalance_element
-          && (playsink->flags & GST_PLAY_FLAG_SOFT_COLORBALANCE))) {
+      || (!playsink->colorbalance_element && soft_balance)) {
     gboolean use_converters = !(playsink->flags & GST_PLAY_FLAG_NATIVE_VIDEO);
-    gboolean use_balance = !playsink->colorbalance_element
-        && (playsink->flags & GST_PLAY_FLAG_SOFT_COLORBALANCE);
+    gboolean use_balance = !playsink->colorbalance_element && soft_balance;
 
     GST_DEBUG_OBJECT (playsink, "creating videoconverter");
     chain->conv =
@@ -2108,6 +2148,9 @@ setup_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
       gst_play_sink_find_property_sinks (playsink, chain->sink, "ts-offset",
           G_TYPE_INT64));
 
+  gst_play_sink_setup_processing_sink (playsink, GST_PLAY_CHAIN (chain),
+      chain->sink);
+
   /* if we can disable async behaviour of the sink, we can avoid adding a
    * queue for the audio chain. */
   elem =
@@ -2148,7 +2191,8 @@ setup_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
 
   if (chain->conv) {
     gboolean use_balance = !playsink->colorbalance_element
-        && (playsink->flags & GST_PLAY_FLAG_SOFT_COLORBALANCE);
+        && (playsink->flags & GST_PLAY_FLAG_SOFT_COLORBALANCE)
+        && !(playsink->flags & GST_PLAY_FLAG_PROCESSING);
 
     g_object_set (chain->conv, "use-balance", use_balance, NULL);
 
@@ -2695,7 +2739,7 @@ gen_audio_chain (GstPlaySink * playsink, gboolean raw)
 {
   GstPlayAudioChain *chain;
   GstBin *bin;
-  gboolean have_volume;
+  gboolean have_volume, soft_volume;
   GstPad *pad;
   GstElement *head, *prev, *elem = NULL;
 
@@ -2735,6 +2779,9 @@ gen_audio_chain (GstPlaySink * playsink, gboolean raw)
   gst_object_ref_sink (bin);
   gst_bin_add (bin, chain->sink);
 
+  gst_play_sink_setup_processing_sink (playsink, GST_PLAY_CHAIN (chain),
+      chain->sink);
+
   head = chain->sink;
   prev = NULL;
 
@@ -2848,11 +2895,15 @@ gen_audio_chain (GstPlaySink * playsink, gboolean raw)
     chain->sink_volume = FALSE;
   }
 
-  if (!(playsink->flags & GST_PLAY_FLAG_NATIVE_AUDIO) || (!have_volume
-          && (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME))) {
+  /* no software volume in processing mode, the converters stay as for
+   * video */
+  soft_volume = (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME)
+      && !(playsink->flags & GST_PLAY_FLAG_PROCESSING);
+
+  if (!(playsink->flags & GST_PLAY_FLAG_NATIVE_AUDIO)
+      || (!have_volume && soft_volume)) {
     gboolean use_converters = !(playsink->flags & GST_PLAY_FLAG_NATIVE_AUDIO);
-    gboolean use_volume =
-        !have_volume && (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME);
+    gboolean use_volume = !have_volume && soft_volume;
     GST_DEBUG_OBJECT (playsink,
         "creating audioconvert with use-converters %d, use-volume %d",
         use_converters, use_volume);
@@ -2869,7 +2920,7 @@ gen_audio_chain (GstPlaySink * playsink, gboolean raw)
     }
     prev = chain->conv;
 
-    if (!have_volume && (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME)) {
+    if (use_volume) {
       g_object_get (chain->conv, "volume-element", &chain->volume, NULL);
 
       if (chain->volume) {
@@ -3006,6 +3057,9 @@ setup_audio_chain (GstPlaySink * playsink, gboolean raw)
       gst_play_sink_find_property_sinks (playsink, chain->sink, "ts-offset",
           G_TYPE_INT64));
 
+  gst_play_sink_setup_processing_sink (playsink, GST_PLAY_CHAIN (chain),
+      chain->sink);
+
   /* Disconnect signals */
   disconnect_audio_chain (chain, playsink);
   /* Drop any existing volume handler and check again */
@@ -3045,11 +3099,13 @@ setup_audio_chain (GstPlaySink * playsink, gboolean raw)
     g_object_set (chain->conv, "use-volume", FALSE, NULL);
   } else if (chain->conv) {
     /* no volume, we need to add a volume element when we can */
-    g_object_set (chain->conv, "use-volume",
-        !!(playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME), NULL);
+    gboolean use_volume = (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME)
+        && !(playsink->flags & GST_PLAY_FLAG_PROCESSING);
+
+    g_object_set (chain->conv, "use-volume", use_volume, NULL);
     GST_DEBUG_OBJECT (playsink, "the sink has no volume property");
 
-    if (playsink->flags & GST_PLAY_FLAG_SOFT_VOLUME) {
+    if (use_volume) {
       g_object_get (chain->conv, "volume-element", &chain->volume, NULL);
       if (chain->volume) {
         chain->notify_volume_id =
@@ -3260,7 +3316,8 @@ gst_play_sink_do_reconfigure (GstPlaySink * playsink)
     /* we only deinterlace if native video is not requested and
      * we have raw video */
     if ((flags & GST_PLAY_FLAG_DEINTERLACE)
-        && !(flags & GST_PLAY_FLAG_NATIVE_VIDEO) && playsink->video_pad_raw)
+        && !(flags & (GST_PLAY_FLAG_NATIVE_VIDEO | GST_PLAY_FLAG_PROCESSING))
+        && playsink->video_pad_raw)
       need_deinterlace = TRUE;
   }
 
@@ -3270,7 +3327,8 @@ gst_play_sink_do_reconfigure (GstPlaySink * playsink)
     }
     if (playsink->audio_pad_raw) {
       /* only can do vis with raw uncompressed audio */
-      if (flags & GST_PLAY_FLAG_VIS && !need_video) {
+      if (flags & GST_PLAY_FLAG_VIS && !need_video
+          && !(flags & GST_PLAY_FLAG_PROCESSING)) {
         /* also add video when we add visualisation */
         need_video = TRUE;
         need_vis = TRUE;
@@ -3816,6 +3874,10 @@ gst_play_sink_do_reconfigure (GstPlaySink * playsink)
     if (playsink->textchain) {
       GstIterator *it;
 
+      if (playsink->textchain->sink)
+        gst_play_sink_setup_processing_sink (playsink,
+            GST_PLAY_CHAIN (playsink->textchain), playsink->textchain->sink);
+
       GST_DEBUG_OBJECT (playsink, "adding text chain");
       if (playsink->textchain->overlay)
         g_object_set (G_OBJECT (playsink->textchain->overlay), "silent", FALSE,
@@ -0,0 +1,288 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Process-wide cache of idle #GstVideoConverter instances.
+ *
+ * Setting up a converter computes the scaler taps, matrices, gamma tables and
+ * dither state, which takes a few milliseconds for large frames. Pipelines
+ * switching between a handful of resolutions or formats end up rebuilding
+ * the same converters over and over. Instead of freeing them, elements hand
+ * their converter back to this cache, and new converters for the same
+ * input/output #GstVideoInfo and configuration are taken from it.
+ *
+ * A #GstVideoConverter keeps per-frame scratch state and can only be used by
+ * one element at a time, so converters are moved in and out of the cache
+ * instead of being shared. The least recently released converters are freed
+ * once more than CONVERTER_CACHE_SIZE are idle.
+ *
+ * All cached converters run their tasks on one task pool owned by the cache,
+ * so idle converters don't keep threads of their own around. Elements hold a
+ * reference on the cache for their lifetime, the idle converters and the task
+ * pool are freed once the last one is gone.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstvideoconvertercache.h"
+
+GST_DEBUG_CATEGORY_STATIC (video_converter_cache_debug);
+#define GST_CAT_DEFAULT video_converter_cache_debug
+
+#define CONVERTER_CACHE_SIZE 8
+
+typedef struct
+{
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstStructure *config;
+  GstVideoConverter *convert;
+} CacheEntry;
+
+static GMutex cache_lock;
+/* number of gst_video_converter_cache_ref() calls not yet undone */
+static guint cache_users = 0;
+/* task pool shared by all converters created by the cache */
+static GstTaskPool *cache_pool = NULL;
+/* CacheEntry, most recently released first */
+static GQueue idle_entries = G_QUEUE_INIT;
+/* GstVideoConverter -> CacheEntry for converters handed out */
+static GHashTable *used_entries = NULL;
+
+static void
+cache_entry_free (CacheEntry * entry)
+{
+  if (entry->convert)
+    gst_video_converter_free (entry->convert);
+  if (entry->config)
+    gst_structure_free (entry->config);
+  g_free (entry);
+}
+
+static gboolean
+cache_entry_matches (CacheEntry * entry, const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, const GstStructure * config)
+{
+  if (!gst_video_info_is_equal (&entry->in_info, in_info)
+      || !gst_video_info_is_equal (&entry->out_info, out_info))
+    return FALSE;
+
+  if (entry->config == NULL || config == NULL)
+    return entry->config == config;
+
+  return gst_structure_is_equal (entry->config, config);
+}
+
+static void
+cache_init (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    GST_DEBUG_CATEGORY_INIT (video_converter_cache_debug,
+        "videoconvertercache", 0, "Video converter cache");
+    used_entries = g_hash_table_new (NULL, NULL);
+    g_once_init_leave (&init, 1);
+  }
+}
+
+static GstTaskPool *
+cache_get_pool (void)
+{
+  GstTaskPool *pool;
+
+  g_mutex_lock (&cache_lock);
+  if (cache_pool == NULL) {
+    cache_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (cache_pool),
+        g_get_num_processors ());
+    gst_task_pool_prepare (cache_pool, NULL);
+  }
+  pool = gst_object_ref (cache_pool);
+  g_mutex_unlock (&cache_lock);
+
+  return pool;
+}
+
+/*
+ * gst_video_converter_cache_ref:
+ *
+ * Keep the idle converters of the cache alive until the matching
+ * gst_video_converter_cache_unref().
+ */
+void
+gst_video_converter_cache_ref (void)
+{
+  cache_init ();
+
+  g_mutex_lock (&cache_lock);
+  cache_users++;
+  g_mutex_unlock (&cache_lock);
+}
+
+/*
+ * gst_video_converter_cache_unref:
+ *
+ * Undo a gst_video_converter_cache_ref(). The last one frees the idle
+ * converters and the task pool, unless converters are still in use.
+ */
+void
+gst_video_converter_cache_unref (void)
+{
+  GQueue idle = G_QUEUE_INIT;
+  GstTaskPool *pool = NULL;
+
+  g_mutex_lock (&cache_lock);
+  g_assert (cache_users > 0);
+  cache_users--;
+  if (cache_users == 0 && g_hash_table_size (used_entries) == 0) {
+    idle = idle_entries;
+    g_queue_init (&idle_entries);
+    pool = g_steal_pointer (&cache_pool);
+  }
+  g_mutex_unlock (&cache_lock);
+
+  if (idle.length > 0)
+    GST_DEBUG ("freeing %u idle converters", idle.length);
+  g_queue_clear_full (&idle, (GDestroyNotify) cache_entry_free);
+
+  if (pool) {
+    gst_task_pool_cleanup (pool);
+    gst_object_unref (pool);
+  }
+}
+
+/*
+ * gst_video_converter_cache_acquire:
+ * @in_info: a #GstVideoInfo
+ * @out_info: a #GstVideoInfo
+ * @config: (transfer full) (nullable): a #GstStructure with configuration
+ *   options
+ *
+ * Get a #GstVideoConverter converting from @in_info to @out_info with @config,
+ * reusing an idle one from the cache when possible. Use
+ * gst_video_converter_cache_release() to give it back.
+ *
+ * Returns: (nullable): a #GstVideoConverter or %NULL if conversion is not
+ *   possible.
+ */
+GstVideoConverter *
+gst_video_converter_cache_acquire (const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, GstStructure * config)
+{
+  CacheEntry *entry = NULL;
+  GstTaskPool *pool;
+  GList *l;
+
+  cache_init ();
+
+  g_mutex_lock (&cache_lock);
+  for (l = idle_entries.head; l; l = l->next) {
+    CacheEntry *e = l->data;
+
+    if (cache_entry_matches (e, in_info, out_info, config)) {
+      entry = e;
+      g_queue_delete_link (&idle_entries, l);
+      g_hash_table_insert (used_entries, entry->convert, entry);
+      break;
+    }
+  }
+  g_mutex_unlock (&cache_lock);
+
+  if (entry) {
+    GST_DEBUG ("reusing converter %p", entry->convert);
+    if (config)
+      gst_structure_free (config);
+    return entry->convert;
+  }
+
+  entry = g_new0 (CacheEntry, 1);
+  entry->in_info = *in_info;
+  entry->out_info = *out_info;
+  entry->config = config ? gst_structure_copy (config) : NULL;
+  pool = cache_get_pool ();
+  entry->convert =
+      gst_video_converter_new_with_pool (in_info, out_info, config, pool);
+  gst_object_unref (pool);
+  if (entry->convert == NULL) {
+    cache_entry_free (entry);
+    return NULL;
+  }
+
+  GST_DEBUG ("created converter %p", entry->convert);
+
+  g_mutex_lock (&cache_lock);
+  g_hash_table_insert (used_entries, entry->convert, entry);
+  g_mutex_unlock (&cache_lock);
+
+  return entry->convert;
+}
+
+/*
+ * gst_video_converter_cache_release:
+ * @convert: (transfer full): a #GstVideoConverter
+ *
+ * Give back a converter obtained with gst_video_converter_cache_acquire() so
+ * that it can be reused. Converters not created by the cache are freed.
+ */
+void
+gst_video_converter_cache_release (GstVideoConverter * convert)
+{
+  CacheEntry *entry, *evicted = NULL;
+  GstTaskPool *pool = NULL;
+
+  g_return_if_fail (convert != NULL);
+
+  cache_init ();
+
+  g_mutex_lock (&cache_lock);
+  entry = g_hash_table_lookup (used_entries, convert);
+  if (entry) {
+    g_hash_table_remove (used_entries, convert);
+    if (cache_users == 0) {
+      /* nobody left to reuse it */
+      evicted = entry;
+      if (g_hash_table_size (used_entries) == 0)
+        pool = g_steal_pointer (&cache_pool);
+    } else {
+      g_queue_push_head (&idle_entries, entry);
+      if (idle_entries.length > CONVERTER_CACHE_SIZE)
+        evicted = g_queue_pop_tail (&idle_entries);
+    }
+  }
+  g_mutex_unlock (&cache_lock);
+
+  if (entry == NULL) {
+    gst_video_converter_free (convert);
+    return;
+  }
+
+  GST_DEBUG ("released converter %p", convert);
+
+  if (evicted) {
+    GST_DEBUG ("evicting converter %p", evicted->convert);
+    cache_entry_free (evicted);
+  }
+
+  if (pool) {
+    gst_task_pool_cleanup (pool);
+    gst_object_unref (pool);
+  }
+}
@@ -81,6 +81,7 @@
 #include <gst/video/video.h>
 
 #include "gstvideoconvertscale.h"
+#include "gstvideoconvertercache.h"
 
 typedef struct
 {
@@ -444,6 +445,8 @@ gst_video_convert_scale_init (GstVideoConvertScale * self)
 
   priv->converter_config = NULL;
   priv->converter_config_changed = FALSE;
+
+  gst_video_converter_cache_ref ();
 }
 
 static void
@@ -452,7 +455,9 @@ gst_video_convert_scale_finalize (GstVideoConvertScale * self)
   GstVideoConvertScalePrivate *priv = PRIV (self);
 
   if (priv->convert)
-    gst_video_converter_free (priv->convert);
+    gst_video_converter_cache_release (priv->convert);
+
+  gst_video_converter_cache_unref ();
 
   if (priv->converter_config)
     gst_structure_free (priv->converter_config);
@@ -777,8 +782,9 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
   GstVideoInfo tmp_info;
   GstStructure *options;
 
+  /* keep it around, we might switch back to these caps */
   if (priv->convert) {
-    gst_video_converter_free (priv->convert);
+    gst_video_converter_cache_release (priv->convert);
     priv->convert = NULL;
   }
 
@@ -951,7 +957,8 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
         priv->n_threads, NULL);
 
   build_converter:
-    priv->convert = gst_video_converter_new (in_info, out_info, options);
+    priv->convert =
+        gst_video_converter_cache_acquire (in_info, out_info, options);
     if (priv->convert == NULL)
       goto no_convert;
   }
@@ -1848,9 +1855,10 @@ gst_video_convert_scale_transform_frame (GstVideoFilter * filter,
         gst_video_convert_scale_get_converter_config (GST_VIDEO_CONVERT_SCALE
         (filter), &filter->out_info);
 
-    gst_video_converter_free (priv->convert);
+    gst_video_converter_cache_release (priv->convert);
     priv->convert =
-        gst_video_converter_new (&filter->in_info, &filter->out_info, options);
+        gst_video_converter_cache_acquire (&filter->in_info, &filter->out_info,
+        options);
 
     priv->converter_config_changed = FALSE;
   }
@@ -102,6 +102,7 @@ enum
 #define DEFAULT_MAX_DUPLICATION_TIME      0
 #define DEFAULT_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION   GST_SECOND
 #define DEFAULT_DROP_OUT_OF_SEGMENT       FALSE
+#define DEFAULT_DROP_HINT       FALSE
 
 enum
 {
@@ -119,7 +120,8 @@ enum
   PROP_RATE,
   PROP_MAX_DUPLICATION_TIME,
   PROP_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION,
-  PROP_DROP_OUT_OF_SEGMENT
+  PROP_DROP_OUT_OF_SEGMENT,
+  PROP_DROP_HINT
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -333,6 +335,24 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           DEFAULT_DROP_OUT_OF_SEGMENT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:drop-hint:
+   *
+   * When reducing the framerate, send drop hint events (see
+   * gst_video_event_new_drop_hint()) upstream describing the output frame
+   * grid. Upstream video decoders then skip outputting, and if possible
+   * decoding, frames that videorate would drop anyway.
+   *
+   * This must not be enabled if upstream frames are also consumed by other
+   * branches, e.g. behind a tee, as those would lose frames too.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (object_class, PROP_DROP_HINT,
+      g_param_spec_boolean ("drop-hint", "Drop hint",
+          "Tell upstream which frames will be dropped when reducing the framerate",
+          DEFAULT_DROP_HINT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -664,6 +684,9 @@ gst_video_rate_reset (GstVideoRate * videorate, gboolean on_flush)
     gst_clear_caps (&videorate->in_caps);
   }
   gst_video_rate_swap_prev (videorate, NULL, 0);
+  videorate->drop_hint_ts = GST_CLOCK_TIME_NONE;
+  videorate->drop_hint_fps_n = 0;
+  videorate->drop_hint_fps_d = 1;
 
   gst_segment_init (&videorate->segment, GST_FORMAT_TIME);
 }
@@ -676,6 +699,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->new_pref = DEFAULT_NEW_PREF;
   videorate->drop_only = DEFAULT_DROP_ONLY;
   videorate->drop_out_of_segment = DEFAULT_DROP_OUT_OF_SEGMENT;
+  videorate->drop_hint = DEFAULT_DROP_HINT;
   videorate->average_period = DEFAULT_AVERAGE_PERIOD;
   videorate->average_period_set = DEFAULT_AVERAGE_PERIOD;
   videorate->max_rate = DEFAULT_MAX_RATE;
@@ -1077,6 +1101,9 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
       gst_segment_copy_into (&segment, &videorate->segment);
       GST_DEBUG_OBJECT (videorate, "updated segment: %" GST_SEGMENT_FORMAT,
           &videorate->segment);
+
+      /* upstream forgets the drop hint on new segments */
+      videorate->drop_hint_fps_n = 0;
       seqnum = gst_event_get_seqnum (event);
       gst_event_unref (event);
       event = gst_event_new_segment (&segment);
@@ -1697,6 +1724,52 @@ done:
   return ret;
 }
 
+/* Tell upstream about the output frame grid so that frames we would drop
+ * anyway don't need to be produced. Only done in the plain framerate
+ * reduction mode where the selection is a pure function of the grid */
+static void
+gst_video_rate_update_drop_hint (GstVideoRate * videorate)
+{
+  GstClockTime ts = GST_CLOCK_TIME_NONE;
+  gint fps_n = 0, fps_d = 1;
+  gboolean drop_hint;
+  GstEvent *event;
+
+  GST_OBJECT_LOCK (videorate);
+  drop_hint = videorate->drop_hint;
+  GST_OBJECT_UNLOCK (videorate);
+
+  if (drop_hint && videorate->to_rate_numerator > 0
+      && (videorate->from_rate_numerator == 0
+          || (guint64) videorate->from_rate_numerator *
+          videorate->to_rate_denominator >
+          (guint64) videorate->to_rate_numerator *
+          videorate->from_rate_denominator)
+      && !videorate->drop_only && videorate->average_period == 0
+      && videorate->rate == 1.0 && videorate->segment.rate > 0.0
+      && videorate->max_duplication_time == 0
+      && GST_CLOCK_TIME_IS_VALID (videorate->next_ts)) {
+    ts = videorate->base_ts;
+    fps_n = videorate->to_rate_numerator;
+    fps_d = videorate->to_rate_denominator;
+  }
+
+  if (fps_n == videorate->drop_hint_fps_n && (fps_n == 0
+          || (ts == videorate->drop_hint_ts
+              && fps_d == videorate->drop_hint_fps_d)))
+    return;
+
+  videorate->drop_hint_ts = ts;
+  videorate->drop_hint_fps_n = fps_n;
+  videorate->drop_hint_fps_d = fps_d;
+
+  GST_DEBUG_OBJECT (videorate, "sending drop hint %" GST_TIME_FORMAT ", %d/%d",
+      GST_TIME_ARGS (ts), fps_n, fps_d);
+
+  event = gst_video_event_new_drop_hint (ts, fps_n, fps_d);
+  gst_pad_push_event (GST_BASE_TRANSFORM_SINK_PAD (videorate), event);
+}
+
 static GstFlowReturn
 gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
 {
@@ -1998,6 +2071,8 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
     gst_video_rate_swap_prev (videorate, buffer, in_ts);
   }
 done:
+  gst_video_rate_update_drop_hint (videorate);
+
   return res;
 
   /* ERRORS */
@@ -2089,6 +2164,9 @@ gst_video_rate_set_property (GObject * object,
       videorate->drop_out_of_segment = g_value_get_boolean (value);
       break;
     }
+    case PROP_DROP_HINT:
+      videorate->drop_hint = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2158,6 +2236,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_DROP_OUT_OF_SEGMENT:
       g_value_set_boolean (value, videorate->drop_out_of_segment);
       break;
+    case PROP_DROP_HINT:
+      g_value_set_boolean (value, videorate->drop_hint);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -71,6 +71,11 @@ struct _GstVideoRate
   gboolean drop_only;
   gboolean drop_out_of_segment;
   guint64 average_period_set;
+  gboolean drop_hint;
+
+  /* Last drop hint sent upstream, drop_hint_fps_n == 0 if none */
+  GstClockTime drop_hint_ts;
+  gint drop_hint_fps_n, drop_hint_fps_d;
 
   int max_rate;
   gdouble rate;
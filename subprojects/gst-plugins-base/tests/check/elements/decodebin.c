@@ -19,6 +19,10 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* FIXME: suppress warnings for deprecated API such as GValueArray
+ * with newer GLib versions (>= 2.31.0) */
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
 #ifdef HAVE_CONFIG_H
 # include <config.h>
 #endif
@@ -708,6 +712,190 @@ GST_START_TEST (test_buffering_aggregation)
 
 GST_END_TEST;
 
+/* Fake decoder for the autoplug cache tests, only its pad templates are
+ * used */
+static GType gst_fake_cache_decoder_get_type (void);
+
+#undef parent_class
+#define parent_class fake_cache_decoder_parent_class
+typedef struct _GstFakeCacheDecoder GstFakeCacheDecoder;
+typedef GstElementClass GstFakeCacheDecoderClass;
+
+struct _GstFakeCacheDecoder
+{
+  GstElement parent;
+};
+
+G_DEFINE_TYPE (GstFakeCacheDecoder, gst_fake_cache_decoder, GST_TYPE_ELEMENT);
+
+static void
+gst_fake_cache_decoder_class_init (GstFakeCacheDecoderClass * klass)
+{
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-cache-test"));
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-raw"));
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_add_static_pad_template (element_class, &src_templ);
+  gst_element_class_set_metadata (element_class,
+      "FakeCacheDecoder", "Codec/Decoder/Video", "yep", "me");
+}
+
+static void
+gst_fake_cache_decoder_init (GstFakeCacheDecoder * self)
+{
+}
+
+static GValueArray *
+parsebin_autoplug_factories (GstElement * parsebin, GstCaps * caps)
+{
+  GValueArray *factories = NULL;
+  GstPad *pad;
+
+  pad = gst_element_get_static_pad (parsebin, "sink");
+  g_signal_emit_by_name (parsebin, "autoplug-factories", pad, caps,
+      &factories);
+  gst_object_unref (pad);
+  fail_unless (factories != NULL);
+
+  return factories;
+}
+
+/* The factory lookups are cached process-wide, make sure factories that get
+ * registered later are still found */
+GST_START_TEST (test_factory_cache_registry_change)
+{
+  GstElement *parsebin;
+  GValueArray *factories;
+  GstCaps *caps;
+
+  parsebin = gst_element_factory_make ("parsebin", NULL);
+  fail_unless (parsebin != NULL);
+  caps = gst_caps_new_empty_simple ("video/x-cache-test");
+
+  factories = parsebin_autoplug_factories (parsebin, caps);
+  fail_unless_equals_int (factories->n_values, 0);
+  g_value_array_free (factories);
+
+  /* cached, still nothing */
+  factories = parsebin_autoplug_factories (parsebin, caps);
+  fail_unless_equals_int (factories->n_values, 0);
+  g_value_array_free (factories);
+
+  fail_unless (gst_element_register (NULL, "fakecachedec", GST_RANK_PRIMARY,
+          gst_fake_cache_decoder_get_type ()));
+
+  factories = parsebin_autoplug_factories (parsebin, caps);
+  fail_unless_equals_int (factories->n_values, 1);
+  fail_unless_equals_string (gst_plugin_feature_get_name
+      (g_value_get_object (g_value_array_get_nth (factories, 0))),
+      "fakecachedec");
+  g_value_array_free (factories);
+
+  /* and the new result is cached as well */
+  factories = parsebin_autoplug_factories (parsebin, caps);
+  fail_unless_equals_int (factories->n_values, 1);
+  g_value_array_free (factories);
+
+  gst_caps_unref (caps);
+  gst_object_unref (parsebin);
+}
+
+GST_END_TEST;
+
+#ifndef GST_DISABLE_GST_DEBUG
+static GMutex prefetch_lock;
+static GCond prefetch_cond;
+static gboolean prefetched;
+
+static void
+prefetch_log_func (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer unused)
+{
+  const gchar *msg;
+
+  if (g_strcmp0 (gst_debug_category_get_name (category), "playbackutils"))
+    return;
+
+  msg = gst_debug_message_get (message);
+  if (g_str_has_prefix (msg, "prefetched 1 factories for video/x-cache-test")) {
+    g_mutex_lock (&prefetch_lock);
+    prefetched = TRUE;
+    g_cond_broadcast (&prefetch_cond);
+    g_mutex_unlock (&prefetch_lock);
+  }
+}
+
+/* decodebin3 looks up the decoders of all streams of a new collection in the
+ * background */
+GST_START_TEST (test_decoder_prefetch)
+{
+  GstElement *decodebin;
+  GstStreamCollection *collection;
+  GstStream *stream;
+  GstCaps *caps;
+  GstPad *srcpad, *sinkpad;
+  gint64 end_time;
+  gboolean prev_active;
+
+  prev_active = gst_debug_is_active ();
+  gst_debug_set_active (TRUE);
+  gst_debug_set_threshold_for_name ("playbackutils", GST_LEVEL_DEBUG);
+  gst_debug_add_log_function (prefetch_log_func, NULL, NULL);
+
+  fail_unless (gst_element_register (NULL, "fakecachedec", GST_RANK_PRIMARY,
+          gst_fake_cache_decoder_get_type ()));
+
+  decodebin = gst_element_factory_make ("decodebin3", NULL);
+  fail_unless (decodebin != NULL);
+  fail_unless (gst_element_set_state (decodebin, GST_STATE_PAUSED) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  sinkpad = gst_element_get_static_pad (decodebin, "sink");
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_pad_set_active (srcpad, TRUE);
+
+  caps = gst_caps_new_empty_simple ("video/x-cache-test");
+  stream = gst_stream_new ("video", caps, GST_STREAM_TYPE_VIDEO, 0);
+  collection = gst_stream_collection_new ("upstream");
+  gst_stream_collection_add_stream (collection, stream);
+
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("video")));
+  gst_pad_push_event (srcpad, gst_event_new_stream_collection (collection));
+
+  g_mutex_lock (&prefetch_lock);
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  while (!prefetched) {
+    if (!g_cond_wait_until (&prefetch_cond, &prefetch_lock, end_time))
+      break;
+  }
+  fail_unless (prefetched);
+  g_mutex_unlock (&prefetch_lock);
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_element_set_state (decodebin, GST_STATE_NULL);
+  gst_pad_unlink (srcpad, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (decodebin);
+  gst_object_unref (collection);
+  gst_caps_unref (caps);
+
+  gst_debug_remove_log_function (prefetch_log_func);
+  gst_debug_unset_threshold_for_name ("playbackutils");
+  gst_debug_set_active (prev_active);
+}
+
+GST_END_TEST;
+#endif /* !GST_DISABLE_GST_DEBUG */
+
 static Suite *
 decodebin_suite (void)
 {
@@ -720,6 +908,10 @@ decodebin_suite (void)
   tcase_add_test (tc_chain, test_mp3_parser_loop);
   tcase_add_test (tc_chain, test_parser_negotiation);
   tcase_add_test (tc_chain, test_buffering_aggregation);
+  tcase_add_test (tc_chain, test_factory_cache_registry_change);
+#ifndef GST_DISABLE_GST_DEBUG
+  tcase_add_test (tc_chain, test_decoder_prefetch);
+#endif
 
   return s;
 }
@@ -72,6 +72,213 @@ GST_START_TEST (test_volume_in_sink)
 GST_END_TEST;
 
 
+static gboolean
+bin_has_element_from_factory (GstElement * bin, const gchar * name)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  gboolean found = FALSE;
+
+  it = gst_bin_iterate_recurse (GST_BIN (bin));
+  while (!found && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElementFactory *factory =
+        gst_element_get_factory (g_value_get_object (&item));
+
+    if (factory && g_str_equal (GST_OBJECT_NAME (factory), name))
+      found = TRUE;
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return found;
+}
+
+static void
+run_until_eos (GstElement * pipe)
+{
+  GstMessage *msg;
+
+  fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+}
+
+/* processing mode disables sync and software volume, and both come back when
+ * the chain is reused without it */
+GST_START_TEST (test_processing_flag)
+{
+  GstElement *pipe, *playsink, *fakesink, *src;
+  gboolean sync;
+
+  pipe = gst_pipeline_new (NULL);
+  playsink = gst_element_factory_make ("playsink", NULL);
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (playsink, "audio-sink", fakesink, NULL);
+  gst_util_set_object_arg (G_OBJECT (playsink), "flags",
+      "audio+soft-volume+processing");
+
+  src = gst_element_factory_make ("audiotestsrc", NULL);
+  g_object_set (src, "num-buffers", 5, NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), src, playsink, NULL);
+  fail_unless (gst_element_link (src, playsink));
+
+  run_until_eos (pipe);
+  g_object_get (fakesink, "sync", &sync, NULL);
+  fail_if (sync);
+  fail_if (bin_has_element_from_factory (playsink, "volume"));
+
+  /* the audio chain is reused when restarting from READY */
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_util_set_object_arg (G_OBJECT (playsink), "flags", "audio+soft-volume");
+
+  run_until_eos (pipe);
+  g_object_get (fakesink, "sync", &sync, NULL);
+  fail_unless (sync);
+  fail_unless (bin_has_element_from_factory (playsink, "volume"));
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+/* leaving processing mode must not turn on sync on a sink that the
+ * application configured without it */
+GST_START_TEST (test_processing_keeps_sync)
+{
+  GstElement *pipe, *playsink, *fakesink, *src;
+  gboolean sync;
+
+  pipe = gst_pipeline_new (NULL);
+  playsink = gst_element_factory_make ("playsink", NULL);
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (fakesink, "sync", FALSE, NULL);
+  g_object_set (playsink, "audio-sink", fakesink, NULL);
+  gst_util_set_object_arg (G_OBJECT (playsink), "flags", "audio+processing");
+
+  src = gst_element_factory_make ("audiotestsrc", NULL);
+  g_object_set (src, "num-buffers", 5, NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), src, playsink, NULL);
+  fail_unless (gst_element_link (src, playsink));
+
+  run_until_eos (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_util_set_object_arg (G_OBJECT (playsink), "flags", "audio");
+
+  run_until_eos (pipe);
+  g_object_get (fakesink, "sync", &sync, NULL);
+  fail_if (sync);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static void
+push_audio_buffers (GstElement * src, const gchar * format, gint rate,
+    guint n_buffers, GstClockTime * ts)
+{
+  GstCaps *caps;
+  GstFlowReturn ret;
+  gint bps = g_str_equal (format, "S16LE") ? 2 : 4;
+  guint i;
+
+  caps = gst_caps_new_simple ("audio/x-raw", "format", G_TYPE_STRING, format,
+      "layout", G_TYPE_STRING, "interleaved", "rate", G_TYPE_INT, rate,
+      "channels", G_TYPE_INT, 1, NULL);
+  g_object_set (src, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buf;
+
+    /* 10ms of silence */
+    buf = gst_buffer_new_allocate (NULL, rate / 100 * bps, NULL);
+    gst_buffer_memset (buf, 0, 0, gst_buffer_get_size (buf));
+    GST_BUFFER_PTS (buf) = *ts;
+    GST_BUFFER_DURATION (buf) = 10 * GST_MSECOND;
+    *ts += 10 * GST_MSECOND;
+
+    g_signal_emit_by_name (src, "push-buffer", buf, &ret);
+    gst_buffer_unref (buf);
+    fail_unless_equals_int (ret, GST_FLOW_OK);
+  }
+}
+
+static void
+handoff_cb (GstElement * sink, GstBuffer * buf, GstPad * pad, guint * count)
+{
+  g_atomic_int_inc (count);
+}
+
+/* when the sink accepts the initial caps as they are, the stream must still
+ * be converted once the caps change to something it does not accept */
+GST_START_TEST (test_processing_renegotiation)
+{
+  GstElement *pipe, *playsink, *audiosink, *capsfilter, *fakesink, *src;
+  GstCaps *caps;
+  GstPad *sinkpad;
+  GstClockTime ts = 0;
+  GstFlowReturn ret;
+  guint count = 0;
+
+  pipe = gst_pipeline_new (NULL);
+  playsink = gst_element_factory_make ("playsink", NULL);
+
+  audiosink = gst_bin_new ("audiosink");
+  capsfilter = gst_element_factory_make ("capsfilter", NULL);
+  caps = gst_caps_from_string ("audio/x-raw,format=S16LE,rate=44100,"
+      "channels=1,layout=interleaved");
+  g_object_set (capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+  fakesink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (fakesink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (fakesink, "handoff", G_CALLBACK (handoff_cb), &count);
+  gst_bin_add_many (GST_BIN (audiosink), capsfilter, fakesink, NULL);
+  gst_element_link (capsfilter, fakesink);
+  sinkpad = gst_element_get_static_pad (capsfilter, "sink");
+  gst_element_add_pad (audiosink, gst_ghost_pad_new ("sink", sinkpad));
+  gst_object_unref (sinkpad);
+
+  g_object_set (playsink, "audio-sink", audiosink, NULL);
+  gst_util_set_object_arg (G_OBJECT (playsink), "flags", "audio+processing");
+
+  src = gst_element_factory_make ("appsrc", NULL);
+  g_object_set (src, "format", GST_FORMAT_TIME, NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), src, playsink, NULL);
+  fail_unless (gst_element_link (src, playsink));
+
+  fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  push_audio_buffers (src, "S16LE", 44100, 3, &ts);
+  push_audio_buffers (src, "F32LE", 48000, 3, &ts);
+  g_signal_emit_by_name (src, "end-of-stream", &ret);
+
+  run_until_eos (pipe);
+  fail_unless_equals_int (g_atomic_int_get (&count), 6);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+
 static Suite *
 playsink_suite (void)
 {
@@ -81,6 +288,9 @@ playsink_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_volume_in_sink);
+  tcase_add_test (tc_chain, test_processing_flag);
+  tcase_add_test (tc_chain, test_processing_keeps_sync);
+  tcase_add_test (tc_chain, test_processing_renegotiation);
 
   return s;
 }
@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -2162,6 +2163,71 @@ GST_START_TEST (test_segment_update)
 
 GST_END_TEST;
 
+static GList *upstream_events = NULL;
+
+static gboolean
+upstream_event_func (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  if (gst_video_event_parse_drop_hint (event, NULL, NULL, NULL))
+    upstream_events = g_list_append (upstream_events, event);
+  else
+    gst_event_unref (event);
+  return TRUE;
+}
+
+GST_START_TEST (test_drop_hint)
+{
+  GstElement *videorate;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstClockTime timestamp;
+  gint fps_n, fps_d;
+  guint i;
+
+  videorate = setup_videorate_full (&srctemplate, &downstreamsinktemplate);
+  gst_pad_set_event_function (mysrcpad, upstream_event_func);
+  g_object_set (videorate, "drop-hint", TRUE, NULL);
+  ASSERT_SET_STATE (videorate, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_from_string ("video/x-raw, width = (int) 320, "
+      "height = (int) 240, framerate = (fraction) 50/1, "
+      "format = (string) I420");
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < 4; i++) {
+    buf = gst_buffer_new_and_alloc (4);
+    GST_BUFFER_PTS (buf) = i * GST_SECOND / 50;
+    fail_unless (gst_pad_push (mysrcpad, buf) == GST_FLOW_OK);
+  }
+
+  /* the grid is only sent once */
+  fail_unless_equals_int (g_list_length (upstream_events), 1);
+  fail_unless (gst_video_event_parse_drop_hint (upstream_events->data,
+          &timestamp, &fps_n, &fps_d));
+  fail_unless_equals_uint64 (timestamp, 0);
+  fail_unless_equals_int (fps_n, 25);
+  fail_unless_equals_int (fps_d, 1);
+
+  /* disabling the hint clears it upstream */
+  g_object_set (videorate, "drop-hint", FALSE, NULL);
+  buf = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_PTS (buf) = 4 * GST_SECOND / 50;
+  fail_unless (gst_pad_push (mysrcpad, buf) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (upstream_events), 2);
+  fail_unless (gst_video_event_parse_drop_hint (upstream_events->next->data,
+          NULL, &fps_n, NULL));
+  fail_unless_equals_int (fps_n, 0);
+
+  g_list_free_full (upstream_events, (GDestroyNotify) gst_event_unref);
+  upstream_events = NULL;
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -2193,6 +2259,7 @@ videorate_suite (void)
   tcase_add_test (tc_chain, test_segment_update_same);
   tcase_add_test (tc_chain, test_segment_update_average_period);
   tcase_add_test (tc_chain, test_segment_update);
+  tcase_add_test (tc_chain, test_drop_hint);
 
   return s;
 }
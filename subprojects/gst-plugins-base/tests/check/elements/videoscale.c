@@ -26,6 +26,7 @@
 
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
+#include <stdio.h>
 #include <string.h>
 
 /* kids, don't do this at home, skipping checks is *BAD* */
@@ -1010,6 +1011,121 @@ GST_START_TEST (test_transform_meta)
 
 GST_END_TEST;
 
+static GstBuffer *
+push_and_pull_gray8 (GstHarness * h, guint size)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint i;
+
+  buffer = gst_buffer_new_allocate (NULL, size * size, NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i * 7;
+  gst_buffer_unmap (buffer, &map);
+
+  fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  return gst_harness_pull (h);
+}
+
+GST_START_TEST (test_switch_back_resolution)
+{
+  GstHarness *h;
+  GstBuffer *first, *second, *third;
+  GstMapInfo map;
+
+  h = gst_harness_new ("videoscale");
+  g_object_set (h->element, "method", 3, NULL);
+
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=GRAY8,width=8,"
+      "height=8,pixel-aspect-ratio=1/1,framerate=0/1");
+
+  /* switching back to previous caps reuses the previous converter, which
+   * must produce the same result as a freshly created one */
+  gst_harness_set_src_caps_str (h, "video/x-raw,format=GRAY8,width=16,"
+      "height=16,pixel-aspect-ratio=1/1,framerate=0/1");
+  first = push_and_pull_gray8 (h, 16);
+
+  gst_harness_set_src_caps_str (h, "video/x-raw,format=GRAY8,width=32,"
+      "height=32,pixel-aspect-ratio=1/1,framerate=0/1");
+  second = push_and_pull_gray8 (h, 32);
+
+  gst_harness_set_src_caps_str (h, "video/x-raw,format=GRAY8,width=16,"
+      "height=16,pixel-aspect-ratio=1/1,framerate=0/1");
+  third = push_and_pull_gray8 (h, 16);
+
+  fail_unless_equals_int (gst_buffer_get_size (first), 64);
+  fail_unless_equals_int (gst_buffer_get_size (second), 64);
+  fail_unless (gst_buffer_map (first, &map, GST_MAP_READ));
+  fail_unless (gst_buffer_memcmp (third, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (first, &map);
+
+  gst_buffer_unref (first);
+  gst_buffer_unref (second);
+  gst_buffer_unref (third);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* the cache is internal to the plugin, test our own copy of it */
+#undef GST_CAT_DEFAULT
+#include "../../../gst/videoconvertscale/gstvideoconvertercache.c"
+#undef GST_CAT_DEFAULT
+
+static GstStructure *
+cache_test_config (void)
+{
+  return gst_structure_new ("GstVideoConverter",
+      GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_VIDEO_RESAMPLER_METHOD,
+      GST_VIDEO_RESAMPLER_METHOD_CUBIC, NULL);
+}
+
+GST_START_TEST (test_converter_cache)
+{
+  GstVideoInfo small, large, out;
+  GstVideoConverter *a, *b, *c;
+
+  gst_video_info_set_format (&small, GST_VIDEO_FORMAT_GRAY8, 16, 16);
+  gst_video_info_set_format (&large, GST_VIDEO_FORMAT_GRAY8, 32, 32);
+  gst_video_info_set_format (&out, GST_VIDEO_FORMAT_GRAY8, 8, 8);
+
+  gst_video_converter_cache_ref ();
+
+  a = gst_video_converter_cache_acquire (&small, &out, cache_test_config ());
+  fail_unless (a != NULL);
+  gst_video_converter_cache_release (a);
+
+  /* different input, different converter */
+  b = gst_video_converter_cache_acquire (&large, &out, cache_test_config ());
+  fail_unless (b != NULL);
+  fail_unless (b != a);
+
+  /* same input and configuration again, the idle converter is handed out
+   * instead of a new one */
+  c = gst_video_converter_cache_acquire (&small, &out, cache_test_config ());
+  fail_unless (c == a);
+  fail_unless_equals_int (idle_entries.length, 0);
+
+  /* but not with a different configuration */
+  gst_video_converter_cache_release (c);
+  c = gst_video_converter_cache_acquire (&small, &out, NULL);
+  fail_unless (c != a);
+  fail_unless_equals_int (idle_entries.length, 1);
+
+  gst_video_converter_cache_release (b);
+  gst_video_converter_cache_release (c);
+  fail_unless_equals_int (idle_entries.length, 3);
+  fail_unless (cache_pool != NULL);
+
+  /* the last user frees the idle converters and their threads */
+  gst_video_converter_cache_unref ();
+  fail_unless_equals_int (idle_entries.length, 0);
+  fail_unless (cache_pool == NULL);
+}
+
+GST_END_TEST;
+
 #endif /* !defined(VSCALE_TEST_GROUP) */
 
 static Suite *
@@ -1033,6 +1149,8 @@ videoscale_suite (void)
 #endif
   tcase_add_test (tc_chain, test_basetransform_negotiation);
   tcase_add_test (tc_chain, test_transform_meta);
+  tcase_add_test (tc_chain, test_switch_back_resolution);
+  tcase_add_test (tc_chain, test_converter_cache);
 #else
 #if VSCALE_TEST_GROUP == 1
   tcase_add_test (tc_chain, test_downscale_640x480_320x240_method_0);
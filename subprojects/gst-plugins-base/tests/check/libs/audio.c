@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -1678,6 +1679,166 @@ GST_START_TEST (test_audio_meta_serialize_65_chans)
 
 GST_END_TEST;
 
+static void
+convert_fused_and_staged (GstAudioInfo * in_info, GstAudioInfo * out_info,
+    gconstpointer in, gsize in_frames, gfloat ** fused, gfloat ** staged,
+    gsize * out_frames)
+{
+  GstAudioConverter *conv_fused, *conv_staged;
+  gpointer in_ptr[1], out_ptr[1];
+
+  conv_fused = gst_audio_converter_new (0, in_info, out_info,
+      gst_structure_new ("options", GST_AUDIO_CONVERTER_OPT_FUSED,
+          G_TYPE_BOOLEAN, TRUE, GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE,
+          G_TYPE_BOOLEAN, TRUE, NULL));
+  conv_staged = gst_audio_converter_new (0, in_info, out_info,
+      gst_structure_new ("options", GST_AUDIO_CONVERTER_OPT_FUSED,
+          G_TYPE_BOOLEAN, FALSE, NULL));
+  fail_unless (conv_fused != NULL);
+  fail_unless (conv_staged != NULL);
+
+  *out_frames = gst_audio_converter_get_out_frames (conv_fused, in_frames);
+  fail_unless_equals_int (*out_frames,
+      gst_audio_converter_get_out_frames (conv_staged, in_frames));
+
+  *fused = g_new0 (gfloat, *out_frames * out_info->channels);
+  *staged = g_new0 (gfloat, *out_frames * out_info->channels);
+
+  in_ptr[0] = (gpointer) in;
+  out_ptr[0] = *fused;
+  fail_unless (gst_audio_converter_samples (conv_fused, 0, in_ptr, in_frames,
+          out_ptr, *out_frames));
+  out_ptr[0] = *staged;
+  fail_unless (gst_audio_converter_samples (conv_staged, 0, in_ptr, in_frames,
+          out_ptr, *out_frames));
+
+  gst_audio_converter_free (conv_fused);
+  gst_audio_converter_free (conv_staged);
+}
+
+GST_START_TEST (test_audio_converter_fused)
+{
+  GstAudioInfo in_info, out_info;
+  GstAudioChannelPosition pos_51[6] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_LFE1,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT
+  };
+  gint16 in_s16[6 * 1000];
+  gfloat in_f32[6 * 1000];
+  gfloat *fused, *staged;
+  gsize i, out_frames;
+
+  for (i = 0; i < G_N_ELEMENTS (in_s16); i++) {
+    in_s16[i] = g_random_int_range (G_MININT16, G_MAXINT16 + 1);
+    in_f32[i] = in_s16[i] / 32768.0f;
+  }
+
+  /* stereo S16 to mono F32, must be identical to the staged conversion */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 48000, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 1, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_s16, 1000, &fused,
+      &staged, &out_frames);
+  fail_unless_equals_int (out_frames, 1000);
+  fail_unless (memcmp (fused, staged, out_frames * sizeof (gfloat)) == 0);
+  g_free (fused);
+  g_free (staged);
+
+  /* 5.1 S16 to stereo F32 */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 48000, 6, pos_51);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_s16, 1000, &fused,
+      &staged, &out_frames);
+  fail_unless (memcmp (fused, staged, out_frames * 2 * sizeof (gfloat)) == 0);
+  g_free (fused);
+  g_free (staged);
+
+  /* stereo F32 to mono F32 */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 1, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_f32, 1000, &fused,
+      &staged, &out_frames);
+  fail_unless (memcmp (fused, staged, out_frames * sizeof (gfloat)) == 0);
+  g_free (fused);
+  g_free (staged);
+
+  /* stereo S16 48kHz to mono F32 16kHz, the fused path resamples in F32 so
+   * only check that it is close to the staged F64 result */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 48000, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 16000, 1, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_s16, 3000, &fused,
+      &staged, &out_frames);
+  fail_unless (out_frames > 0);
+  for (i = 0; i < out_frames; i++)
+    fail_unless (fabs (fused[i] - staged[i]) < 1e-3, "%" G_GSIZE_FORMAT
+        ": %f != %f", i, fused[i], staged[i]);
+  g_free (fused);
+  g_free (staged);
+}
+
+GST_END_TEST;
+
+static void
+convert_default (GstAudioInfo * in_info, GstAudioInfo * out_info,
+    gconstpointer in, gsize in_frames, gfloat * out, gsize out_frames)
+{
+  GstAudioConverter *conv;
+  gpointer in_ptr[1], out_ptr[1];
+
+  conv = gst_audio_converter_new (0, in_info, out_info, NULL);
+  fail_unless (conv != NULL);
+  fail_unless_equals_int (gst_audio_converter_get_out_frames (conv,
+          in_frames), out_frames);
+
+  in_ptr[0] = (gpointer) in;
+  out_ptr[0] = out;
+  fail_unless (gst_audio_converter_samples (conv, 0, in_ptr, in_frames,
+          out_ptr, out_frames));
+  gst_audio_converter_free (conv);
+}
+
+/* Without options the fused kernels are only used where they give exactly
+ * the same output as the staged conversion, resampling stays on the staged
+ * path. */
+GST_START_TEST (test_audio_converter_fused_default)
+{
+  GstAudioInfo in_info, out_info;
+  gint16 in_s16[2 * 3000];
+  gfloat *fused, *staged, *def;
+  gsize i, out_frames;
+
+  for (i = 0; i < G_N_ELEMENTS (in_s16); i++)
+    in_s16[i] = g_random_int_range (G_MININT16, G_MAXINT16 + 1);
+
+  /* stereo S16 to mono F32 */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 48000, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 1, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_s16, 3000, &fused,
+      &staged, &out_frames);
+  def = g_new0 (gfloat, out_frames);
+  convert_default (&in_info, &out_info, in_s16, 3000, def, out_frames);
+  fail_unless (memcmp (def, staged, out_frames * sizeof (gfloat)) == 0);
+  g_free (def);
+  g_free (fused);
+  g_free (staged);
+
+  /* stereo S16 48kHz to mono F32 16kHz */
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 16000, 1, NULL);
+  convert_fused_and_staged (&in_info, &out_info, in_s16, 3000, &fused,
+      &staged, &out_frames);
+  def = g_new0 (gfloat, out_frames);
+  convert_default (&in_info, &out_info, in_s16, 3000, def, out_frames);
+  fail_unless (memcmp (def, staged, out_frames * sizeof (gfloat)) == 0);
+  g_free (def);
+  g_free (fused);
+  g_free (staged);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1718,6 +1879,8 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
   tcase_add_test (tc_chain, test_audio_meta_serialize);
   tcase_add_test (tc_chain, test_audio_meta_serialize_65_chans);
+  tcase_add_test (tc_chain, test_audio_converter_fused);
+  tcase_add_test (tc_chain, test_audio_converter_fused_default);
 
   return s;
 }
@@ -1580,6 +1580,93 @@ GST_END_TEST;
 
 
 
+GST_START_TEST (videodecoder_drop_hint)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  GstMessage *msg;
+  GstBus *bus;
+  GstFormat format;
+  guint64 i, processed, dropped;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (dec, bus);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* downstream only keeps one frame out of 3 */
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_video_event_new_drop_hint (0, TEST_VIDEO_FPS_N / 3,
+              TEST_VIDEO_FPS_D)));
+
+  /* every first frame after a kept one is droppable and must not even be
+   * decoded, the others are decoded but not pushed */
+  for (i = 0; i < 30; i++) {
+    buffer = create_test_buffer (i);
+    if (i % 3 == 1)
+      GST_BUFFER_FLAG_SET (buffer,
+          GST_BUFFER_FLAG_DELTA_UNIT | GST_BUFFER_FLAG_DROPPABLE);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless_equals_int (g_list_length (buffers), 10);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+    i += 3;
+  }
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  /* every skipped frame, decoded or not, is accounted as dropped */
+  for (i = 0; i < 20; i++) {
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_QOS);
+    fail_unless (msg != NULL);
+    gst_message_parse_qos_stats (msg, &format, &processed, &dropped);
+    fail_unless_equals_int (format, GST_FORMAT_BUFFERS);
+    fail_unless_equals_uint64 (dropped, i + 1);
+    gst_message_unref (msg);
+  }
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_QOS) == NULL);
+
+  /* clearing the hint outputs all frames again */
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_video_event_new_drop_hint (GST_CLOCK_TIME_NONE, 0, 1)));
+
+  for (i = 30; i < 36; i++) {
+    buffer = create_test_buffer (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+  fail_unless_equals_int (g_list_length (buffers), 6);
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_QOS) == NULL);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  gst_element_set_bus (dec, NULL);
+  gst_object_unref (bus);
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
 static Suite *
 gst_videodecoder_suite (void)
 {
@@ -1615,6 +1702,7 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_playback_packetized_subframes_metadata_copy);
   tcase_add_test (tc, videodecoder_playback_invalid_ts_packetized);
   tcase_add_test (tc, videodecoder_playback_invalid_ts_packetized_subframes);
+  tcase_add_test (tc, videodecoder_drop_hint);
 
   return s;
 }
@@ -0,0 +1,164 @@
+/* GStreamer audio format conversion benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_IN_FORMAT "S16LE"
+#define DEFAULT_OUT_FORMAT "F32LE"
+#define DEFAULT_IN_RATE 48000
+#define DEFAULT_OUT_RATE 16000
+#define DEFAULT_IN_CHANNELS 2
+#define DEFAULT_OUT_CHANNELS 1
+#define DEFAULT_FRAMES 960
+
+#define DEFAULT_DURATION 2.0
+
+static gdouble
+do_benchmark_conversion (GstAudioInfo * in_info, GstAudioInfo * out_info,
+    gboolean fused, gsize in_frames, gdouble max_duration)
+{
+  GstAudioConverter *convert;
+  gpointer in[1], out[1];
+  gsize out_frames;
+  GTimer *timer;
+  gdouble elapsed;
+  gint count;
+
+  convert = gst_audio_converter_new (0, in_info, out_info,
+      gst_structure_new ("options", GST_AUDIO_CONVERTER_OPT_FUSED,
+          G_TYPE_BOOLEAN, fused, GST_AUDIO_CONVERTER_OPT_FUSED_RESAMPLE,
+          G_TYPE_BOOLEAN, fused, NULL));
+  if (convert == NULL) {
+    gst_printerrln ("conversion not supported");
+    return 0.0;
+  }
+
+  out_frames = gst_audio_converter_get_out_frames (convert, in_frames);
+  /* leave some room for the resampler rounding */
+  in[0] = g_malloc0 ((in_frames + 1) * GST_AUDIO_INFO_BPF (in_info));
+  out[0] = g_malloc0 ((out_frames + 1) * GST_AUDIO_INFO_BPF (out_info));
+
+  timer = g_timer_new ();
+
+  /* warmup */
+  gst_audio_converter_samples (convert, 0, in, in_frames, out, out_frames);
+
+  count = 0;
+  g_timer_start (timer);
+  while (TRUE) {
+    out_frames = gst_audio_converter_get_out_frames (convert, in_frames);
+    gst_audio_converter_samples (convert, 0, in, in_frames, out, out_frames);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  gst_println ("%10.1f buffers/sec %s %s/%d/%d -> %s/%d/%d, %"
+      G_GSIZE_FORMAT " frames, %d/%.5f", count / elapsed,
+      fused ? "fused " : "staged",
+      GST_AUDIO_INFO_NAME (in_info), GST_AUDIO_INFO_RATE (in_info),
+      GST_AUDIO_INFO_CHANNELS (in_info), GST_AUDIO_INFO_NAME (out_info),
+      GST_AUDIO_INFO_RATE (out_info), GST_AUDIO_INFO_CHANNELS (out_info),
+      in_frames, count, elapsed);
+
+  g_timer_destroy (timer);
+  g_free (in[0]);
+  g_free (out[0]);
+  gst_audio_converter_free (convert);
+
+  return count / elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gchar *from_fmt = NULL;
+  gchar *to_fmt = NULL;
+  gint in_rate = DEFAULT_IN_RATE;
+  gint out_rate = DEFAULT_OUT_RATE;
+  gint in_channels = DEFAULT_IN_CHANNELS;
+  gint out_channels = DEFAULT_OUT_CHANNELS;
+  gint frames = DEFAULT_FRAMES;
+  gdouble max_dur = DEFAULT_DURATION;
+  GstAudioFormat in_format, out_format;
+  GstAudioInfo in_info, out_info;
+  gdouble staged, fused;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"from-format", 'f', 0, G_OPTION_ARG_STRING, &from_fmt, "From Format",
+        NULL},
+    {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
+    {"in-rate", 0, 0, G_OPTION_ARG_INT, &in_rate, "Input rate", NULL},
+    {"out-rate", 0, 0, G_OPTION_ARG_INT, &out_rate, "Output rate", NULL},
+    {"in-channels", 0, 0, G_OPTION_ARG_INT, &in_channels, "Input channels",
+        NULL},
+    {"out-channels", 0, 0, G_OPTION_ARG_INT, &out_channels, "Output channels",
+        NULL},
+    {"frames", 'n', 0, G_OPTION_ARG_INT, &frames,
+        "Number of input frames per buffer", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  in_format = gst_audio_format_from_string (from_fmt ? from_fmt :
+      DEFAULT_IN_FORMAT);
+  out_format = gst_audio_format_from_string (to_fmt ? to_fmt :
+      DEFAULT_OUT_FORMAT);
+  if (in_format == GST_AUDIO_FORMAT_UNKNOWN
+      || out_format == GST_AUDIO_FORMAT_UNKNOWN) {
+    gst_printerrln ("unknown format");
+    return 1;
+  }
+
+  /* use the default channel layout for the given number of channels */
+  gst_audio_info_set_format (&in_info, in_format, in_rate, in_channels, NULL);
+  gst_audio_info_set_format (&out_info, out_format, out_rate, out_channels,
+      NULL);
+
+  staged = do_benchmark_conversion (&in_info, &out_info, FALSE, frames,
+      max_dur);
+  fused = do_benchmark_conversion (&in_info, &out_info, TRUE, frames, max_dur);
+
+  if (staged > 0.0)
+    gst_println ("fused/staged speedup: %.2fx", fused / staged);
+
+  g_free (from_fmt);
+  g_free (to_fmt);
+
+  return 0;
+}
@@ -367,6 +367,9 @@ static GstFlowReturn
 gst_dash_demux_stream_advance_fragment (GstAdaptiveDemux2Stream * stream);
 static gboolean
 gst_dash_demux_stream_advance_subfragment (GstAdaptiveDemux2Stream * stream);
+static gboolean
+gst_dash_demux_stream_peek_fragment (GstAdaptiveDemux2Stream * stream,
+    guint index, gchar ** uri, gint64 * range_start, gint64 * range_end);
 static gboolean gst_dash_demux_stream_select_bitrate (GstAdaptiveDemux2Stream *
     stream, guint64 bitrate);
 static GstClockTime
@@ -484,6 +487,8 @@ gst_dash_demux_stream_class_init (GstDashDemux2StreamClass * klass)
   adaptivedemux2stream_class->stream_seek = gst_dash_demux_stream_seek;
   adaptivedemux2stream_class->advance_fragment =
       gst_dash_demux_stream_advance_fragment;
+  adaptivedemux2stream_class->peek_fragment =
+      gst_dash_demux_stream_peek_fragment;
   adaptivedemux2stream_class->get_fragment_waiting_time =
       gst_dash_demux_stream_get_fragment_waiting_time;
   adaptivedemux2stream_class->select_bitrate =
@@ -2753,6 +2758,60 @@ gst_dash_demux_update_manifest_data (GstAdaptiveDemux * demux,
   return GST_FLOW_OK;
 }
 
+/* Looks up the segment @index positions after the current one by
+ * temporarily advancing the active stream. Only done for segment lists and
+ * templates: on-demand profile streams are sub-fragmented through the sidx,
+ * and key-unit trick modes only download parts of fragments */
+static gboolean
+gst_dash_demux_stream_peek_fragment (GstAdaptiveDemux2Stream * stream,
+    guint index, gchar ** uri, gint64 * range_start, gint64 * range_end)
+{
+  GstDashDemux2Stream *dashstream = (GstDashDemux2Stream *) stream;
+  GstDashDemux2 *dashdemux = GST_DASH_DEMUX_CAST (stream->demux);
+  GstActiveStream *active_stream = dashstream->active_stream;
+  GstMediaFragmentInfo fragment;
+  gint segment_index;
+  guint segment_repeat_index;
+  gboolean ret = FALSE;
+  guint i;
+
+  if (active_stream == NULL
+      || gst_mpd_client2_has_isoff_ondemand_profile (dashdemux->client)
+      || GST_ADAPTIVE_DEMUX_IN_TRICKMODE_KEY_UNITS (dashdemux)
+      || stream->demux->segment.rate < 0)
+    return FALSE;
+
+  segment_index = active_stream->segment_index;
+  segment_repeat_index = active_stream->segment_repeat_index;
+
+  for (i = 0; i < index; i++) {
+    if (gst_mpd_client2_advance_segment (dashdemux->client, active_stream,
+            TRUE) != GST_FLOW_OK)
+      goto out;
+  }
+
+  /* Don't request live segments before they are available */
+  if (gst_dash_demux_stream_get_fragment_waiting_time (stream) > 0)
+    goto out;
+
+  if (!gst_mpd_client2_get_next_fragment (dashdemux->client, dashstream->index,
+          &fragment))
+    goto out;
+
+  /* Must match what update_fragment_info() sets up for the fragment */
+  *uri = g_steal_pointer (&fragment.uri);
+  *range_start = MAX (fragment.range_start, dashstream->sidx_base_offset);
+  *range_end = fragment.range_end;
+  gst_mpdparser_media_fragment_info_clear (&fragment);
+  ret = (*uri != NULL);
+
+out:
+  active_stream->segment_index = segment_index;
+  active_stream->segment_repeat_index = segment_repeat_index;
+
+  return ret;
+}
+
 static GstClockTime
 gst_dash_demux_stream_get_fragment_waiting_time (GstAdaptiveDemux2Stream *
     stream)
@@ -812,8 +812,12 @@ downloadhelper_new (GstAdaptiveDemuxClock * clock)
   g_main_context_push_thread_default (dh->transfer_context);
 
   /* Set 10 second timeout. Any longer is likely
-   * an attempt to reuse an already closed connection */
-  dh->session = _soup_session_new_with_options ("timeout", 10, NULL);
+   * an attempt to reuse an already closed connection.
+   * libsoup allows only 2 connections per host by default, which would
+   * serialise fragment prefetches from the same server behind the playlist
+   * and fragment downloads */
+  dh->session = _soup_session_new_with_options ("timeout", 10,
+      "max-conns-per-host", 8, NULL);
 
   /* Setup soup header debugging if we are at GST_LEVEL_TRACE */
   if (gst_debug_category_get_threshold (GST_CAT_DEFAULT) >= GST_LEVEL_TRACE) {
@@ -0,0 +1,458 @@
+/* GStreamer
+ *
+ * gstadaptivedemux-prefetcher.c:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstadaptivedemux-prefetcher.h"
+
+/* The prefetcher downloads the fragments following the one a stream is
+ * currently downloading, so that several transfers are in flight at once
+ * instead of paying a full request round-trip for each fragment.
+ *
+ * When the stream gets to a fragment, it submits its own download request
+ * as usual. If a prefetch matches the URI and byte range exactly, the
+ * prefetch takes over that request and feeds it the data it already has and
+ * any data that arrives later.
+ *
+ * Everything is called from the scheduler thread, including
+ * download handling callbacks */
+
+GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
+#define GST_CAT_DEFAULT adaptivedemux2_debug
+
+typedef struct _GstAdaptiveDemuxPrefetchRequest GstAdaptiveDemuxPrefetchRequest;
+struct _GstAdaptiveDemuxPrefetchRequest
+{
+  guint ref_count;
+
+  GstAdaptiveDemuxPrefetcher *prefetcher;       /* Parent prefetcher */
+
+  /* Incoming download for the fragment */
+  DownloadRequest *download_request;
+  gboolean download_is_finished;        /* TRUE if the download completed / failed */
+
+  /* TRUE if the fragment is still among the ones to prefetch. Only
+   * meaningful between begin_update() and end_update() */
+  gboolean wanted;
+  /* TRUE once removed from the active prefetches */
+  gboolean released;
+
+  /* The stream download request being fed from this prefetch, once the
+   * stream asked for the fragment */
+  DownloadRequest *target_request;
+};
+
+static GstAdaptiveDemuxPrefetchRequest *
+gst_adaptive_demux_prefetch_request_new (GstAdaptiveDemuxPrefetcher *
+    prefetcher)
+{
+  GstAdaptiveDemuxPrefetchRequest *req =
+      g_new0 (GstAdaptiveDemuxPrefetchRequest, 1);
+
+  req->ref_count = 1;
+  req->prefetcher = prefetcher;
+
+  return req;
+}
+
+static GstAdaptiveDemuxPrefetchRequest *
+gst_adaptive_demux_prefetch_request_ref (GstAdaptiveDemuxPrefetchRequest * req)
+{
+  req->ref_count++;
+  return req;
+}
+
+static void
+gst_adaptive_demux_prefetch_request_unref (GstAdaptiveDemuxPrefetchRequest *
+    req)
+{
+  if (--req->ref_count > 0)
+    return;
+
+  if (req->download_request != NULL) {
+    /* The download request must have been cancelled or completed,
+     * but cancellation is async, so we can't verify */
+    download_request_unref (req->download_request);
+  }
+
+  if (req->target_request != NULL)
+    download_request_unref (req->target_request);
+
+  g_free (req);
+}
+
+static void
+gst_adaptive_demux_prefetcher_release_request (GstAdaptiveDemuxPrefetcher *
+    prefetcher, GstAdaptiveDemuxPrefetchRequest * prefetch_req,
+    gboolean cancel_download)
+{
+  DownloadRequest *download_req = prefetch_req->download_request;
+
+  g_ptr_array_remove_fast (prefetcher->active_prefetches, prefetch_req);
+  prefetch_req->released = TRUE;
+
+  if (cancel_download && !prefetch_req->download_is_finished) {
+    GST_DEBUG ("Cancelling prefetch uri: %s, range:%" G_GINT64_FORMAT " - %"
+        G_GINT64_FORMAT, download_req->uri, download_req->range_start,
+        download_req->range_end);
+
+    /* We don't want any callbacks to happen after we cancel here */
+    download_request_set_callbacks (download_req, NULL, NULL, NULL, NULL,
+        NULL);
+    downloadhelper_cancel_request (prefetcher->download_helper, download_req);
+  }
+
+  gst_adaptive_demux_prefetch_request_unref (prefetch_req);
+}
+
+GstAdaptiveDemuxPrefetcher *
+gst_adaptive_demux_prefetcher_new (DownloadHelper * download_helper)
+{
+  GstAdaptiveDemuxPrefetcher *prefetcher =
+      g_new0 (GstAdaptiveDemuxPrefetcher, 1);
+
+  prefetcher->download_helper = download_helper;
+  prefetcher->active_prefetches = g_ptr_array_new ();
+
+  return prefetcher;
+}
+
+void
+gst_adaptive_demux_prefetcher_free (GstAdaptiveDemuxPrefetcher * prefetcher)
+{
+  gst_adaptive_demux_prefetcher_cancel (prefetcher);
+  g_ptr_array_free (prefetcher->active_prefetches, TRUE);
+  g_free (prefetcher);
+}
+
+/* Transfers any available data to the target request, and completes it and
+ * removes the prefetch once the download is finished */
+static void
+gst_adaptive_demux_prefetcher_despatch (GstAdaptiveDemuxPrefetchRequest *
+    prefetch_req, gboolean input_is_finished)
+{
+  GstAdaptiveDemuxPrefetcher *prefetcher = prefetch_req->prefetcher;
+  DownloadRequest *download_req = prefetch_req->download_request;
+  DownloadRequest *target_req = prefetch_req->target_request;
+  DownloadRequestState input_state;
+  GstBuffer *buffer;
+
+  if (input_is_finished)
+    prefetch_req->download_is_finished = TRUE;
+  else
+    input_is_finished = prefetch_req->download_is_finished;
+
+  download_request_lock (download_req);
+  input_state = download_req->state;
+  download_request_unlock (download_req);
+
+  if (target_req == NULL) {
+    /* Nobody asked for this fragment yet, keep the data until the stream
+     * gets there. If the download failed, drop it and let the stream
+     * request the fragment itself */
+    if (input_is_finished && input_state != DOWNLOAD_REQUEST_STATE_COMPLETE) {
+      GST_DEBUG ("Dropping failed prefetch uri: %s, range:%" G_GINT64_FORMAT
+          " - %" G_GINT64_FORMAT " status %u", download_req->uri,
+          download_req->range_start, download_req->range_end,
+          download_req->status_code);
+      gst_adaptive_demux_prefetcher_release_request (prefetcher, prefetch_req,
+          FALSE);
+    }
+    return;
+  }
+
+  /* The stream can cancel the target request or stop altogether from its
+   * callbacks, which releases this prefetch */
+  download_request_ref (target_req);
+  gst_adaptive_demux_prefetch_request_ref (prefetch_req);
+
+  download_request_lock (target_req);
+  download_request_lock (download_req);
+
+  target_req->status_code = download_req->status_code;
+  target_req->content_length = download_req->content_length;
+
+  /* Report the timing of the actual transfer, so the stream can estimate
+   * the bitrate */
+  target_req->download_request_time = download_req->download_request_time;
+  target_req->download_start_time = download_req->download_start_time;
+  target_req->download_newest_data_time =
+      download_req->download_newest_data_time;
+  if (input_is_finished)
+    target_req->download_end_time = download_req->download_end_time;
+
+  if (target_req->headers == NULL && download_req->headers != NULL)
+    target_req->headers = gst_structure_copy (download_req->headers);
+
+  if (target_req->redirect_uri == NULL && download_req->redirect_uri != NULL) {
+    target_req->redirect_uri = g_strdup (download_req->redirect_uri);
+    target_req->redirect_permanent = download_req->redirect_permanent;
+  }
+
+  buffer = download_request_take_buffer (download_req);
+  if (buffer != NULL) {
+    GST_LOG ("Adding %" G_GSIZE_FORMAT " bytes to target download request "
+        "uri %s range %" G_GINT64_FORMAT " - %" G_GINT64_FORMAT,
+        gst_buffer_get_size (buffer), target_req->uri,
+        target_req->range_start, target_req->range_end);
+
+    /* Buffers can only be added before the request is complete */
+    target_req->state = DOWNLOAD_REQUEST_STATE_LOADING;
+    download_request_add_buffer (target_req, buffer);
+  }
+  target_req->state = input_state;
+
+  download_request_unlock (download_req);
+
+  if (input_is_finished) {
+    GST_DEBUG ("Finishing target request uri: %s, range:%" G_GINT64_FORMAT
+        " - %" G_GINT64_FORMAT " from prefetch, state %d", target_req->uri,
+        target_req->range_start, target_req->range_end, input_state);
+    download_request_despatch_completion (target_req);
+  } else if (buffer != NULL) {
+    download_request_despatch_progress (target_req);
+  }
+
+  download_request_unlock (target_req);
+
+  if (input_is_finished && !prefetch_req->released) {
+    gst_adaptive_demux_prefetcher_release_request (prefetcher, prefetch_req,
+        FALSE);
+  }
+
+  gst_adaptive_demux_prefetch_request_unref (prefetch_req);
+  download_request_unref (target_req);
+}
+
+static void
+on_download_cancellation (DownloadRequest * request, DownloadRequestState state,
+    GstAdaptiveDemuxPrefetchRequest * prefetch_req)
+{
+  gst_adaptive_demux_prefetcher_despatch (prefetch_req, TRUE);
+}
+
+static void
+on_download_error (DownloadRequest * request, DownloadRequestState state,
+    GstAdaptiveDemuxPrefetchRequest * prefetch_req)
+{
+  GST_DEBUG ("prefetch uri: %s download error, status %u", request->uri,
+      request->status_code);
+
+  gst_adaptive_demux_prefetcher_despatch (prefetch_req, TRUE);
+}
+
+static void
+on_download_progress (DownloadRequest * request, DownloadRequestState state,
+    GstAdaptiveDemuxPrefetchRequest * prefetch_req)
+{
+  GST_LOG ("prefetch uri: %s download progress. %" G_GUINT64_FORMAT " of %"
+      G_GUINT64_FORMAT " bytes", request->uri, request->content_received,
+      request->content_length);
+
+  gst_adaptive_demux_prefetcher_despatch (prefetch_req, FALSE);
+}
+
+static void
+on_download_complete (DownloadRequest * request, DownloadRequestState state,
+    GstAdaptiveDemuxPrefetchRequest * prefetch_req)
+{
+  GST_DEBUG ("prefetch uri: %s download complete. %" G_GUINT64_FORMAT
+      " bytes", request->uri, request->content_received);
+
+  gst_adaptive_demux_prefetcher_despatch (prefetch_req, TRUE);
+}
+
+/* Returns the prefetch for the given fragment that isn't feeding a
+ * stream request yet, if any */
+static GstAdaptiveDemuxPrefetchRequest *
+gst_adaptive_demux_prefetcher_find (GstAdaptiveDemuxPrefetcher * prefetcher,
+    const gchar * uri, gint64 range_start, gint64 range_end)
+{
+  guint idx;
+
+  for (idx = 0; idx < prefetcher->active_prefetches->len; idx++) {
+    GstAdaptiveDemuxPrefetchRequest *req =
+        g_ptr_array_index (prefetcher->active_prefetches, idx);
+    DownloadRequest *download_req = req->download_request;
+
+    if (req->target_request != NULL)
+      continue;
+
+    if (download_req->range_start == range_start
+        && download_req->range_end == range_end
+        && !g_strcmp0 (download_req->uri, uri))
+      return req;
+  }
+
+  return NULL;
+}
+
+/* Starts a prefetch update. Prefetches that are neither retained nor loaded
+ * again before gst_adaptive_demux_prefetcher_end_update() are cancelled */
+void
+gst_adaptive_demux_prefetcher_begin_update (GstAdaptiveDemuxPrefetcher *
+    prefetcher)
+{
+  guint idx;
+
+  for (idx = 0; idx < prefetcher->active_prefetches->len; idx++) {
+    GstAdaptiveDemuxPrefetchRequest *req =
+        g_ptr_array_index (prefetcher->active_prefetches, idx);
+    req->wanted = FALSE;
+  }
+}
+
+/* Keeps an existing prefetch for the fragment, without starting one.
+ * Returns TRUE if there is one */
+gboolean
+gst_adaptive_demux_prefetcher_retain (GstAdaptiveDemuxPrefetcher * prefetcher,
+    const gchar * uri, gint64 range_start, gint64 range_end)
+{
+  GstAdaptiveDemuxPrefetchRequest *req =
+      gst_adaptive_demux_prefetcher_find (prefetcher, uri, range_start,
+      range_end);
+
+  if (req == NULL)
+    return FALSE;
+
+  req->wanted = TRUE;
+  return TRUE;
+}
+
+/* Keeps the prefetch for the fragment, or starts one if there is none */
+gboolean
+gst_adaptive_demux_prefetcher_load (GstAdaptiveDemuxPrefetcher * prefetcher,
+    const gchar * uri, gint64 range_start, gint64 range_end)
+{
+  GstAdaptiveDemuxPrefetchRequest *req;
+  DownloadRequest *download_req;
+
+  if (gst_adaptive_demux_prefetcher_retain (prefetcher, uri, range_start,
+          range_end)) {
+    GST_LOG ("Ignoring pre-existing prefetch uri: %s, range:%" G_GINT64_FORMAT
+        " - %" G_GINT64_FORMAT, uri, range_start, range_end);
+    return TRUE;
+  }
+
+  req = gst_adaptive_demux_prefetch_request_new (prefetcher);
+  download_req = download_request_new_uri_range (uri, range_start, range_end);
+  download_request_set_callbacks (download_req,
+      (DownloadRequestEventCallback) on_download_complete,
+      (DownloadRequestEventCallback) on_download_error,
+      (DownloadRequestEventCallback) on_download_cancellation,
+      (DownloadRequestEventCallback) on_download_progress, req);
+  req->download_request = download_req;
+
+  GST_DEBUG ("Submitting prefetch uri: %s, range:%" G_GINT64_FORMAT " - %"
+      G_GINT64_FORMAT, uri, range_start, range_end);
+
+  if (!downloadhelper_submit_request (prefetcher->download_helper,
+          NULL, DOWNLOAD_FLAG_NONE, download_req, NULL)) {
+    /* Abandon the request */
+    gst_adaptive_demux_prefetch_request_unref (req);
+    return FALSE;
+  }
+
+  req->wanted = TRUE;
+  g_ptr_array_add (prefetcher->active_prefetches, req);
+
+  return TRUE;
+}
+
+void
+gst_adaptive_demux_prefetcher_end_update (GstAdaptiveDemuxPrefetcher *
+    prefetcher)
+{
+  guint idx;
+
+  for (idx = 0; idx < prefetcher->active_prefetches->len;) {
+    GstAdaptiveDemuxPrefetchRequest *req =
+        g_ptr_array_index (prefetcher->active_prefetches, idx);
+
+    if (!req->wanted && req->target_request == NULL) {
+      gst_adaptive_demux_prefetcher_release_request (prefetcher, req, TRUE);
+      continue;                 /* Don't increment idx++, as we just removed an item */
+    }
+
+    idx++;
+  }
+}
+
+/* Cancels all prefetches, including any that are feeding a stream request */
+void
+gst_adaptive_demux_prefetcher_cancel (GstAdaptiveDemuxPrefetcher * prefetcher)
+{
+  while (prefetcher->active_prefetches->len > 0) {
+    gst_adaptive_demux_prefetcher_release_request (prefetcher,
+        g_ptr_array_index (prefetcher->active_prefetches, 0), TRUE);
+  }
+}
+
+/* Called when the stream abandons @target_req, to stop feeding it */
+void
+gst_adaptive_demux_prefetcher_cancel_target (GstAdaptiveDemuxPrefetcher *
+    prefetcher, DownloadRequest * target_req)
+{
+  guint idx;
+
+  for (idx = 0; idx < prefetcher->active_prefetches->len; idx++) {
+    GstAdaptiveDemuxPrefetchRequest *req =
+        g_ptr_array_index (prefetcher->active_prefetches, idx);
+
+    if (req->target_request == target_req) {
+      gst_adaptive_demux_prefetcher_release_request (prefetcher, req, TRUE);
+      return;
+    }
+  }
+}
+
+/* See if a stream download request can be satisfied from a prefetch, and
+ * take it over if so. Only exact matches of URI and byte range are
+ * considered. The prefetch download might still be ongoing, in which case
+ * the data is passed on as it arrives, or it might be complete already, in
+ * which case the target request is completed right away */
+gboolean
+gst_adaptive_demux_prefetcher_provide_request (GstAdaptiveDemuxPrefetcher *
+    prefetcher, DownloadRequest * target_req)
+{
+  GstAdaptiveDemuxPrefetchRequest *prefetch_req =
+      gst_adaptive_demux_prefetcher_find (prefetcher, target_req->uri,
+      target_req->range_start, target_req->range_end);
+
+  if (prefetch_req == NULL)
+    return FALSE;
+
+  GST_DEBUG ("Found a matching prefetch uri: %s, range:%" G_GINT64_FORMAT
+      " - %" G_GINT64_FORMAT, target_req->uri, target_req->range_start,
+      target_req->range_end);
+
+  /* Attach the target request and despatch any available data */
+  prefetch_req->target_request = download_request_ref (target_req);
+
+  download_request_lock (target_req);
+  target_req->state = DOWNLOAD_REQUEST_STATE_UNSENT;
+  download_request_begin_download (target_req);
+  download_request_unlock (target_req);
+
+  gst_adaptive_demux_prefetcher_despatch (prefetch_req, FALSE);
+  return TRUE;
+}
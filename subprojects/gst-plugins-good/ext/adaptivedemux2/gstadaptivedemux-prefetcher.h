@@ -0,0 +1,51 @@
+/* GStreamer
+ *
+ * gstadaptivedemux-prefetcher.h:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef __GST_ADAPTIVE_DEMUX_PREFETCHER_H__
+#define __GST_ADAPTIVE_DEMUX_PREFETCHER_H__
+
+#include <glib.h>
+
+#include "downloadrequest.h"
+#include "downloadhelper.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GstAdaptiveDemuxPrefetcher GstAdaptiveDemuxPrefetcher;
+
+struct _GstAdaptiveDemuxPrefetcher {
+  DownloadHelper *download_helper; /* Owned by the demuxer */
+  GPtrArray *active_prefetches;
+};
+
+GstAdaptiveDemuxPrefetcher *gst_adaptive_demux_prefetcher_new (DownloadHelper *download_helper);
+void gst_adaptive_demux_prefetcher_free (GstAdaptiveDemuxPrefetcher *prefetcher);
+
+void gst_adaptive_demux_prefetcher_begin_update (GstAdaptiveDemuxPrefetcher *prefetcher);
+gboolean gst_adaptive_demux_prefetcher_retain (GstAdaptiveDemuxPrefetcher *prefetcher, const gchar *uri, gint64 range_start, gint64 range_end);
+gboolean gst_adaptive_demux_prefetcher_load (GstAdaptiveDemuxPrefetcher *prefetcher, const gchar *uri, gint64 range_start, gint64 range_end);
+void gst_adaptive_demux_prefetcher_end_update (GstAdaptiveDemuxPrefetcher *prefetcher);
+
+void gst_adaptive_demux_prefetcher_cancel (GstAdaptiveDemuxPrefetcher *prefetcher);
+void gst_adaptive_demux_prefetcher_cancel_target (GstAdaptiveDemuxPrefetcher *prefetcher, DownloadRequest *target_req);
+
+gboolean gst_adaptive_demux_prefetcher_provide_request (GstAdaptiveDemuxPrefetcher *prefetcher, DownloadRequest *target_req);
+
+G_END_DECLS
+#endif /* __GST_ADAPTIVE_DEMUX_PREFETCHER_H__ */
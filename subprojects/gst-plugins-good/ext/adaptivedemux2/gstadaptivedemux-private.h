@@ -171,6 +171,9 @@ struct _GstAdaptiveDemuxPrivate
   gdouble retry_backoff_factor;
   gdouble retry_backoff_max;
 
+  /* Number of upcoming fragments each stream downloads ahead */
+  guint prefetch_depth;
+
 };
 
 static inline gboolean gst_adaptive_demux_scheduler_lock(GstAdaptiveDemux *d)
@@ -112,6 +112,9 @@ gst_adaptive_demux2_stream_finalize (GObject * object)
 
   GST_LOG_OBJECT (object, "Finalizing");
 
+  if (stream->prefetcher)
+    gst_adaptive_demux_prefetcher_free (stream->prefetcher);
+
   if (stream->download_request)
     download_request_unref (stream->download_request);
 
@@ -434,6 +437,9 @@ gst_adaptive_demux2_stream_parse_error (GstAdaptiveDemux2Stream * stream,
 
   downloadhelper_cancel_request (demux->download_helper,
       stream->download_request);
+  if (stream->prefetcher)
+    gst_adaptive_demux_prefetcher_cancel_target (stream->prefetcher,
+        stream->download_request);
 
   /* cancellation is async, so recycle our download request to avoid races */
   download_request_unref (stream->download_request);
@@ -1364,6 +1370,9 @@ on_download_progress (DownloadRequest * request, DownloadRequestState state,
         update_stream_bitrate (stream, request);
 
       downloadhelper_cancel_request (demux->download_helper, request);
+      if (stream->prefetcher)
+        gst_adaptive_demux_prefetcher_cancel_target (stream->prefetcher,
+            request);
 
       /* cancellation is async, so recycle our download request to avoid races */
       download_request_unref (stream->download_request);
@@ -1419,6 +1428,12 @@ gst_adaptive_demux2_stream_submit_request_default (GstAdaptiveDemux2Stream *
 {
   GstAdaptiveDemux *demux = stream->demux;
 
+  /* See if the request can be satisfied from a prefetch */
+  if (stream->prefetcher != NULL &&
+      gst_adaptive_demux_prefetcher_provide_request (stream->prefetcher,
+          download_req))
+    return GST_FLOW_OK;
+
   if (!downloadhelper_submit_request (demux->download_helper,
           NULL, DOWNLOAD_FLAG_NONE, download_req, NULL))
     return GST_FLOW_ERROR;
@@ -1481,6 +1496,55 @@ gst_adaptive_demux2_stream_begin_download_uri (GstAdaptiveDemux2Stream * stream,
   return ret;
 }
 
+/* must be called from the scheduler context
+ *
+ * Starts downloading the fragments following the current one, up to the
+ * configured prefetch depth, and cancels prefetches that are not needed
+ * anymore, e.g. after a bitrate switch. The prefetch for the current fragment
+ * is kept so the download that is about to be submitted can pick it up */
+static void
+gst_adaptive_demux2_stream_update_prefetch (GstAdaptiveDemux2Stream * stream)
+{
+  GstAdaptiveDemux *demux = stream->demux;
+  GstAdaptiveDemux2StreamClass *klass =
+      GST_ADAPTIVE_DEMUX2_STREAM_GET_CLASS (stream);
+  guint depth = gst_adaptive_demux_prefetch_depth (demux);
+  guint i;
+
+  if (depth == 0 || klass->peek_fragment == NULL || demux->segment.rate < 0) {
+    if (stream->prefetcher)
+      gst_adaptive_demux_prefetcher_cancel (stream->prefetcher);
+    return;
+  }
+
+  if (stream->prefetcher == NULL) {
+    stream->prefetcher =
+        gst_adaptive_demux_prefetcher_new (demux->download_helper);
+  }
+
+  gst_adaptive_demux_prefetcher_begin_update (stream->prefetcher);
+  gst_adaptive_demux_prefetcher_retain (stream->prefetcher,
+      stream->fragment.uri, stream->fragment.range_start,
+      stream->fragment.range_end);
+
+  for (i = 1; i <= depth; i++) {
+    gchar *uri = NULL;
+    gint64 range_start = 0, range_end = -1;
+
+    if (!klass->peek_fragment (stream, i, &uri, &range_start, &range_end))
+      break;
+
+    GST_LOG_OBJECT (stream, "Prefetching fragment +%u %s %" G_GINT64_FORMAT
+        "-%" G_GINT64_FORMAT, i, uri, range_start, range_end);
+
+    gst_adaptive_demux_prefetcher_load (stream->prefetcher, uri, range_start,
+        range_end);
+    g_free (uri);
+  }
+
+  gst_adaptive_demux_prefetcher_end_update (stream->prefetcher);
+}
+
 /* must be called from the scheduler context */
 static GstFlowReturn
 gst_adaptive_demux2_stream_download_fragment (GstAdaptiveDemux2Stream * stream)
@@ -1571,6 +1635,8 @@ gst_adaptive_demux2_stream_download_fragment (GstAdaptiveDemux2Stream * stream)
   /* regular single chunk download */
   stream->fragment.chunk_size = 0;
 
+  gst_adaptive_demux2_stream_update_prefetch (stream);
+
   return gst_adaptive_demux2_stream_begin_download_uri (stream, url,
       stream->fragment.range_start, stream->fragment.range_end);
 
@@ -2205,9 +2271,11 @@ gst_adaptive_demux2_stream_stop_default (GstAdaptiveDemux2Stream * stream)
     stream->pending_cb_id = 0;
   }
 
-  /* Cancel and drop the existing download request */
+  /* Cancel and drop the existing download request and prefetches */
   downloadhelper_cancel_request (demux->download_helper,
       stream->download_request);
+  if (stream->prefetcher)
+    gst_adaptive_demux_prefetcher_cancel (stream->prefetcher);
   download_request_unref (stream->download_request);
   stream->downloading_header = stream->downloading_index = FALSE;
   stream->download_request = download_request_new ();
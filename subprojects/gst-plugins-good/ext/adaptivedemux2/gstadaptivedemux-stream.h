@@ -28,6 +28,7 @@
 #include <gst/gst.h>
 #include "gstadaptivedemux-types.h"
 #include "downloadrequest.h"
+#include "gstadaptivedemux-prefetcher.h"
 
 G_BEGIN_DECLS
 
@@ -198,6 +199,24 @@ struct _GstAdaptiveDemux2StreamClass
    */
   gboolean      (*need_another_chunk) (GstAdaptiveDemux2Stream * stream);
 
+  /**
+   * peek_fragment:
+   * @stream: #GstAdaptiveDemux2Stream
+   * @index: how many fragments ahead of the current one to look, starting at 1
+   * @uri: (out) (transfer full): the URI of the fragment
+   * @range_start: (out): the start of the byte range, or 0
+   * @range_end: (out): the end of the byte range (inclusive), or -1
+   *
+   * Optional. Returns the location of an upcoming fragment without changing
+   * the stream position, so it can be prefetched while the current fragment
+   * is downloading. Must match what update_fragment_info() will report once
+   * the stream gets to that fragment.
+   *
+   * Returns: %TRUE if the fragment is known, %FALSE otherwise
+   */
+  gboolean      (*peek_fragment) (GstAdaptiveDemux2Stream * stream, guint index,
+                                  gchar ** uri, gint64 * range_start, gint64 * range_end);
+
   /**
    * select_bitrate:
    * @stream: #GstAdaptiveDemux2Stream
@@ -306,6 +325,10 @@ struct _GstAdaptiveDemux2Stream
   /* persistent, reused download request for fragment data */
   DownloadRequest *download_request;
 
+  /* Downloads of upcoming fragments, only created when prefetching is
+   * enabled */
+  GstAdaptiveDemuxPrefetcher *prefetcher;
+
   GstAdaptiveDemux2StreamState state;
   guint pending_cb_id;
   gboolean download_active;
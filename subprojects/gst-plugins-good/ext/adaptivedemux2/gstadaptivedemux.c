@@ -116,6 +116,7 @@ GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
 #define DEFAULT_MAX_RETRIES 3
 #define DEFAULT_RETRY_BACKOFF_FACTOR 0.0
 #define DEFAULT_RETRY_BACKOFF_MAX    60.0
+#define DEFAULT_PREFETCH_DEPTH 0
 #define DEFAULT_CONNECTION_BITRATE 0
 #define DEFAULT_BANDWIDTH_TARGET_RATIO 0.8f
 
@@ -139,6 +140,7 @@ enum
   PROP_MAX_RETRIES,
   PROP_RETRY_BACKOFF_FACTOR,
   PROP_RETRY_BACKOFF_MAX,
+  PROP_PREFETCH_DEPTH,
   PROP_BANDWIDTH_TARGET_RATIO,
   PROP_CONNECTION_BITRATE,
   PROP_MIN_BITRATE,
@@ -339,6 +341,11 @@ gst_adaptive_demux_set_property (GObject * object, guint prop_id,
     case PROP_RETRY_BACKOFF_MAX:
       demux->priv->retry_backoff_max = g_value_get_double (value);
       break;
+    case PROP_PREFETCH_DEPTH:
+      demux->priv->prefetch_depth = g_value_get_uint (value);
+      GST_DEBUG_OBJECT (demux, "Prefetch depth set to %u",
+          demux->priv->prefetch_depth);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -404,6 +411,9 @@ gst_adaptive_demux_get_property (GObject * object, guint prop_id,
     case PROP_RETRY_BACKOFF_MAX:
       g_value_set_double (value, demux->priv->retry_backoff_max);
       break;
+    case PROP_PREFETCH_DEPTH:
+      g_value_set_uint (value, demux->priv->prefetch_depth);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -580,6 +590,25 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
           DEFAULT_RETRY_BACKOFF_MAX,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAdaptiveDemux2:prefetch-depth:
+   *
+   * Number of upcoming fragments to download in parallel with the current one
+   * for each stream. Prefetched fragments are kept until the stream gets to
+   * them, so they are not accounted for in the buffering limits. 0 disables
+   * prefetching.
+   *
+   * Prefetching only happens in forward playback, and only for subclasses that
+   * can tell the location of upcoming fragments.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_DEPTH,
+      g_param_spec_uint ("prefetch-depth", "Prefetch depth",
+          "Number of upcoming fragments to download ahead for each stream "
+          "(0 = disabled)", 0, 16, DEFAULT_PREFETCH_DEPTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_adaptive_demux_audiosrc_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -665,6 +694,7 @@ gst_adaptive_demux_init (GstAdaptiveDemux * demux,
   demux->priv->max_retries = DEFAULT_MAX_RETRIES;
   demux->priv->retry_backoff_factor = DEFAULT_RETRY_BACKOFF_FACTOR;
   demux->priv->retry_backoff_max = DEFAULT_RETRY_BACKOFF_MAX;
+  demux->priv->prefetch_depth = DEFAULT_PREFETCH_DEPTH;
 
   gst_element_add_pad (GST_ELEMENT (demux), demux->sinkpad);
 
@@ -4044,6 +4074,16 @@ gst_adaptive_demux_max_retries (GstAdaptiveDemux * self)
   return res;
 }
 
+guint
+gst_adaptive_demux_prefetch_depth (GstAdaptiveDemux * self)
+{
+  GST_OBJECT_LOCK (self);
+  guint res = self->priv->prefetch_depth;
+  GST_OBJECT_UNLOCK (self);
+
+  return res;
+}
+
 GstClockTime
 gst_adaptive_demux_retry_delay (GstAdaptiveDemux * self, gint retry,
     GstClockTime default_delay)
@@ -593,9 +593,17 @@ on_download_complete (DownloadRequest * download, DownloadRequestState state,
     playlist->request_time = GST_CLOCK_TIME_NONE;
     g_free (playlist_data);
   } else {
-    playlist =
-        gst_hls_media_playlist_parse (playlist_data, playlist_ts, uri,
-        base_uri);
+    /* An update of the same live playlist usually only appends segments,
+     * which can be parsed on top of the current playlist */
+    if (!playlist_uri_change && current_playlist) {
+      playlist =
+          gst_hls_media_playlist_parse_update (current_playlist,
+          playlist_data, playlist_ts, uri, base_uri);
+    } else {
+      playlist =
+          gst_hls_media_playlist_parse (playlist_data, playlist_ts, uri,
+          base_uri);
+    }
     if (!playlist) {
       GST_WARNING_OBJECT (pl, "Couldn't parse playlist");
       goto error_retry_out;
@@ -67,6 +67,9 @@ static GstFlowReturn
 gst_hls_demux_stream_advance_fragment (GstAdaptiveDemux2Stream * stream);
 static GstFlowReturn
 gst_hls_demux_stream_update_fragment_info (GstAdaptiveDemux2Stream * stream);
+static gboolean
+gst_hls_demux_stream_peek_fragment (GstAdaptiveDemux2Stream * stream,
+    guint index, gchar ** uri, gint64 * range_start, gint64 * range_end);
 static GstFlowReturn
 gst_hls_demux_stream_submit_request (GstAdaptiveDemux2Stream * stream,
     DownloadRequest * download_req);
@@ -103,6 +106,8 @@ gst_hls_demux_stream_class_init (GstHLSDemuxStreamClass * klass)
   adaptivedemux2stream_class->stream_seek = gst_hls_demux_stream_seek;
   adaptivedemux2stream_class->advance_fragment =
       gst_hls_demux_stream_advance_fragment;
+  adaptivedemux2stream_class->peek_fragment =
+      gst_hls_demux_stream_peek_fragment;
   adaptivedemux2stream_class->select_bitrate =
       gst_hls_demux_stream_select_bitrate;
   adaptivedemux2stream_class->start = gst_hls_demux_stream_start;
@@ -1213,6 +1218,91 @@ gst_hls_demux_stream_advance_fragment (GstAdaptiveDemux2Stream * stream)
   return GST_FLOW_EOS;
 }
 
+/* Walks @index fragments forward from the current one, the same way
+ * advance_fragment() would, without changing the stream state */
+static gboolean
+gst_hls_demux_stream_peek_fragment (GstAdaptiveDemux2Stream * stream,
+    guint index, gchar ** uri, gint64 * range_start, gint64 * range_end)
+{
+  GstHLSDemuxStream *hlsdemux_stream = GST_HLS_DEMUX_STREAM_CAST (stream);
+  GstHLSMediaPlaylist *playlist = hlsdemux_stream->playlist;
+  GstM3U8MediaSegment *file;
+  GstM3U8PartialSegment *part = NULL;
+  gboolean in_partial_segments = hlsdemux_stream->in_partial_segments;
+  guint part_idx = hlsdemux_stream->part_idx;
+  gboolean ret = FALSE;
+  guint idx;
+
+  if (!hlsdemux_stream->playlist_fetched || playlist == NULL
+      || hlsdemux_stream->current_segment == NULL
+      || stream->demux->segment.rate < 0)
+    return FALSE;
+
+  /* Don't prefetch from a playlist we're about to switch away from */
+  if (gst_hls_demux_stream_check_current_playlist_uri (hlsdemux_stream,
+          NULL) != GST_FLOW_OK)
+    return FALSE;
+
+  GST_HLS_MEDIA_PLAYLIST_LOCK (playlist);
+
+  if (!g_ptr_array_find (playlist->segments, hlsdemux_stream->current_segment,
+          &idx))
+    goto out;
+
+  file = hlsdemux_stream->current_segment;
+
+  while (index-- > 0) {
+    if (in_partial_segments) {
+      guint avail_segments =
+          file->partial_segments != NULL ? file->partial_segments->len : 0;
+
+      if (part_idx + 1 < avail_segments) {
+        part_idx += 1;
+        continue;
+      }
+
+      /* At the live edge, the next part isn't known yet */
+      if (file->partial_only)
+        goto out;
+
+      in_partial_segments = FALSE;
+    }
+
+    if (idx + 1 >= playlist->segments->len)
+      goto out;
+
+    file = g_ptr_array_index (playlist->segments, ++idx);
+
+    if (GST_HLS_MEDIA_PLAYLIST_IS_LIVE (playlist) && file->partial_only) {
+      in_partial_segments = TRUE;
+      part_idx = 0;
+    }
+  }
+
+  if (in_partial_segments) {
+    if (file->partial_segments == NULL
+        || part_idx >= file->partial_segments->len)
+      goto out;
+    part = g_ptr_array_index (file->partial_segments, part_idx);
+  }
+
+  /* Must match what update_fragment_info() sets up for the fragment */
+  if (part == NULL) {
+    *uri = g_strdup (file->uri);
+    *range_start = file->offset;
+    *range_end = file->size != -1 ? file->offset + file->size - 1 : -1;
+  } else {
+    *uri = g_strdup (part->uri);
+    *range_start = part->offset;
+    *range_end = part->size != -1 ? part->offset + part->size - 1 : -1;
+  }
+  ret = (*uri != NULL);
+
+out:
+  GST_HLS_MEDIA_PLAYLIST_UNLOCK (playlist);
+  return ret;
+}
+
 static void
 gst_hls_demux_stream_update_preloads (GstHLSDemuxStream * hlsdemux_stream)
 {
@@ -808,10 +808,157 @@ malformed_line:
   }
 }
 
-/* Parse and create a new GstHLSMediaPlaylist */
-GstHLSMediaPlaylist *
-gst_hls_media_playlist_parse (gchar * data,
-    GstClockTime playlist_ts, const gchar * uri, const gchar * base_uri)
+/* Returns the next line of the header of a media playlist, i.e. before the
+ * first segment, starting from @line and skipping the media and
+ * discontinuity sequence numbers. Returns NULL at the end of the header */
+static const gchar *
+next_header_line (const gchar * line)
+{
+  while (line) {
+    if (g_str_has_prefix (line, "#EXTINF:")
+        || (line[0] != '#' && !g_ascii_isspace (line[0]) && line[0] != '\0'))
+      return NULL;
+
+    if (!g_str_has_prefix (line, "#EXT-X-MEDIA-SEQUENCE:")
+        && !g_str_has_prefix (line, "#EXT-X-DISCONTINUITY-SEQUENCE:"))
+      return line;
+
+    line = strchr (line, '\n');
+    if (line)
+      line++;
+  }
+
+  return NULL;
+}
+
+/* Checks whether the headers of @ref_data and @data are the same, apart from
+ * the media and discontinuity sequence numbers */
+static gboolean
+headers_match (const gchar * ref_data, const gchar * data)
+{
+  const gchar *ref_line = next_header_line (ref_data);
+  const gchar *line = next_header_line (data);
+
+  while (ref_line && line) {
+    gsize len = strcspn (line, "\r\n");
+
+    if (strcspn (ref_line, "\r\n") != len || strncmp (ref_line, line, len))
+      return FALSE;
+
+    ref_line = strchr (ref_line, '\n');
+    ref_line = next_header_line (ref_line ? ref_line + 1 : NULL);
+    line = strchr (line, '\n');
+    line = next_header_line (line ? line + 1 : NULL);
+  }
+
+  return ref_line == NULL && line == NULL;
+}
+
+/* Checks whether @data is an update of the live playlist @reference that
+ * only removed segments from the front and appended lines at the end, which
+ * is all a server is allowed to do (RFC 8216 section 6.2.1). The header must
+ * be the same, apart from the media and discontinuity sequence numbers.
+ *
+ * If so, returns the offset in @data right after the lines describing the
+ * last segment of @reference, and the index in @reference of the first
+ * segment still present in @data. Returns 0 otherwise.
+ *
+ * Must be called with the @reference lock taken */
+static gsize
+find_resume_offset (GstHLSMediaPlaylist * reference, const gchar * data,
+    const gchar * uri, const gchar * base_uri, guint * first_idx,
+    gint64 * media_sequence, gint64 * discont_sequence, gboolean * has_dsn)
+{
+  GstM3U8MediaSegment *first, *last;
+  const gchar *line, *tail, *match;
+  gint64 msn = 0, dsn = -1;
+  gsize tail_len, offset;
+  gint val;
+
+  if (reference->resume_offset == 0 || reference->last_data == NULL
+      || reference->skipped_segments > 0 || reference->segments->len == 0)
+    return 0;
+
+  if (g_strcmp0 (reference->uri, uri) != 0
+      || g_strcmp0 (reference->base_uri, base_uri) != 0)
+    return 0;
+
+  /* Go over the tags before the first segment. Only the media and
+   * discontinuity sequence numbers are allowed to change there */
+  line = data;
+  while (line) {
+    if (g_str_has_prefix (line, "#EXTINF:")
+        || (line[0] != '#' && !g_ascii_isspace (line[0]) && line[0] != '\0'))
+      break;
+
+    if (g_str_has_prefix (line, "#EXT-X-MEDIA-SEQUENCE:")) {
+      if (!int_from_string ((gchar *) line + 22, NULL, &val))
+        return 0;
+      msn = val;
+    } else if (g_str_has_prefix (line, "#EXT-X-DISCONTINUITY-SEQUENCE:")) {
+      if (!int_from_string ((gchar *) line + 30, NULL, &val))
+        return 0;
+      dsn = val;
+    } else if (g_str_has_prefix (line, "#EXT-X-SKIP:")) {
+      /* Delta updates are merged by
+       * gst_hls_media_playlist_sync_skipped_segments() instead */
+      return 0;
+    }
+
+    line = strchr (line, '\n');
+    if (line)
+      line++;
+  }
+
+  /* Anything else in the header is taken over from @reference */
+  if (!headers_match (reference->last_data, data))
+    return 0;
+
+  first = g_ptr_array_index (reference->segments, 0);
+  last = g_ptr_array_index (reference->segments, reference->segments->len - 1);
+  if (msn < first->sequence || msn > last->sequence)
+    return 0;
+
+  *first_idx = msn - first->sequence;
+  first = g_ptr_array_index (reference->segments, *first_idx);
+  if (first->sequence != msn)
+    return 0;
+
+  *has_dsn = dsn != -1;
+  if (*has_dsn != reference->has_ext_x_dsn)
+    return 0;
+  if (*has_dsn && first->discont_sequence != dsn + (first->discont ? 1 : 0))
+    return 0;
+
+  /* The lines describing the last known segment must still be there, with
+   * only new lines after them. They are close to the end, so search
+   * backwards */
+  tail = reference->last_data + reference->resume_offset;
+  tail_len = strlen (tail);
+  match = g_strrstr (data, tail);
+  if (match == NULL || match == data || match[-1] != '\n')
+    return 0;
+
+  offset = match - data + tail_len;
+  if (tail[tail_len - 1] != '\n' && data[offset] != '\0'
+      && data[offset] != '\r' && data[offset] != '\n')
+    return 0;
+
+  /* Going from live to VOD restarts the stream times from 0, which is only
+   * done by a full parse */
+  if (strstr (data + offset, "#EXT-X-ENDLIST") != NULL)
+    return 0;
+
+  *media_sequence = msn;
+  *discont_sequence = dsn;
+
+  return offset;
+}
+
+static GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse_internal (gchar * data,
+    GstClockTime playlist_ts, const gchar * uri, const gchar * base_uri,
+    GstHLSMediaPlaylist * reference)
 {
   gchar *input_data = data;
   GstHLSMediaPlaylist *self;
@@ -830,6 +977,9 @@ gst_hls_media_playlist_parse (gchar * data,
   GstM3U8MediaSegment *previous = NULL;
   GPtrArray *partial_segments = NULL;
   gboolean is_gap = FALSE;
+  gsize resume_offset = 0;
+  gboolean resumable = FALSE;
+  gchar *entry_start;
 
   GST_LOG ("playlist ts: %" GST_TIMEP_FORMAT, &playlist_ts);
   GST_LOG ("uri: %s", uri);
@@ -854,10 +1004,76 @@ gst_hls_media_playlist_parse (gchar * data,
   /* Store a copy of the data */
   self->last_data = g_strdup (data);
 
+  if (reference) {
+    guint first_idx = 0;
+    gint64 new_msn = 0, new_dsn = -1;
+    gboolean has_dsn = FALSE;
+
+    GST_HLS_MEDIA_PLAYLIST_LOCK (reference);
+    resume_offset =
+        find_resume_offset (reference, data, uri, base_uri, &first_idx,
+        &new_msn, &new_dsn, &has_dsn);
+    if (resume_offset) {
+      guint idx, len = reference->segments->len;
+
+      GST_DEBUG ("Reusing %u segments, parsing %" G_GSIZE_FORMAT
+          " appended bytes", len - first_idx, strlen (data + resume_offset));
+
+      self->version = reference->version;
+      self->targetduration = reference->targetduration;
+      self->partial_targetduration = reference->partial_targetduration;
+      self->type = reference->type;
+      self->i_frame = reference->i_frame;
+      self->allowcache = reference->allowcache;
+      self->ext_x_key_present = reference->ext_x_key_present;
+      self->ext_x_pdt_present = reference->ext_x_pdt_present;
+      self->skip_boundary = reference->skip_boundary;
+      self->can_skip_dateranges = reference->can_skip_dateranges;
+      self->hold_back = reference->hold_back;
+      self->part_hold_back = reference->part_hold_back;
+      self->can_block_reload = reference->can_block_reload;
+
+      self->media_sequence = new_msn;
+      if (has_dsn) {
+        self->discont_sequence = new_dsn;
+        self->has_ext_x_dsn = TRUE;
+      }
+
+      for (idx = first_idx; idx < len; idx++) {
+        GstM3U8MediaSegment *segment =
+            g_ptr_array_index (reference->segments, idx);
+
+        g_ptr_array_add (self->segments, gst_m3u8_media_segment_ref (segment));
+        self->duration += segment->duration;
+      }
+
+      /* Restore the parser state as it was after the last segment */
+      previous = g_ptr_array_index (reference->segments, len - 1);
+      mediasequence = previous->sequence + 1;
+      dsn = previous->discont_sequence;
+      current_key = g_strdup (previous->key);
+      have_iv = reference->resume_have_iv;
+      memcpy (iv, reference->resume_iv, sizeof (iv));
+      if (previous->init_file)
+        last_init_file = gst_m3u8_init_file_ref (previous->init_file);
+      is_gap = previous->is_gap;
+
+      self->resume_offset =
+          resume_offset - strlen (reference->last_data +
+          reference->resume_offset);
+      resumable = TRUE;
+    }
+    GST_HLS_MEDIA_PLAYLIST_UNLOCK (reference);
+  }
+
   duration = 0;
   partial_duration = 0;
   title = NULL;
-  data += 7;
+  if (resume_offset)
+    data += resume_offset;
+  else
+    data += 7;
+  entry_start = data;
   while (TRUE) {
     gchar *r;
 
@@ -869,6 +1085,11 @@ gst_hls_media_playlist_parse (gchar * data,
     if (r)
       *r = '\0';
 
+    /* Parsing can only be resumed after the last segment if no tag
+     * follows it */
+    if (data[0] == '#')
+      resumable = FALSE;
+
     if (data[0] != '#' && data[0] != '\0') {
       if (duration <= 0) {
         GST_LOG ("%s: got line without EXTINF, dropping", data);
@@ -942,6 +1163,11 @@ gst_hls_media_playlist_parse (gchar * data,
         size = offset = -1;
         g_ptr_array_add (self->segments, file);
         previous = file;
+
+        self->resume_offset = entry_start - input_data;
+        resumable = TRUE;
+        if (end)
+          entry_start = end + 1;
       }
 
     } else if (g_str_has_prefix (data, "#EXTINF:")) {
@@ -1225,6 +1451,13 @@ gst_hls_media_playlist_parse (gchar * data,
     previous = file;
   }
 
+  if (resumable) {
+    self->resume_have_iv = have_iv;
+    memcpy (self->resume_iv, iv, sizeof (iv));
+  } else {
+    self->resume_offset = 0;
+  }
+
   /* Clean up date that wasn't freed / handed to a segment */
   g_free (current_key);
   current_key = NULL;
@@ -1268,6 +1501,31 @@ gst_hls_media_playlist_parse (gchar * data,
   return self;
 }
 
+/* Parse and create a new GstHLSMediaPlaylist */
+GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse (gchar * data,
+    GstClockTime playlist_ts, const gchar * uri, const gchar * base_uri)
+{
+  return gst_hls_media_playlist_parse_internal (data, playlist_ts, uri,
+      base_uri, NULL);
+}
+
+/* Parse and create a new GstHLSMediaPlaylist for an update of the
+ * @reference playlist. If @data only appends to the data of a live
+ * @reference, the segments still present are shared with @reference and
+ * only the appended lines are parsed. Otherwise this is equivalent to
+ * gst_hls_media_playlist_parse() */
+GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse_update (GstHLSMediaPlaylist * reference,
+    gchar * data, GstClockTime playlist_ts, const gchar * uri,
+    const gchar * base_uri)
+{
+  g_return_val_if_fail (reference != NULL, NULL);
+
+  return gst_hls_media_playlist_parse_internal (data, playlist_ts, uri,
+      base_uri, reference);
+}
+
 /* Returns TRUE if the m3u8 as the same data as playlist_data  */
 gboolean
 gst_hls_media_playlist_has_same_data (GstHLSMediaPlaylist * self,
@@ -155,6 +155,14 @@ struct _GstHLSMediaPlaylist
    * See gst_hls_media_playlist_has_same_data()  */
   gchar   *last_data;
 
+  /* Where and how parsing of last_data can be resumed when the next update
+   * of this live playlist only appends to it.
+   * See gst_hls_media_playlist_parse_update() */
+  gsize    resume_offset;	/* Offset in last_data of the lines describing
+				   the last segment, 0 if not resumable */
+  gboolean resume_have_iv;	/* An explicit IV is in effect at the end */
+  guint8   resume_iv[16];
+
   gint ref_count;               /* ATOMIC */
 };
 
@@ -284,6 +292,13 @@ gst_hls_media_playlist_parse (gchar        * data,
 			      const gchar  * uri,
 			      const gchar  * base_uri);
 
+GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse_update (GstHLSMediaPlaylist * reference,
+				     gchar        * data,
+				     GstClockTime playlist_ts,
+				     const gchar  * uri,
+				     const gchar  * base_uri);
+
 gboolean
 gst_hls_media_playlist_sync_skipped_segments (GstHLSMediaPlaylist * m3u8,
 					   GstHLSMediaPlaylist * reference);
@@ -2004,6 +2004,35 @@ write_error:
   }
 }
 
+/* pushes a complete moof and mdat in one go, so that downstream gets every
+ * fragment as a single unit without any of the media data being copied */
+static GstFlowReturn
+gst_qt_mux_send_buffer_list (GstQTMux * qtmux, GstBufferList * list,
+    guint64 * offset)
+{
+  GstFlowReturn res;
+  gsize size;
+
+  size = gst_buffer_list_calculate_size (list);
+  GST_LOG_OBJECT (qtmux, "sending buffer list of %u buffers, size %"
+      G_GSIZE_FORMAT, gst_buffer_list_length (list), size);
+
+  res = gst_qtmux_push_mdat_stored_buffers (qtmux);
+  if (res == GST_FLOW_OK)
+    res = gst_aggregator_finish_buffer_list (GST_AGGREGATOR (qtmux), list);
+  else
+    gst_buffer_list_unref (list);
+
+  if (res != GST_FLOW_OK)
+    GST_WARNING_OBJECT (qtmux,
+        "Failed to send buffer list size %" G_GSIZE_FORMAT, size);
+
+  if (G_LIKELY (offset))
+    *offset += size;
+
+  return res;
+}
+
 static gboolean
 gst_qt_mux_seek_to_beginning (FILE * f)
 {
@@ -2097,16 +2126,12 @@ fail:
  * we need to record the position of the size field in the stream so we can
  * seek back to it later and update when the streams have finished.
  */
-static GstFlowReturn
-gst_qt_mux_send_mdat_header (GstQTMux * qtmux, guint64 * off, guint64 size,
-    gboolean extended, gboolean fsync_after)
+static GstBuffer *
+gst_qt_mux_create_mdat_header (GstQTMux * qtmux, guint64 size,
+    gboolean extended)
 {
   GstBuffer *buf;
   GstMapInfo map;
-  gboolean mind_fast = FALSE;
-
-  GST_DEBUG_OBJECT (qtmux, "Sending mdat's atom header, "
-      "size %" G_GUINT64_FORMAT, size);
 
   /* if the qtmux state is EOS, really write the mdat, otherwise
    * allow size == 0 for a placeholder atom */
@@ -2143,6 +2168,21 @@ gst_qt_mux_send_mdat_header (GstQTMux * qtmux, guint64 * off, guint64 size,
     gst_buffer_unmap (buf, &map);
   }
 
+  return buf;
+}
+
+static GstFlowReturn
+gst_qt_mux_send_mdat_header (GstQTMux * qtmux, guint64 * off, guint64 size,
+    gboolean extended, gboolean fsync_after)
+{
+  GstBuffer *buf;
+  gboolean mind_fast = FALSE;
+
+  GST_DEBUG_OBJECT (qtmux, "Sending mdat's atom header, "
+      "size %" G_GUINT64_FORMAT, size);
+
+  buf = gst_qt_mux_create_mdat_header (qtmux, size, extended);
+
   GST_LOG_OBJECT (qtmux, "Pushing mdat header");
   if (fsync_after)
     GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_SYNC_AFTER);
@@ -4310,7 +4350,6 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTMuxPad * pad,
     gint64 pts_offset)
 {
   GstFlowReturn ret = GST_FLOW_OK;
-  guint index = 0;
 
   GST_LOG_OBJECT (pad, "%p %u %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
       pad->traf, force, qtmux->current_chunk_offset, chunk_offset);
@@ -4462,11 +4501,13 @@ flush:
       guint64 size = 0, offset = 0;
       guint8 *data = NULL;
       GstBuffer *moof_buffer;
-      guint i, total_size;
+      GstBufferList *list;
+      guint i, n_buffers, total_size;
       AtomTRUN *first_trun;
 
+      n_buffers = atom_array_get_len (&pad->fragment_buffers);
       total_size = 0;
-      for (i = 0; i < atom_array_get_len (&pad->fragment_buffers); i++) {
+      for (i = 0; i < n_buffers; i++) {
         total_size +=
             gst_buffer_get_size (atom_array_index (&pad->fragment_buffers, i));
       }
@@ -4475,8 +4516,10 @@ flush:
       /* takes ownership */
       atom_moof_add_traf (moof, pad->traf);
       /* write the offset into the first 'trun'.  All other truns are assumed
-       * to follow on from this trun.  Skip over the mdat header (+12) */
-      atom_moof_copy_data (moof, &data, &size, &offset);
+       * to follow on from this trun.  Skip over the mdat header (+12).
+       * Only the size of the moof is needed for that, so it is serialised
+       * once with the final offset */
+      atom_moof_copy_data (moof, NULL, &size, &offset);
       first_trun = (AtomTRUN *) pad->traf->truns->data;
       atom_trun_set_offset (first_trun, offset + 12);
       pad->traf = NULL;
@@ -4490,34 +4533,30 @@ flush:
       if (pad->tfra)
         atom_tfra_update_offset (pad->tfra, qtmux->header_size);
 
-      GST_LOG_OBJECT (qtmux, "writing moof size %" G_GSIZE_FORMAT,
-          gst_buffer_get_size (moof_buffer));
-      ret =
-          gst_qt_mux_send_buffer (qtmux, moof_buffer, &qtmux->header_size,
-          FALSE);
-      if (ret != GST_FLOW_OK)
-        goto moof_send_error;
-
-      GST_LOG_OBJECT (qtmux, "writing %d buffers, total_size %d",
-          atom_array_get_len (&pad->fragment_buffers), total_size);
-
-      ret = gst_qt_mux_send_mdat_header (qtmux, &qtmux->header_size, total_size,
-          FALSE, FALSE);
+      GST_LOG_OBJECT (qtmux, "writing moof size %" G_GSIZE_FORMAT
+          " and %u buffers, total_size %u", gst_buffer_get_size (moof_buffer),
+          n_buffers, total_size);
+
+      /* the moof, the mdat header and the media buffers as they came in go
+       * out as one list per fragment. The moof is marked as delta unit if the
+       * fragment does not start with a sync sample, e.g. for CMAF chunks */
+      if (n_buffers > 0 &&
+          GST_BUFFER_FLAG_IS_SET (atom_array_index (&pad->fragment_buffers, 0),
+              GST_BUFFER_FLAG_DELTA_UNIT))
+        GST_BUFFER_FLAG_SET (moof_buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+      list = gst_buffer_list_new_sized (n_buffers + 2);
+      gst_buffer_list_add (list, moof_buffer);
+      gst_buffer_list_add (list, gst_qt_mux_create_mdat_header (qtmux,
+              total_size, FALSE));
+      for (i = 0; i < n_buffers; i++)
+        gst_buffer_list_add (list, atom_array_index (&pad->fragment_buffers,
+                i));
+      atom_array_clear (&pad->fragment_buffers);
+
+      ret = gst_qt_mux_send_buffer_list (qtmux, list, &qtmux->header_size);
       if (ret != GST_FLOW_OK)
-        goto mdat_header_send_error;
-
-      for (index = 0; index < atom_array_get_len (&pad->fragment_buffers);
-          index++) {
-        GST_DEBUG_OBJECT (qtmux, "sending fragment %p",
-            atom_array_index (&pad->fragment_buffers, index));
-        ret =
-            gst_qt_mux_send_buffer (qtmux,
-            atom_array_index (&pad->fragment_buffers, index),
-            &qtmux->header_size, FALSE);
-        if (ret != GST_FLOW_OK)
-          goto fragment_buf_send_error;
-      }
-
+        goto fragment_send_error;
     }
     atom_array_clear (&pad->fragment_buffers);
     qtmux->fragment_sequence++;
@@ -4635,28 +4674,9 @@ moof_send_error:
     return ret;
   }
 
-mdat_header_send_error:
+fragment_send_error:
   {
-    guint i;
-
-    GST_ERROR_OBJECT (qtmux, "Failed to send mdat header");
-    for (i = 0; i < atom_array_get_len (&pad->fragment_buffers); i++)
-      gst_buffer_unref (atom_array_index (&pad->fragment_buffers, i));
-    atom_array_clear (&pad->fragment_buffers);
-    gst_clear_buffer (&buf);
-
-    return ret;
-  }
-
-fragment_buf_send_error:
-  {
-    guint i;
-
     GST_ERROR_OBJECT (qtmux, "Failed to send fragment");
-    for (i = index + 1; i < atom_array_get_len (&pad->fragment_buffers); i++) {
-      gst_buffer_unref (atom_array_index (&pad->fragment_buffers, i));
-    }
-    atom_array_clear (&pad->fragment_buffers);
     gst_clear_buffer (&buf);
 
     return ret;
@@ -88,6 +88,10 @@
 /* if the sample index is larger than this, something is likely wrong */
 #define QTDEMUX_MAX_SAMPLE_INDEX_SIZE (200*1024*1024)
 
+/* the sample index only grows as far as the sample tables have been parsed,
+ * this many entries at a time. Seeking parses ahead in steps of the same size */
+#define QTDEMUX_SAMPLE_BATCH 4096
+
 /* For converting qt creation times to unix epoch times */
 #define QTDEMUX_SECONDS_PER_DAY (60 * 60 * 24)
 #define QTDEMUX_LEAP_YEARS_FROM_1904_TO_1970 17
@@ -300,6 +304,14 @@ GST_STATIC_PAD_TEMPLATE ("meta_%u",
     GST_PAD_SOMETIMES,
     GST_STATIC_CAPS_ANY);
 
+#define DEFAULT_PROBE FALSE
+
+enum
+{
+  PROP_0,
+  PROP_PROBE,
+};
+
 #define gst_qtdemux_parent_class parent_class
 G_DEFINE_TYPE (GstQTDemux, gst_qtdemux, GST_TYPE_ELEMENT);
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (qtdemux, "qtdemux",
@@ -307,6 +319,10 @@ GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (qtdemux, "qtdemux",
 
 static void gst_qtdemux_dispose (GObject * object);
 static void gst_qtdemux_finalize (GObject * object);
+static void gst_qtdemux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_qtdemux_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static guint32
 gst_qtdemux_find_index_linear (GstQTDemux * qtdemux, QtDemuxStream * str,
@@ -415,6 +431,24 @@ gst_qtdemux_class_init (GstQTDemuxClass * klass)
 
   gobject_class->dispose = gst_qtdemux_dispose;
   gobject_class->finalize = gst_qtdemux_finalize;
+  gobject_class->set_property = gst_qtdemux_set_property;
+  gobject_class->get_property = gst_qtdemux_get_property;
+
+  /**
+   * GstQTDemux:probe:
+   *
+   * Only output the first sync sample of every stream and then go EOS. The
+   * headers are parsed as usual, so this gives the stream information and
+   * e.g. a thumbnail of a file without reading any further sample data.
+   *
+   * Only has an effect when operating in pull mode.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_PROBE,
+      g_param_spec_boolean ("probe", "Probe",
+          "Only output the first sync sample of every stream (pull mode only)",
+          DEFAULT_PROBE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_qtdemux_change_state);
 #if 0
@@ -460,6 +494,8 @@ gst_qtdemux_init (GstQTDemux * qtdemux)
   qtdemux->flowcombiner = gst_flow_combiner_new ();
   g_mutex_init (&qtdemux->expose_lock);
 
+  qtdemux->probe = DEFAULT_PROBE;
+
   qtdemux->active_streams = g_ptr_array_new_with_free_func
       ((GDestroyNotify) gst_qtdemux_stream_unref);
   qtdemux->old_streams = g_ptr_array_new_with_free_func
@@ -500,6 +536,42 @@ gst_qtdemux_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_qtdemux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstQTDemux *qtdemux = GST_QTDEMUX (object);
+
+  switch (prop_id) {
+    case PROP_PROBE:
+      GST_OBJECT_LOCK (qtdemux);
+      qtdemux->probe = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (qtdemux);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_qtdemux_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstQTDemux *qtdemux = GST_QTDEMUX (object);
+
+  switch (prop_id) {
+    case PROP_PROBE:
+      GST_OBJECT_LOCK (qtdemux);
+      g_value_set_boolean (value, qtdemux->probe);
+      GST_OBJECT_UNLOCK (qtdemux);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_qtdemux_post_no_playable_stream_error (GstQTDemux * qtdemux)
 {
@@ -905,6 +977,19 @@ gst_qtdemux_find_index (GstQTDemux * qtdemux, QtDemuxStream * str,
 
 
 
+/* the sample to parse up to when sample @index is needed for a search. Parsing
+ * ahead saves taking the lock for every sample, but fragments are only pulled
+ * in once their samples are needed */
+static inline guint32
+qtdemux_parse_ahead_index (GstQTDemux * qtdemux, QtDemuxStream * str,
+    guint32 index)
+{
+  if (qtdemux->fragmented)
+    return index;
+
+  return MIN (index + QTDEMUX_SAMPLE_BATCH - 1, str->n_samples - 1);
+}
+
 /* find the index of the sample that includes the data for @media_offset using a
  * linear search
  *
@@ -923,16 +1008,17 @@ gst_qtdemux_find_index_for_given_media_offset_linear (GstQTDemux * qtdemux,
   if (media_offset == result->offset)
     return index;
 
-  result++;
   while (index < str->n_samples - 1) {
-    if (!qtdemux_parse_samples (qtdemux, str, index + 1))
+    if (index + 1 > str->stbl_index && !qtdemux_parse_samples (qtdemux, str,
+            qtdemux_parse_ahead_index (qtdemux, str, index + 1)))
       goto parse_failed;
 
+    /* the index may have grown */
+    result = str->samples + index + 1;
     if (media_offset < result->offset)
       break;
 
     index++;
-    result++;
   }
   return index;
 
@@ -972,8 +1058,14 @@ gst_qtdemux_find_index_linear (GstQTDemux * qtdemux, QtDemuxStream * str,
     index = gst_qtdemux_find_index (qtdemux, str, media_time);
     sample = str->samples + index;
   } else {
+    /* everything parsed so far is before the requested time, continue from
+     * there and parse ahead in batches */
+    if (str->stbl_index > 0)
+      index = str->stbl_index;
+
     while (index < str->n_samples - 1) {
-      if (!qtdemux_parse_samples (qtdemux, str, index + 1))
+      if (index + 1 > str->stbl_index && !qtdemux_parse_samples (qtdemux, str,
+              qtdemux_parse_ahead_index (qtdemux, str, index + 1)))
         goto parse_failed;
 
       sample = str->samples + index + 1;
@@ -1027,7 +1119,8 @@ gst_qtdemux_find_keyframe (GstQTDemux * qtdemux, QtDemuxStream * str,
 
   /* else search until we have a keyframe */
   while (new_index < str->n_samples) {
-    if (next && !qtdemux_parse_samples (qtdemux, str, new_index))
+    if (next && new_index > str->stbl_index && !qtdemux_parse_samples (qtdemux,
+            str, qtdemux_parse_ahead_index (qtdemux, str, new_index)))
       goto parse_failed;
 
     if (str->samples[new_index].keyframe)
@@ -1761,15 +1854,17 @@ gst_qtdemux_find_sample (GstQTDemux * qtdemux, gint64 byte_pos, gboolean fw,
     str = QTDEMUX_NTH_STREAM (qtdemux, iter);
     set_sample = !set;
 
+    /* samples that are not parsed yet have no size and are skipped, the
+     * index is only allocated up to the parsed samples */
     if (fw) {
       i = 0;
       inc = 1;
     } else {
-      i = str->n_samples - 1;
+      i = str->n_samples_allocated - 1;
       inc = -1;
     }
 
-    for (; (i >= 0) && (i < str->n_samples); i += inc) {
+    for (; (i >= 0) && (i < str->n_samples_allocated); i += inc) {
       if (str->samples[i].size == 0)
         continue;
 
@@ -2545,6 +2640,7 @@ gst_qtdemux_stream_flush_samples_data (QtDemuxStream * stream)
 {
   g_free (stream->samples);
   stream->samples = NULL;
+  stream->n_samples_allocated = 0;
   gst_qtdemux_stbl_free (stream);
 
   /* fragments */
@@ -3482,6 +3578,21 @@ qtdemux_parse_trun (GstQTDemux * qtdemux, GstByteReader * trun,
       new_n_samples >= QTDEMUX_MAX_SAMPLE_INDEX_SIZE / sizeof (QtDemuxSample))
     goto index_too_big;
 
+  /* the index only grows as far as the samples were parsed, parse the rest
+   * so that the new samples are appended after complete entries. Like in
+   * qtdemux_parse_trak(), prevent this from parsing the next moof */
+  if (stream->n_samples > 0 && stream->stbl_index + 1 < stream->n_samples) {
+    guint64 next_moof_offset = qtdemux->moof_offset;
+    gboolean parsed;
+
+    qtdemux->moof_offset = 0;
+    parsed = qtdemux_parse_samples (qtdemux, stream, stream->n_samples - 1);
+    qtdemux->moof_offset = next_moof_offset;
+    if (!parsed)
+      goto fail;
+  }
+  g_assert (stream->n_samples_allocated >= stream->n_samples);
+
   GST_DEBUG_OBJECT (qtdemux, "allocating n_samples %u * %u (%.2f MB)",
       new_n_samples, (guint) sizeof (QtDemuxSample),
       (new_n_samples) * sizeof (QtDemuxSample) / (1024.0 * 1024.0));
@@ -3496,6 +3607,7 @@ qtdemux_parse_trun (GstQTDemux * qtdemux, GstByteReader * trun,
         new_n_samples);
   if (stream->samples == NULL)
     goto out_of_memory;
+  stream->n_samples_allocated = new_n_samples;
 
   if (qtdemux->fragment_start != -1) {
     timestamp = GSTTIME_TO_QTSTREAMTIME (stream, qtdemux->fragment_start);
@@ -5941,8 +6053,8 @@ gst_qtdemux_sync_streams (GstQTDemux * demux)
         continue;
     } else {
       /* push mode is byte position based */
-      if (stream->n_samples &&
-          stream->samples[stream->n_samples - 1].offset >= demux->offset)
+      if (stream->n_samples && stream->n_samples_allocated == stream->n_samples
+          && stream->samples[stream->n_samples - 1].offset >= demux->offset)
         continue;
     }
 
@@ -7050,6 +7162,7 @@ gst_qtdemux_do_fragmented_seek (GstQTDemux * qtdemux)
     g_free (stream->samples);
     stream->samples = NULL;
     stream->n_samples = 0;
+    stream->n_samples_allocated = 0;
     stream->stbl_index = -1;    /* no samples have yet been parsed */
     stream->sample_index = -1;
 
@@ -7231,6 +7344,15 @@ gst_qtdemux_loop_state_movie (GstQTDemux * qtdemux)
     }
   }
 
+  /* When probing, video is only output from its first keyframe on, which
+   * then is the only sample */
+  if (G_UNLIKELY (qtdemux->probe) && stream->subtype == FOURCC_vide
+      && !keyframe) {
+    GST_LOG_OBJECT (qtdemux, "Skipping non-keyframe on track-id %u",
+        stream->track_id);
+    goto next;
+  }
+
   GST_DEBUG_OBJECT (qtdemux,
       "pushing from track-id %u, empty %d offset %" G_GUINT64_FORMAT
       ", size %d, dts=%" GST_TIME_FORMAT ", pts=%" GST_TIME_FORMAT
@@ -7401,6 +7523,12 @@ gst_qtdemux_loop_state_movie (GstQTDemux * qtdemux)
   stream->offset_in_sample += size;
   if (stream->offset_in_sample >= sample_size) {
     gst_qtdemux_advance_sample (qtdemux, stream);
+
+    if (G_UNLIKELY (qtdemux->probe)) {
+      GST_DEBUG_OBJECT (qtdemux, "probing, done with track-id %u",
+          stream->track_id);
+      stream->time_position = GST_CLOCK_TIME_NONE;
+    }
   }
   goto beach;
 
@@ -10597,7 +10725,7 @@ qtdemux_stbl_init (GstQTDemux * qtdemux, QtDemuxStream * stream, GNode * stbl)
   }
 
 done:
-  GST_DEBUG_OBJECT (qtdemux, "allocating n_samples %u * %u (%.2f MB)",
+  GST_DEBUG_OBJECT (qtdemux, "index of n_samples %u * %u (%.2f MB)",
       stream->n_samples, (guint) sizeof (QtDemuxSample),
       stream->n_samples * sizeof (QtDemuxSample) / (1024.0 * 1024.0));
 
@@ -10609,11 +10737,14 @@ done:
     return FALSE;
   }
 
+  /* the rest of the index is allocated as the samples get parsed */
   g_assert (stream->samples == NULL);
-  stream->samples = g_try_new0 (QtDemuxSample, stream->n_samples);
+  stream->n_samples_allocated = MIN (stream->n_samples, QTDEMUX_SAMPLE_BATCH);
+  stream->samples = g_try_new0 (QtDemuxSample, stream->n_samples_allocated);
   if (!stream->samples) {
     GST_WARNING_OBJECT (qtdemux, "failed to allocate %d samples",
-        stream->n_samples);
+        stream->n_samples_allocated);
+    stream->n_samples_allocated = 0;
     return FALSE;
   }
 
@@ -10639,6 +10770,39 @@ no_samples:
   }
 }
 
+/* make sure the sample index of @stream has room for sample @n, new entries
+ * are zeroed. Must be called with the object lock */
+static gboolean
+qtdemux_stream_reserve_samples (GstQTDemux * qtdemux, QtDemuxStream * stream,
+    guint32 n)
+{
+  QtDemuxSample *samples;
+  guint32 n_allocated;
+
+  if (G_LIKELY (n < stream->n_samples_allocated))
+    return TRUE;
+
+  n_allocated = MAX (n + 1, stream->n_samples_allocated + QTDEMUX_SAMPLE_BATCH);
+  n_allocated = MAX (n_allocated, stream->n_samples_allocated / 2 * 3);
+  n_allocated = MIN (n_allocated, stream->n_samples);
+
+  GST_DEBUG_OBJECT (qtdemux, "growing index from %u to %u samples",
+      stream->n_samples_allocated, n_allocated);
+
+  samples = g_try_renew (QtDemuxSample, stream->samples, n_allocated);
+  if (!samples) {
+    GST_WARNING_OBJECT (qtdemux, "failed to allocate %u samples", n_allocated);
+    return FALSE;
+  }
+  memset (samples + stream->n_samples_allocated, 0,
+      (n_allocated - stream->n_samples_allocated) * sizeof (QtDemuxSample));
+
+  stream->samples = samples;
+  stream->n_samples_allocated = n_allocated;
+
+  return TRUE;
+}
+
 /* collect samples from the next sample to be parsed up to sample @n for @stream
  * by reading the info from @stbl
  *
@@ -10676,6 +10840,9 @@ qtdemux_parse_samples (GstQTDemux * qtdemux, QtDemuxStream * stream, guint32 n)
     goto done;
   }
 
+  if (!qtdemux_stream_reserve_samples (qtdemux, stream, n))
+    goto out_of_memory;
+
   /* pointer to the sample table */
   samples = stream->samples;
 
@@ -10935,6 +11102,10 @@ done3:
 
           if (G_LIKELY (index > 0 && index <= n_samples)) {
             index -= 1;
+            /* sync samples past @n are marked ahead of parsing them */
+            if (!qtdemux_stream_reserve_samples (qtdemux, stream, index))
+              goto out_of_memory;
+            samples = stream->samples;
             samples[index].keyframe = TRUE;
             GST_DEBUG_OBJECT (qtdemux, "samples at %u is keyframe", index);
             /* and exit if we have enough samples */
@@ -10965,6 +11136,9 @@ done3:
 
             if (G_LIKELY (index > 0 && index <= n_samples)) {
               index -= 1;
+              if (!qtdemux_stream_reserve_samples (qtdemux, stream, index))
+                goto out_of_memory;
+              samples = stream->samples;
               samples[index].keyframe = TRUE;
               GST_DEBUG_OBJECT (qtdemux, "samples at %u is keyframe", index);
               /* and exit if we have enough samples */
@@ -10986,6 +11160,11 @@ done3:
   }
 
 ctts:
+  /* the index may have been reallocated while marking sync samples */
+  samples = stream->samples;
+  first = &samples[stream->stbl_index];
+  last = &samples[n];
+
   /* composition time to sample */
   if (stream->ctts_present == TRUE) {
     guint32 n_composition_times;
@@ -11074,6 +11253,13 @@ corrupt_file:
         (_("This file is corrupt and cannot be played.")), (NULL));
     return FALSE;
   }
+out_of_memory:
+  {
+    GST_OBJECT_UNLOCK (qtdemux);
+    GST_ELEMENT_ERROR (qtdemux, RESOURCE, FAILED, (NULL),
+        ("failed to allocate index of %u samples", n + 1));
+    return FALSE;
+  }
 }
 
 /* collect all segment info for @stream.
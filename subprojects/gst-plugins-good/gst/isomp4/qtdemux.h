@@ -178,6 +178,9 @@ struct _GstQTDemux {
   /* State for key_units trickmode */
   GstClockTime trickmode_interval;
 
+  /* only output the first sync sample of every stream, pull mode only */
+  gboolean probe;
+
   /* PUSH-BASED only: If the initial segment event, or a segment consequence of
    * a seek or incoming TIME segment from upstream needs to be pushed. This
    * variable is used instead of pushing the event directly because at that
@@ -406,6 +409,8 @@ struct _QtDemuxStream
   /* our samples */
   guint32 n_samples;
   QtDemuxSample *samples;
+  guint32 n_samples_allocated;  /* entries allocated in samples, grows while
+                                 * the sample tables are parsed */
   gboolean all_keyframe;        /* TRUE when all samples are keyframes (no stss) */
   guint32 n_samples_moof;       /* sample count in a moof */
   guint64 duration_moof;        /* duration in timescale of a moof, used for figure out
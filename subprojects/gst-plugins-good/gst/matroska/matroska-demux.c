@@ -94,6 +94,7 @@ enum
 #define DEFAULT_MAX_GAP_TIME           (2 * GST_SECOND)
 #define DEFAULT_MAX_BACKTRACK_DISTANCE 30
 #define INVALID_DATA_THRESHOLD         (2 * 1024 * 1024)
+#define BISECT_MIN_DISTANCE            (1024 * 1024)
 
 static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -332,6 +333,11 @@ gst_matroska_demux_reset (GstElement * element)
     demux->clusters = NULL;
   }
 
+  if (demux->cluster_times) {
+    g_array_unref (demux->cluster_times);
+    demux->cluster_times = NULL;
+  }
+
   g_list_foreach (demux->seek_parsed,
       (GFunc) gst_matroska_read_common_free_parsed_el, NULL);
   g_list_free (demux->seek_parsed);
@@ -2699,6 +2705,99 @@ gst_matroska_demux_scan_back_for_keyframe_cluster (GstMatroskaDemux * demux,
   return FALSE;
 }
 
+static gint
+gst_matroska_cluster_time_compare (GstMatroskaClusterTime * c1,
+    guint64 * offset)
+{
+  if (c1->offset < *offset)
+    return -1;
+  else if (c1->offset > *offset)
+    return 1;
+  else
+    return 0;
+}
+
+/* keep track of the clusters we came across in pull mode, so that seeking in
+ * files without cues does not need to bisect the whole file over and over */
+static void
+gst_matroska_demux_remember_cluster (GstMatroskaDemux * demux,
+    guint64 offset, GstClockTime time)
+{
+  GstMatroskaClusterTime entry;
+  GstMatroskaClusterTime *last, *next;
+
+  if (demux->streaming || demux->common.index)
+    return;
+
+  entry.offset = offset;
+  entry.time = time;
+
+  if (G_UNLIKELY (!demux->cluster_times)) {
+    demux->cluster_times = g_array_sized_new (FALSE, FALSE,
+        sizeof (GstMatroskaClusterTime), 100);
+  }
+
+  if (demux->cluster_times->len > 0) {
+    last = &g_array_index (demux->cluster_times, GstMatroskaClusterTime,
+        demux->cluster_times->len - 1);
+    if (offset <= last->offset) {
+      /* seeked backwards, keep the array sorted by offset */
+      next = gst_util_array_binary_search (demux->cluster_times->data,
+          demux->cluster_times->len, sizeof (GstMatroskaClusterTime),
+          (GCompareDataFunc) gst_matroska_cluster_time_compare,
+          GST_SEARCH_MODE_AFTER, &offset, NULL);
+      if (next->offset != offset) {
+        g_array_insert_val (demux->cluster_times,
+            next - (GstMatroskaClusterTime *) demux->cluster_times->data,
+            entry);
+      }
+      return;
+    }
+  }
+
+  g_array_append_val (demux->cluster_times, entry);
+}
+
+/* narrow down the initial search interval using the clusters we already know
+ * about, keeping apos/atime before and opos/otime after @time if possible */
+static void
+gst_matroska_demux_narrow_search (GstMatroskaDemux * demux, GstClockTime time,
+    gint64 * apos, GstClockTime * atime, gint64 * opos, GstClockTime * otime)
+{
+  gint64 lpos = *apos, hpos = *opos;
+  GstClockTime ltime = *atime, htime = *otime;
+  guint i;
+
+  if (!demux->cluster_times || time == GST_CLOCK_TIME_NONE)
+    return;
+
+  for (i = 0; i < demux->cluster_times->len; i++) {
+    GstMatroskaClusterTime *c = &g_array_index (demux->cluster_times,
+        GstMatroskaClusterTime, i);
+
+    if (c->time <= time) {
+      if (c->time >= ltime && (gint64) c->offset > lpos) {
+        lpos = c->offset;
+        ltime = c->time;
+      }
+    } else if (htime <= time || (gint64) c->offset < hpos) {
+      hpos = c->offset;
+      htime = c->time;
+    }
+  }
+
+  /* only use the cached clusters if they are consistent */
+  if (lpos <= hpos && ltime <= htime) {
+    GST_DEBUG_OBJECT (demux, "narrowed search to %" G_GINT64_FORMAT " (%"
+        GST_TIME_FORMAT ") - %" G_GINT64_FORMAT " (%" GST_TIME_FORMAT ")",
+        lpos, GST_TIME_ARGS (ltime), hpos, GST_TIME_ARGS (htime));
+    *apos = lpos;
+    *atime = ltime;
+    *opos = hpos;
+    *otime = htime;
+  }
+}
+
 /* bisect and scan through file for cluster starting before @time,
  * returns fake index entry with corresponding info on cluster */
 static GstMatroskaIndex *
@@ -2711,6 +2810,8 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   gint64 opos, newpos, current_offset;
   gint64 prev_cluster_offset = -1, current_cluster_offset, cluster_offset;
   gint64 apos, maxpos;
+  gint64 prev_width = -1;
+  gboolean midpoint;
   guint64 cluster_size = 0;
   GstFlowReturn ret;
   guint64 length;
@@ -2743,6 +2844,8 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   otime = MAX (otime, atime);
   opos = MAX (opos, apos);
 
+  gst_matroska_demux_narrow_search (demux, time, &apos, &atime, &opos, &otime);
+
   maxpos = gst_matroska_read_common_get_length (&demux->common);
 
   /* invariants;
@@ -2754,6 +2857,11 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
    * */
 
 retry:
+  /* fall back to plain bisection if interpolating did not at least halve
+   * the interval, e.g. because of very uneven bitrate */
+  midpoint = otime > time && prev_width != -1 && opos - apos > prev_width / 2;
+  prev_width = opos - apos;
+
   GST_LOG_OBJECT (demux,
       "apos: %" G_GUINT64_FORMAT ", atime: %" GST_TIME_FORMAT ", %"
       GST_TIME_FORMAT " in stream time, "
@@ -2775,6 +2883,8 @@ retry:
     }
   } else if (otime <= atime) {
     newpos = apos;
+  } else if (midpoint) {
+    newpos = apos + (opos - apos) / 2;
   } else {
     newpos = apos +
         gst_util_uint64_scale (opos - apos, time - atime, otime - atime);
@@ -2867,8 +2977,10 @@ retry:
           /* we are in between atime and otime => can bisect if worthwhile */
           if (prev_cluster_time != GST_CLOCK_TIME_NONE &&
               cluster_time > prev_cluster_time &&
-              (GST_CLOCK_DIFF (prev_cluster_time, cluster_time) * 10 <
-                  GST_CLOCK_DIFF (cluster_time, time))) {
+              ((GST_CLOCK_DIFF (prev_cluster_time, cluster_time) * 10 <
+                      GST_CLOCK_DIFF (cluster_time, time)) ||
+                  (cluster_offset > apos &&
+                      opos - cluster_offset > BISECT_MIN_DISTANCE))) {
             /* we moved at least one cluster forward,
              * and it looks like target is still far away,
              * let's estimate again */
@@ -5988,6 +6100,8 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
             goto parse_failed;
           GST_DEBUG_OBJECT (demux, "ClusterTimeCode: %" G_GUINT64_FORMAT, num);
           demux->cluster_time = num;
+          gst_matroska_demux_remember_cluster (demux, demux->cluster_offset,
+              demux->cluster_time * demux->common.time_scale);
           /* track last cluster */
           if (demux->cluster_offset > demux->last_cluster_offset) {
             demux->last_cluster_offset = demux->cluster_offset;
@@ -43,6 +43,11 @@ G_BEGIN_DECLS
 #define GST_IS_MATROSKA_DEMUX_CLASS(klass) \
   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_MATROSKA_DEMUX))
 
+typedef struct _GstMatroskaClusterTime {
+  guint64                  offset;
+  GstClockTime             time;
+} GstMatroskaClusterTime;
+
 typedef struct _GstMatroskaDemux {
   GstElement              parent;
 
@@ -75,6 +80,9 @@ typedef struct _GstMatroskaDemux {
 
   /* cluster positions (optional) */
   GArray                  *clusters;
+  /* clusters seen while playing/seeking in pull mode without index,
+   * sorted by offset, used to narrow down later seeks */
+  GArray                  *cluster_times;
 
   /* keeping track of playback position */
   GstClockTime             last_stop_end;
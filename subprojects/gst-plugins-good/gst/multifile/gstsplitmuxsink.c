@@ -44,7 +44,10 @@
  * asynchronously, and a new muxer and sink is created to continue with the
  * next fragment. For that reason, instead of muxer and sink objects, the
  * muxer-factory and sink-factory properties are used to construct the new
- * objects, together with muxer-properties and sink-properties.
+ * objects, together with muxer-properties and sink-properties. The
+ * max-finalizing-fragments property limits how many old muxers and sinks can
+ * be finishing at the same time. Once the limit is reached, starting the next
+ * fragment waits for one of them to be done.
  *
  * ## Example pipelines
  * |[
@@ -119,7 +122,8 @@ enum
   PROP_SINK_FACTORY,
   PROP_SINK_PRESET,
   PROP_SINK_PROPERTIES,
-  PROP_MUXERPAD_MAP
+  PROP_MUXERPAD_MAP,
+  PROP_MAX_FINALIZING_FRAGMENTS
 };
 
 #define DEFAULT_MAX_SIZE_TIME       0
@@ -133,6 +137,7 @@ enum
 #define DEFAULT_USE_ROBUST_MUXING FALSE
 #define DEFAULT_RESET_MUXER TRUE
 #define DEFAULT_ASYNC_FINALIZE FALSE
+#define DEFAULT_MAX_FINALIZING_FRAGMENTS 0
 #define DEFAULT_START_INDEX 0
 
 typedef struct _AsyncEosHelper
@@ -490,6 +495,26 @@ gst_splitmux_sink_class_init (GstSplitMuxSinkClass * klass)
           GST_TYPE_STRUCTURE,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstSplitMuxSink:max-finalizing-fragments
+   *
+   * Maximum number of fragments that can be finalizing asynchronously at the
+   * same time in `async-finalize=TRUE` mode. When the limit is reached,
+   * starting the next fragment waits until one of the previous muxers and
+   * sinks is done, instead of piling up more of them when they can't keep
+   * up. 0 means unlimited.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_MAX_FINALIZING_FRAGMENTS,
+      g_param_spec_uint ("max-finalizing-fragments",
+          "Max finalizing fragments",
+          "Maximum number of fragments finalizing at the same time "
+          "(0 = unlimited). Valid only for async-finalize = TRUE",
+          0, G_MAXUINT, DEFAULT_MAX_FINALIZING_FRAGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstSplitMuxSink::format-location:
    * @splitmux: the #GstSplitMuxSink
@@ -627,6 +652,7 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   splitmux->threshold_timecode_str = NULL;
 
   splitmux->async_finalize = DEFAULT_ASYNC_FINALIZE;
+  splitmux->max_finalizing_fragments = DEFAULT_MAX_FINALIZING_FRAGMENTS;
   splitmux->muxer_factory = g_strdup (DEFAULT_MUXER);
   splitmux->muxer_properties = NULL;
   splitmux->sink_factory = g_strdup (DEFAULT_SINK);
@@ -870,6 +896,13 @@ gst_splitmux_sink_set_property (GObject * object, guint prop_id,
       splitmux->async_finalize = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_MAX_FINALIZING_FRAGMENTS:
+      GST_SPLITMUX_LOCK (splitmux);
+      splitmux->max_finalizing_fragments = g_value_get_uint (value);
+      /* Wake up a fragment switch waiting on the previous limit */
+      GST_SPLITMUX_BROADCAST_OUTPUT (splitmux);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       if (splitmux->muxer_factory)
@@ -1017,6 +1050,11 @@ gst_splitmux_sink_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, splitmux->async_finalize);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_MAX_FINALIZING_FRAGMENTS:
+      GST_SPLITMUX_LOCK (splitmux);
+      g_value_set_uint (value, splitmux->max_finalizing_fragments);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       g_value_set_string (value, splitmux->muxer_factory);
@@ -2161,9 +2199,24 @@ static GstFlowReturn
 start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
 {
   GstElement *muxer, *sink;
+  gboolean finished;
 
   g_assert (ctx->is_reference);
 
+  /* Don't let old muxers and sinks pile up if they can't finalize their
+   * files as fast as new fragments are started */
+  while (splitmux->async_finalize && splitmux->max_finalizing_fragments > 0
+      && splitmux->n_finalizing_fragments >=
+      splitmux->max_finalizing_fragments) {
+    if (ctx->flushing
+        || splitmux->output_state == SPLITMUX_OUTPUT_STATE_STOPPED)
+      return GST_FLOW_FLUSHING;
+
+    GST_DEBUG_OBJECT (splitmux, "Waiting for one of the %u finalizing "
+        "fragments to be done", splitmux->n_finalizing_fragments);
+    GST_SPLITMUX_WAIT_OUTPUT (splitmux);
+  }
+
   /* 1 change to new file */
   splitmux->switching_fragment = TRUE;
 
@@ -2234,16 +2287,25 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
       g_list_foreach (splitmux->contexts, (GFunc) relink_context, splitmux);
       gst_element_link (new_muxer, new_sink);
 
+      GST_SPLITMUX_LOCK (splitmux);
+      finished = FALSE;
       if (g_object_get_qdata ((GObject *) sink, EOS_FROM_US)) {
         if (GPOINTER_TO_INT (g_object_get_qdata ((GObject *) sink,
                     EOS_FROM_US)) == 2) {
-          _lock_and_set_to_null (muxer, splitmux);
-          _lock_and_set_to_null (sink, splitmux);
+          finished = TRUE;
         } else {
           g_object_set_qdata ((GObject *) sink, EOS_FROM_US,
               GINT_TO_POINTER (2));
+          /* Removed from the bus handler once its EOS arrives */
+          splitmux->n_finalizing_fragments++;
         }
       }
+      GST_SPLITMUX_UNLOCK (splitmux);
+
+      if (finished) {
+        _lock_and_set_to_null (muxer, splitmux);
+        _lock_and_set_to_null (sink, splitmux);
+      }
       gst_object_unref (muxer);
       gst_object_unref (sink);
       muxer = new_muxer;
@@ -2399,6 +2461,10 @@ bus_handler (GstBin * bin, GstMessage * message)
                 (GstElementCallAsyncFunc) _lock_and_set_to_null,
                 gst_object_ref (splitmux), gst_object_unref);
             gst_object_unref (muxer);
+
+            if (splitmux->n_finalizing_fragments > 0)
+              splitmux->n_finalizing_fragments--;
+            GST_SPLITMUX_BROADCAST_OUTPUT (splitmux);
           } else {
             g_object_set_qdata ((GObject *) sink, EOS_FROM_US,
                 GINT_TO_POINTER (2));
@@ -4151,6 +4217,8 @@ gst_splitmux_sink_reset (GstSplitMuxSink * splitmux)
 
   splitmux->out_fragment_start_runts = splitmux->out_start_runts =
       GST_CLOCK_STIME_NONE;
+
+  splitmux->n_finalizing_fragments = 0;
 }
 
 static GstStateChangeReturn
@@ -251,6 +251,9 @@ struct _GstSplitMuxSink
   gchar *sink_factory;
   gchar *sink_preset;
   GstStructure *sink_properties;
+  guint max_finalizing_fragments;
+  /* Old muxer/sink pairs still finishing their fragment */
+  guint n_finalizing_fragments;
 
   GstStructure *muxerpad_map;
 };
@@ -131,6 +131,7 @@ static gboolean gst_rtp_h264_pay_src_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
 
 static void gst_rtp_h264_pay_reset_bundle (GstRtpH264Pay * rtph264pay);
+static GstFlowReturn gst_rtp_h264_pay_push_pending (GstRtpH264Pay * rtph264pay);
 
 #define gst_rtp_h264_pay_parent_class parent_class
 G_DEFINE_TYPE (GstRtpH264Pay, gst_rtp_h264_pay, GST_TYPE_RTP_BASE_PAYLOAD);
@@ -263,6 +264,7 @@ gst_rtp_h264_pay_finalize (GObject * object)
 
   g_object_unref (rtph264pay->adapter);
   gst_rtp_h264_pay_reset_bundle (rtph264pay);
+  g_clear_pointer (&rtph264pay->pending, gst_buffer_list_unref);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1037,6 +1039,46 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
       end_of_au, delta_unit, discont, nal_header);
 }
 
+static GstFlowReturn
+gst_rtp_h264_pay_push_pending (GstRtpH264Pay * rtph264pay)
+{
+  GstBufferList *list = rtph264pay->pending;
+
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  rtph264pay->pending = NULL;
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+
+  return gst_rtp_base_payload_push_list (GST_RTP_BASE_PAYLOAD (rtph264pay),
+      list);
+}
+
+/* Makes sure rtph264pay->pending can collect packets with @pts. All packets
+ * of a list get the same RTP timestamp, so the pending packets are pushed
+ * first when their timestamp differs. If that push fails, no new list is
+ * started. */
+static GstFlowReturn
+gst_rtp_h264_pay_prepare_pending (GstRtpH264Pay * rtph264pay, GstClockTime pts)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (rtph264pay->pending &&
+      GST_BUFFER_PTS (gst_buffer_list_get (rtph264pay->pending, 0)) != pts) {
+    GST_LOG_OBJECT (rtph264pay, "timestamp changed, pushing pending packets");
+    ret = gst_rtp_h264_pay_push_pending (rtph264pay);
+  }
+
+  if (ret == GST_FLOW_OK && rtph264pay->pending == NULL)
+    rtph264pay->pending = gst_buffer_list_new ();
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
     GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean end_of_au,
@@ -1045,9 +1087,8 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   GstRtpH264Pay *rtph264pay;
   guint mtu, size, max_fragment_size, max_fragments, ii, pos;
   GstBuffer *outbuf;
-  guint8 *payload;
-  GstBufferList *list = NULL;
-  GstRTPBuffer rtp = { NULL };
+  GstBufferList *list;
+  GstFlowReturn ret;
 
   rtph264pay = GST_RTP_H264_PAY (basepayload);
   mtu = GST_RTP_BASE_PAYLOAD_MTU (rtph264pay);
@@ -1067,12 +1108,19 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   /* We keep 2 bytes for FU indicator and FU Header */
   max_fragment_size = gst_rtp_buffer_calc_payload_len (mtu - 2, 0, 0);
   max_fragments = (size + max_fragment_size - 2) / max_fragment_size;
-  list = gst_buffer_list_new_sized (max_fragments);
+
+  ret = gst_rtp_h264_pay_prepare_pending (rtph264pay, pts);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (paybuf);
+    return ret;
+  }
+  list = rtph264pay->pending;
 
   /* Start at the NALU payload */
   for (pos = 1, ii = 0; pos < size; pos += max_fragment_size, ii++) {
     guint remaining, fragment_size;
     gboolean first_fragment, last_fragment;
+    guint8 header[2];
 
     remaining = size - pos;
     fragment_size = MIN (remaining, max_fragment_size);
@@ -1083,36 +1131,20 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
         "creating FU-A packet %u/%u, size %u",
         ii + 1, max_fragments, fragment_size);
 
-    /* use buffer lists
-     * create buffer without payload containing only the RTP header
-     * (memory block at index 0) */
-    outbuf = gst_rtp_base_payload_allocate_output_buffer (basepayload, 2, 0, 0);
-
-    gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
-
-    GST_BUFFER_DTS (outbuf) = dts;
-    GST_BUFFER_PTS (outbuf) = pts;
-    payload = gst_rtp_buffer_get_payload (&rtp);
-
-    /* If it's the last fragment and the end of this au, mark the end of
-     * slice */
-    gst_rtp_buffer_set_marker (&rtp, last_fragment && end_of_au);
-    if (last_fragment && end_of_au)
-      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_MARKER);
-
     /* FU indicator */
-    payload[0] = (nal_header & 0x60) | FU_A_TYPE_ID;
+    header[0] = (nal_header & 0x60) | FU_A_TYPE_ID;
 
     /* FU Header */
-    payload[1] = (first_fragment << 7) | (last_fragment << 6) |
+    header[1] = (first_fragment << 7) | (last_fragment << 6) |
         (nal_header & 0x1f);
 
-    gst_rtp_buffer_unmap (&rtp);
+    /* If it's the last fragment and the end of this au, mark the end of
+     * slice */
+    outbuf = gst_rtp_video_fragment_add (basepayload, list, paybuf, pos,
+        fragment_size, header, sizeof (header), last_fragment && end_of_au);
 
-    /* insert payload memory block */
-    gst_rtp_copy_video_meta (rtph264pay, outbuf, paybuf);
-    gst_buffer_copy_into (outbuf, paybuf, GST_BUFFER_COPY_MEMORY, pos,
-        fragment_size);
+    GST_BUFFER_DTS (outbuf) = dts;
+    GST_BUFFER_PTS (outbuf) = pts;
 
     if (!delta_unit)
       /* Only the first packet sent should not have the flag */
@@ -1125,16 +1157,13 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
       /* Only the first packet sent should have the flag */
       discont = FALSE;
     }
-
-    /* add the buffer to the buffer list */
-    gst_buffer_list_add (list, outbuf);
   }
 
   GST_DEBUG_OBJECT (rtph264pay,
-      "sending FU-A fragments: n=%u datasize=%u mtu=%u", ii, size, mtu);
+      "queued FU-A fragments: n=%u datasize=%u mtu=%u", ii, size, mtu);
 
   gst_buffer_unref (paybuf);
-  return gst_rtp_base_payload_push_list (basepayload, list);
+  return GST_FLOW_OK;
 }
 
 static GstFlowReturn
@@ -1145,6 +1174,7 @@ gst_rtp_h264_pay_payload_nal_single (GstRTPBasePayload * basepayload,
   GstRtpH264Pay *rtph264pay;
   GstBuffer *outbuf;
   GstRTPBuffer rtp = { NULL };
+  GstFlowReturn ret;
 
   rtph264pay = GST_RTP_H264_PAY (basepayload);
 
@@ -1175,8 +1205,15 @@ gst_rtp_h264_pay_payload_nal_single (GstRTPBasePayload * basepayload,
   gst_rtp_copy_video_meta (rtph264pay, outbuf, paybuf);
   outbuf = gst_buffer_append (outbuf, paybuf);
 
-  /* push the buffer to the next element */
-  return gst_rtp_base_payload_push (basepayload, outbuf);
+  /* pushed together with the other packets of the input buffer */
+  ret = gst_rtp_h264_pay_prepare_pending (rtph264pay, pts);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (outbuf);
+    return ret;
+  }
+  gst_buffer_list_add (rtph264pay->pending, outbuf);
+
+  return GST_FLOW_OK;
 }
 
 static void
@@ -1381,7 +1418,7 @@ out:
 }
 
 static GstFlowReturn
-gst_rtp_h264_pay_handle_buffer (GstRTPBasePayload * basepayload,
+gst_rtp_h264_pay_payload_buffer (GstRTPBasePayload * basepayload,
     GstBuffer * buffer)
 {
   GstRtpH264Pay *rtph264pay;
@@ -1708,6 +1745,23 @@ caps_rejected:
   }
 }
 
+static GstFlowReturn
+gst_rtp_h264_pay_handle_buffer (GstRTPBasePayload * basepayload,
+    GstBuffer * buffer)
+{
+  GstRtpH264Pay *rtph264pay = GST_RTP_H264_PAY (basepayload);
+  GstFlowReturn ret, push_ret;
+
+  ret = gst_rtp_h264_pay_payload_buffer (basepayload, buffer);
+
+  /* push all packets created from this buffer at once */
+  push_ret = gst_rtp_h264_pay_push_pending (rtph264pay);
+  if (ret == GST_FLOW_OK)
+    ret = push_ret;
+
+  return ret;
+}
+
 static gboolean
 gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
 {
@@ -1720,6 +1774,7 @@ gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph264pay->adapter);
       gst_rtp_h264_pay_reset_bundle (rtph264pay);
+      g_clear_pointer (&rtph264pay->pending, gst_buffer_list_unref);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1738,12 +1793,16 @@ gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
        */
       gst_rtp_h264_pay_handle_buffer (payload, NULL);
       ret = gst_rtp_h264_pay_send_bundle (rtph264pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h264_pay_push_pending (rtph264pay);
       break;
     }
     case GST_EVENT_STREAM_START:
       GST_DEBUG_OBJECT (rtph264pay, "New stream detected => Clear SPS and PPS");
       gst_rtp_h264_pay_clear_sps_pps (rtph264pay);
       ret = gst_rtp_h264_pay_send_bundle (rtph264pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h264_pay_push_pending (rtph264pay);
       break;
     default:
       break;
@@ -1768,6 +1827,7 @@ gst_rtp_h264_pay_change_state (GstElement * element, GstStateChange transition)
       rtph264pay->send_spspps = FALSE;
       gst_adapter_clear (rtph264pay->adapter);
       gst_rtp_h264_pay_reset_bundle (rtph264pay);
+      g_clear_pointer (&rtph264pay->pending, gst_buffer_list_unref);
       break;
     default:
       break;
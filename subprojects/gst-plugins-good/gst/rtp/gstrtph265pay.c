@@ -164,6 +164,7 @@ static gboolean gst_rtp_h265_pay_src_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
 
 static void gst_rtp_h265_pay_reset_bundle (GstRtpH265Pay * rtph265pay);
+static GstFlowReturn gst_rtp_h265_pay_push_pending (GstRtpH265Pay * rtph265pay);
 
 #define gst_rtp_h265_pay_parent_class parent_class
 G_DEFINE_TYPE (GstRtpH265Pay, gst_rtp_h265_pay, GST_TYPE_RTP_BASE_PAYLOAD);
@@ -287,6 +288,7 @@ gst_rtp_h265_pay_finalize (GObject * object)
   g_object_unref (rtph265pay->adapter);
 
   gst_rtp_h265_pay_reset_bundle (rtph265pay);
+  g_clear_pointer (&rtph265pay->pending, gst_buffer_list_unref);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1129,14 +1131,61 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
   return ret;
 }
 
+static GstFlowReturn
+gst_rtp_h265_pay_push_pending (GstRtpH265Pay * rtph265pay)
+{
+  GstBufferList *list = rtph265pay->pending;
+
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  rtph265pay->pending = NULL;
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+
+  return gst_rtp_base_payload_push_list (GST_RTP_BASE_PAYLOAD (rtph265pay),
+      list);
+}
+
+/* Makes sure rtph265pay->pending can collect packets with @pts. All packets
+ * of a list get the same RTP timestamp, so the pending packets are pushed
+ * first when their timestamp differs. If that push fails, no new list is
+ * started. */
+static GstFlowReturn
+gst_rtp_h265_pay_prepare_pending (GstRtpH265Pay * rtph265pay, GstClockTime pts)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (rtph265pay->pending &&
+      GST_BUFFER_PTS (gst_buffer_list_get (rtph265pay->pending, 0)) != pts) {
+    GST_LOG_OBJECT (rtph265pay, "timestamp changed, pushing pending packets");
+    ret = gst_rtp_h265_pay_push_pending (rtph265pay);
+  }
+
+  if (ret == GST_FLOW_OK && rtph265pay->pending == NULL)
+    rtph265pay->pending = gst_buffer_list_new ();
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_h265_pay_payload_nal_single (GstRTPBasePayload * basepayload,
     GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean marker,
     gboolean delta_unit)
 {
-  GstBufferList *outlist;
+  GstRtpH265Pay *rtph265pay = (GstRtpH265Pay *) basepayload;
   GstBuffer *outbuf;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstFlowReturn ret;
+
+  ret = gst_rtp_h265_pay_prepare_pending (rtph265pay, pts);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (paybuf);
+    return ret;
+  }
 
   /* use buffer lists
    * create buffer without payload containing only the RTP header
@@ -1158,17 +1207,14 @@ gst_rtp_h265_pay_payload_nal_single (GstRTPBasePayload * basepayload,
 
   /* insert payload memory block */
   gst_rtp_copy_video_meta (basepayload, outbuf, paybuf);
-  outbuf = gst_buffer_append (outbuf, paybuf);
-
-  outlist = gst_buffer_list_new ();
+  gst_rtp_buffer_unmap (&rtp);
 
-  /* add the buffer to the buffer list */
-  gst_buffer_list_add (outlist, outbuf);
+  outbuf = gst_buffer_append (outbuf, paybuf);
 
-  gst_rtp_buffer_unmap (&rtp);
+  /* pushed together with the other packets of the input buffer */
+  gst_buffer_list_add (rtph265pay->pending, outbuf);
 
-  /* push the list to the next element in the pipe */
-  return gst_rtp_base_payload_push_list (basepayload, outlist);
+  return GST_FLOW_OK;
 }
 
 static GstFlowReturn
@@ -1181,9 +1227,6 @@ gst_rtp_h265_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   GstFlowReturn ret;
   guint max_fragment_size, ii, pos;
   GstBuffer *outbuf;
-  GstBufferList *outlist = NULL;
-  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
-  guint8 *payload;
 
   if (gst_rtp_buffer_calc_packet_len (size, 0, 0) < mtu) {
     GST_DEBUG_OBJECT (rtph265pay,
@@ -1202,11 +1245,16 @@ gst_rtp_h265_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   /* We keep 3 bytes for PayloadHdr and FU Header */
   max_fragment_size = gst_rtp_buffer_calc_payload_len (mtu - 3, 0, 0);
 
-  outlist = gst_buffer_list_new ();
+  ret = gst_rtp_h265_pay_prepare_pending (rtph265pay, pts);
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (paybuf);
+    return ret;
+  }
 
   for (pos = 2, ii = 0; pos < size; pos += max_fragment_size, ii++) {
     guint remaining, fragment_size;
     gboolean first_fragment, last_fragment;
+    guint8 header[3];
 
     remaining = size - pos;
     fragment_size = MIN (remaining, max_fragment_size);
@@ -1218,51 +1266,33 @@ gst_rtp_h265_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
         fragment_size, ii, first_fragment ? "first" : "",
         last_fragment ? "last" : "");
 
-    /* use buffer lists
-     * create buffer without payload containing only the RTP header
-     * (memory block at index 0), and with space for PayloadHdr and FU header */
-    outbuf = gst_rtp_base_payload_allocate_output_buffer (basepayload, 3, 0, 0);
-
-    gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
-
-    GST_BUFFER_DTS (outbuf) = dts;
-    GST_BUFFER_PTS (outbuf) = pts;
-    payload = gst_rtp_buffer_get_payload (&rtp);
-
     /* PayloadHdr (type = FU_TYPE_ID (49)) */
-    payload[0] = (nal_header[0] & 0x81) | (FU_TYPE_ID << 1);
-    payload[1] = nal_header[1];
-
-    /* If it's the last fragment and the end of this au, mark the end of
-     * slice */
-    gst_rtp_buffer_set_marker (&rtp, last_fragment && marker);
-    if (last_fragment && marker)
-      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_MARKER);
+    header[0] = (nal_header[0] & 0x81) | (FU_TYPE_ID << 1);
+    header[1] = nal_header[1];
 
     /* FU Header */
-    payload[2] = (first_fragment << 7) | (last_fragment << 6) |
+    header[2] = (first_fragment << 7) | (last_fragment << 6) |
         (nal_type & 0x3f);
 
-    gst_rtp_buffer_unmap (&rtp);
+    /* If it's the last fragment and the end of this au, mark the end of
+     * slice */
+    outbuf = gst_rtp_video_fragment_add (basepayload, rtph265pay->pending,
+        paybuf, pos, fragment_size, header, sizeof (header),
+        last_fragment && marker);
+
+    GST_BUFFER_DTS (outbuf) = dts;
+    GST_BUFFER_PTS (outbuf) = pts;
 
-    /* insert payload memory block */
-    gst_rtp_copy_video_meta (rtph265pay, outbuf, paybuf);
-    gst_buffer_copy_into (outbuf, paybuf, GST_BUFFER_COPY_MEMORY, pos,
-        fragment_size);
     if (!delta_unit)
       /* only the first packet sent should not have the flag */
       delta_unit = TRUE;
     else
       GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT);
-
-    /* add the buffer to the buffer list */
-    gst_buffer_list_add (outlist, outbuf);
   }
 
-  ret = gst_rtp_base_payload_push_list (basepayload, outlist);
   gst_buffer_unref (paybuf);
 
-  return ret;
+  return GST_FLOW_OK;
 }
 
 static GstFlowReturn
@@ -1464,7 +1494,7 @@ out:
 }
 
 static GstFlowReturn
-gst_rtp_h265_pay_handle_buffer (GstRTPBasePayload * basepayload,
+gst_rtp_h265_pay_payload_buffer (GstRTPBasePayload * basepayload,
     GstBuffer * buffer)
 {
   GstRtpH265Pay *rtph265pay;
@@ -1757,6 +1787,23 @@ caps_rejected:
   }
 }
 
+static GstFlowReturn
+gst_rtp_h265_pay_handle_buffer (GstRTPBasePayload * basepayload,
+    GstBuffer * buffer)
+{
+  GstRtpH265Pay *rtph265pay = GST_RTP_H265_PAY (basepayload);
+  GstFlowReturn ret, push_ret;
+
+  ret = gst_rtp_h265_pay_payload_buffer (basepayload, buffer);
+
+  /* push all packets created from this buffer at once */
+  push_ret = gst_rtp_h265_pay_push_pending (rtph265pay);
+  if (ret == GST_FLOW_OK)
+    ret = push_ret;
+
+  return ret;
+}
+
 static gboolean
 gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
 {
@@ -1769,6 +1816,7 @@ gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph265pay->adapter);
       gst_rtp_h265_pay_reset_bundle (rtph265pay);
+      g_clear_pointer (&rtph265pay->pending, gst_buffer_list_unref);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1787,6 +1835,8 @@ gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
        */
       gst_rtp_h265_pay_handle_buffer (payload, NULL);
       ret = gst_rtp_h265_pay_send_bundle (rtph265pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h265_pay_push_pending (rtph265pay);
 
       break;
     }
@@ -1818,6 +1868,7 @@ gst_rtp_h265_pay_change_state (GstElement * element, GstStateChange transition)
       rtph265pay->send_vps_sps_pps = FALSE;
       gst_adapter_clear (rtph265pay->adapter);
       gst_rtp_h265_pay_reset_bundle (rtph265pay);
+      g_clear_pointer (&rtph265pay->pending, gst_buffer_list_unref);
       break;
     default:
       break;
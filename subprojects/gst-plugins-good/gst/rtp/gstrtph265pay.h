@@ -81,6 +81,9 @@ struct _GstRtpH265Pay
   guint bundle_size;
   gboolean bundle_contains_vcl_or_suffix;
   GstRTPH265AggregateMode aggregate_mode;
+
+  /* packets of the current input buffer, pushed as one list */
+  GstBufferList *pending;
 };
 
 struct _GstRtpH265PayClass
@@ -19,6 +19,9 @@
 
 #include "gstrtputils.h"
 
+#include <string.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
 typedef struct
 {
   GstElement *element;
@@ -72,6 +75,45 @@ gst_rtp_copy_video_meta (gpointer element, GstBuffer * outbuf,
   gst_rtp_copy_meta (element, outbuf, inbuf, rtp_quark_meta_tag_video);
 }
 
+/* Appends a packet to @list with a @header_len bytes payload header copied
+ * from @header, followed by @size bytes of @frame starting at @offset. Only
+ * the header is allocated, the payload shares the memory of @frame. This lets
+ * video payloaders build all packets of a frame in one pass and push them
+ * with gst_rtp_base_payload_push_list().
+ *
+ * Returns: (transfer none): the new packet, for the caller to timestamp and
+ * flag. */
+GstBuffer *
+gst_rtp_video_fragment_add (GstRTPBasePayload * payload, GstBufferList * list,
+    GstBuffer * frame, gsize offset, gsize size, const guint8 * header,
+    guint header_len, gboolean marker)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *outbuf;
+
+  outbuf =
+      gst_rtp_base_payload_allocate_output_buffer (payload, header_len, 0, 0);
+
+  if (header_len > 0 || marker) {
+    gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
+    if (header_len > 0)
+      memcpy (gst_rtp_buffer_get_payload (&rtp), header, header_len);
+    gst_rtp_buffer_set_marker (&rtp, marker);
+    gst_rtp_buffer_unmap (&rtp);
+  }
+
+  if (marker)
+    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_MARKER);
+
+  gst_rtp_copy_video_meta (payload, outbuf, frame);
+  if (size > 0)
+    gst_buffer_copy_into (outbuf, frame, GST_BUFFER_COPY_MEMORY, offset, size);
+
+  gst_buffer_list_add (list, outbuf);
+
+  return outbuf;
+}
+
 void
 gst_rtp_copy_audio_meta (gpointer element, GstBuffer * outbuf,
     GstBuffer * inbuf)
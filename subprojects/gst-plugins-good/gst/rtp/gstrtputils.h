@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbitreader.h>
+#include <gst/rtp/gstrtpbasepayload.h>
 
 G_BEGIN_DECLS
 
@@ -43,6 +44,12 @@ void gst_rtp_drop_non_audio_meta (gpointer element, GstBuffer * buf);
 G_GNUC_INTERNAL
 void gst_rtp_drop_non_video_meta (gpointer element, GstBuffer * buf);
 
+G_GNUC_INTERNAL
+GstBuffer * gst_rtp_video_fragment_add (GstRTPBasePayload * payload, GstBufferList * list,
+                                        GstBuffer * frame, gsize offset, gsize size,
+                                        const guint8 * header, guint header_len,
+                                        gboolean marker);
+
 G_GNUC_INTERNAL
 gboolean gst_rtp_read_golomb (GstBitReader * br, guint32 * value);
 
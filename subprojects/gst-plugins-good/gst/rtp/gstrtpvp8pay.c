@@ -491,21 +491,14 @@ gst_rtp_vp8_calc_header_len (GstRtpVP8Pay * self)
   return len + 1;               /* computed + fixed size header */
 }
 
+/* Maximum size of the payload descriptor written below */
+#define VP8_MAX_HEADER_LEN 6
+
 /* When growing the vp8 header keep max payload len calculation in sync */
-static GstBuffer *
-gst_rtp_vp8_create_header_buffer (GstRtpVP8Pay * self, guint8 partid,
-    gboolean start, gboolean mark, GstBuffer * in, GstCustomMeta * meta)
+static void
+gst_rtp_vp8_write_header (GstRtpVP8Pay * self, guint8 * p, guint8 partid,
+    gboolean start, GstBuffer * in, GstCustomMeta * meta)
 {
-  GstBuffer *out;
-  guint8 *p;
-  GstRTPBuffer rtpbuffer = GST_RTP_BUFFER_INIT;
-
-  out =
-      gst_rtp_base_payload_allocate_output_buffer (GST_RTP_BASE_PAYLOAD_CAST
-      (self), gst_rtp_vp8_calc_header_len (self), 0, 0);
-  gst_rtp_buffer_map (out, GST_MAP_READWRITE, &rtpbuffer);
-  p = gst_rtp_buffer_get_payload (&rtpbuffer);
-
   /* X=0,R=0,N=0,S=start,PartID=partid */
   p[0] = (start << 4) | partid;
   if (GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_DROPPABLE)) {
@@ -573,17 +566,6 @@ gst_rtp_vp8_create_header_buffer (GstRtpVP8Pay * self, guint8 partid,
       p[index + 1] = ((temporal_layer << 6) | (layer_sync << 5)) & 0xFF;
     }
   }
-
-  gst_rtp_buffer_set_marker (&rtpbuffer, mark);
-  if (mark)
-    GST_BUFFER_FLAG_SET (out, GST_BUFFER_FLAG_MARKER);
-
-  gst_rtp_buffer_unmap (&rtpbuffer);
-
-  GST_BUFFER_DURATION (out) = GST_BUFFER_DURATION (in);
-  GST_BUFFER_PTS (out) = GST_BUFFER_PTS (in);
-
-  return out;
 }
 
 static gboolean
@@ -613,8 +595,7 @@ gst_rtp_vp8_payload_next (GstRtpVP8Pay * self, GstBufferList * list,
     GstCustomMeta * meta, gboolean delta_unit)
 {
   guint partition;
-  GstBuffer *header;
-  GstBuffer *sub;
+  guint8 header[VP8_MAX_HEADER_LEN];
   GstBuffer *out;
   gboolean mark;
   gboolean start;
@@ -641,20 +622,18 @@ gst_rtp_vp8_payload_next (GstRtpVP8Pay * self, GstBufferList * list,
 
   mark = (remaining == available);
   /* whole set of partitions, payload them and done */
-  header = gst_rtp_vp8_create_header_buffer (self, partition,
-      start, mark, buffer, meta);
-  sub = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_ALL, offset, available);
+  gst_rtp_vp8_write_header (self, header, partition, start, buffer, meta);
+  out = gst_rtp_video_fragment_add (GST_RTP_BASE_PAYLOAD_CAST (self), list,
+      buffer, offset, available, header, gst_rtp_vp8_calc_header_len (self),
+      mark);
+  gst_rtp_vp8_drop_vp8_meta (self, out);
 
-  gst_rtp_copy_video_meta (self, header, buffer);
-  gst_rtp_vp8_drop_vp8_meta (self, header);
-
-  out = gst_buffer_append (header, sub);
+  GST_BUFFER_DURATION (out) = GST_BUFFER_DURATION (buffer);
+  GST_BUFFER_PTS (out) = GST_BUFFER_PTS (buffer);
 
   if (delta_unit)
     GST_BUFFER_FLAG_SET (out, GST_BUFFER_FLAG_DELTA_UNIT);
 
-  gst_buffer_list_insert (list, -1, out);
-
   return available;
 }
 
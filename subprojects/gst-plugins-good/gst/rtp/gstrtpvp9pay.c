@@ -445,22 +445,17 @@ gst_rtp_vp9_calc_header_len (GstRtpVP9Pay * self, gboolean start)
 
 **/
 
+/* Maximum size of the payload descriptor written below */
+#define VP9_MAX_HEADER_LEN 11
+
 /* When growing the vp9 header keep max payload len calculation in sync */
-static GstBuffer *
-gst_rtp_vp9_create_header_buffer (GstRtpVP9Pay * self,
-    gboolean start, gboolean mark, GstBuffer * in)
+static guint
+gst_rtp_vp9_write_header (GstRtpVP9Pay * self, guint8 * p, gboolean start,
+    gboolean mark)
 {
-  GstBuffer *out;
-  guint8 *p;
-  GstRTPBuffer rtpbuffer = GST_RTP_BUFFER_INIT;
   guint off = 1;
   guint hdrlen = gst_rtp_vp9_calc_header_len (self, start);
 
-  out =
-      gst_rtp_base_payload_allocate_output_buffer (GST_RTP_BASE_PAYLOAD (self),
-      hdrlen, 0, 0);
-  gst_rtp_buffer_map (out, GST_MAP_READWRITE, &rtpbuffer);
-  p = gst_rtp_buffer_get_payload (&rtpbuffer);
   p[0] = 0x0;
 
   if (self->picture_id_mode != VP9_PAY_NO_PICTURE_ID) {
@@ -498,16 +493,7 @@ gst_rtp_vp9_create_header_buffer (GstRtpVP9Pay * self,
 
   g_assert_cmpint (off, ==, hdrlen);
 
-  gst_rtp_buffer_set_marker (&rtpbuffer, mark);
-  if (mark)
-    GST_BUFFER_FLAG_SET (out, GST_BUFFER_FLAG_MARKER);
-
-  gst_rtp_buffer_unmap (&rtpbuffer);
-
-  GST_BUFFER_DURATION (out) = GST_BUFFER_DURATION (in);
-  GST_BUFFER_PTS (out) = GST_BUFFER_PTS (in);
-
-  return out;
+  return hdrlen;
 }
 
 static guint
@@ -515,8 +501,8 @@ gst_rtp_vp9_payload_next (GstRtpVP9Pay * self, GstBufferList * list,
     guint offset, GstBuffer * buffer, gsize buffer_size, gsize max_payload_len,
     gboolean delta_unit)
 {
-  GstBuffer *header;
-  GstBuffer *sub;
+  guint8 header[VP9_MAX_HEADER_LEN];
+  guint header_len;
   GstBuffer *out;
   gboolean mark;
   gsize remaining;
@@ -528,18 +514,16 @@ gst_rtp_vp9_payload_next (GstRtpVP9Pay * self, GstBufferList * list,
     available = remaining;
 
   mark = (remaining == available);
-  header = gst_rtp_vp9_create_header_buffer (self, offset == 0, mark, buffer);
-  sub = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_ALL, offset, available);
+  header_len = gst_rtp_vp9_write_header (self, header, offset == 0, mark);
+  out = gst_rtp_video_fragment_add (GST_RTP_BASE_PAYLOAD (self), list, buffer,
+      offset, available, header, header_len, mark);
 
-  gst_rtp_copy_video_meta (self, header, buffer);
-
-  out = gst_buffer_append (header, sub);
+  GST_BUFFER_DURATION (out) = GST_BUFFER_DURATION (buffer);
+  GST_BUFFER_PTS (out) = GST_BUFFER_PTS (buffer);
 
   if (delta_unit)
     GST_BUFFER_FLAG_SET (out, GST_BUFFER_FLAG_DELTA_UNIT);
 
-  gst_buffer_list_insert (list, -1, out);
-
   return available;
 }
 
@@ -34,6 +34,11 @@
  * look up the requested seqnum in its list of stored packets. If the packet
  * is available, it will create a RTX packet according to RFC 4588 and send
  * this as an auxiliary stream. RTX is SSRC-multiplexed
+ *
+ * The history of each SSRC is indexed by seqnum, so looking up a requested
+ * packet does not depend on the size of the history. RTX packets that are
+ * queued in a burst of requests are pushed downstream together as a buffer
+ * list.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -63,6 +68,7 @@ enum
   PROP_NUM_RTX_REQUESTS,
   PROP_NUM_RTX_PACKETS,
   PROP_CLOCK_RATE_MAP,
+  PROP_NUM_RTX_MISSES,
 };
 
 enum
@@ -161,16 +167,18 @@ GST_ELEMENT_REGISTER_DEFINE (rtprtxsend, "rtprtxsend", GST_RANK_NONE,
 typedef struct
 {
   guint16 seqnum;
+  guint8 payload_type;
   guint32 timestamp;
   GstBuffer *buffer;
 } BufferQueueItem;
 
-static void
-buffer_queue_item_free (BufferQueueItem * item)
-{
-  gst_buffer_unref (item->buffer);
-  g_free (item);
-}
+/* the history always covers less than half of the seqnum space, so that
+ * seqnums can be compared unambiguously */
+#define MAX_HISTORY_SPAN 0x8000
+#define MIN_HISTORY_SIZE 64
+/* packets older than the oldest one in the history by more than this are
+ * taken as a seqnum discontinuity, like in rtpsource */
+#define MAX_MISORDER 100
 
 typedef struct
 {
@@ -178,10 +186,20 @@ typedef struct
   guint16 seqnum_base, next_seqnum;
   gint clock_rate;
 
-  /* history of rtp packets */
-  GSequence *queue;
+  /* history of rtp packets, a ring indexed by seqnum that covers the
+   * seqnums from first_seqnum to first_seqnum + span - 1. Seqnums that were
+   * not stored leave a hole with a NULL buffer, the first and the last slot
+   * always hold a packet. */
+  BufferQueueItem *history;
+  guint history_size;
+  guint16 first_seqnum;
+  guint span;
+  guint n_packets;
 } SSRCRtxData;
 
+#define HISTORY_SLOT(data,seqnum) \
+    (&(data)->history[(seqnum) & ((data)->history_size - 1)])
+
 static SSRCRtxData *
 ssrc_rtx_data_new (guint32 rtx_ssrc)
 {
@@ -189,18 +207,147 @@ ssrc_rtx_data_new (guint32 rtx_ssrc)
 
   data->rtx_ssrc = rtx_ssrc;
   data->next_seqnum = data->seqnum_base = g_random_int_range (0, G_MAXUINT16);
-  data->queue = g_sequence_new ((GDestroyNotify) buffer_queue_item_free);
 
   return data;
 }
 
+static void
+ssrc_rtx_data_clear_history (SSRCRtxData * data)
+{
+  guint i;
+
+  for (i = 0; i < data->span; i++) {
+    BufferQueueItem *item = HISTORY_SLOT (data, data->first_seqnum + i);
+
+    gst_clear_buffer (&item->buffer);
+  }
+  data->span = 0;
+  data->n_packets = 0;
+}
+
 static void
 ssrc_rtx_data_free (SSRCRtxData * data)
 {
-  g_sequence_free (data->queue);
+  ssrc_rtx_data_clear_history (data);
+  g_free (data->history);
   g_free (data);
 }
 
+/* Makes room for @span seqnums starting at @first_seqnum */
+static void
+ssrc_rtx_data_reserve_history (SSRCRtxData * data, guint16 first_seqnum,
+    guint span)
+{
+  BufferQueueItem *old_history = data->history;
+  guint old_size = data->history_size;
+  guint size, i;
+
+  if (span <= old_size)
+    return;
+
+  size = MAX (old_size, MIN_HISTORY_SIZE);
+  while (size < span)
+    size <<= 1;
+
+  data->history = g_new0 (BufferQueueItem, size);
+  data->history_size = size;
+
+  /* the slot of each seqnum depends on the size, move the stored packets */
+  for (i = 0; i < data->span; i++) {
+    guint16 seqnum = data->first_seqnum + i;
+
+    *HISTORY_SLOT (data, seqnum) = old_history[seqnum & (old_size - 1)];
+  }
+  g_free (old_history);
+}
+
+static void
+ssrc_rtx_data_pop_oldest (SSRCRtxData * data)
+{
+  BufferQueueItem *item;
+
+  g_assert (data->n_packets > 0);
+
+  item = HISTORY_SLOT (data, data->first_seqnum);
+  gst_clear_buffer (&item->buffer);
+  data->n_packets--;
+
+  /* skip the holes so that the first slot holds the oldest packet */
+  do {
+    data->first_seqnum++;
+    data->span--;
+  } while (data->span > 0
+      && HISTORY_SLOT (data, data->first_seqnum)->buffer == NULL);
+}
+
+static void
+ssrc_rtx_data_store (SSRCRtxData * data, guint16 seqnum, guint8 payload_type,
+    guint32 timestamp, GstBuffer * buffer)
+{
+  BufferQueueItem *item;
+  gint diff;
+
+  if (data->n_packets == 0) {
+    data->first_seqnum = seqnum;
+    data->span = 0;
+  }
+
+  diff = gst_rtp_buffer_compare_seqnum (data->first_seqnum, seqnum);
+  if (diff < -MAX_MISORDER) {
+    /* seqnum discontinuity, start a new history */
+    ssrc_rtx_data_clear_history (data);
+    data->first_seqnum = seqnum;
+    diff = 0;
+  }
+
+  if (diff < 0) {
+    /* older than the oldest packet we have, extend the history backwards
+     * unless that would make it span too many seqnums */
+    if (data->span - diff >= MAX_HISTORY_SPAN)
+      return;
+    ssrc_rtx_data_reserve_history (data, seqnum, data->span - diff);
+    data->first_seqnum = seqnum;
+    data->span -= diff;
+  } else if (diff >= data->span) {
+    /* drop the oldest packets so that the next seqnum still compares as
+     * newer than the first one */
+    while (data->n_packets > 0 && diff + 1 >= MAX_HISTORY_SPAN) {
+      ssrc_rtx_data_pop_oldest (data);
+      diff = (guint16) (seqnum - data->first_seqnum);
+    }
+    if (data->n_packets == 0) {
+      data->first_seqnum = seqnum;
+      diff = 0;
+    }
+    ssrc_rtx_data_reserve_history (data, data->first_seqnum, diff + 1);
+    data->span = diff + 1;
+  }
+
+  item = HISTORY_SLOT (data, seqnum);
+  if (item->buffer)
+    gst_buffer_unref (item->buffer);
+  else
+    data->n_packets++;
+
+  item->seqnum = seqnum;
+  item->payload_type = payload_type;
+  item->timestamp = timestamp;
+  item->buffer = gst_buffer_ref (buffer);
+}
+
+static BufferQueueItem *
+ssrc_rtx_data_lookup (SSRCRtxData * data, guint16 seqnum)
+{
+  BufferQueueItem *item;
+
+  if ((guint16) (seqnum - data->first_seqnum) >= data->span)
+    return NULL;
+
+  item = HISTORY_SLOT (data, seqnum);
+
+  return item->buffer ? item : NULL;
+}
+
 typedef enum
 {
   RTX_TASK_START,
@@ -305,6 +452,22 @@ gst_rtp_rtx_send_class_init (GstRtpRtxSendClass * klass)
           "Map of payload types to their clock rates",
           GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * rtprtxsend:num-rtx-misses:
+   *
+   * Number of retransmission requests for packets that were not in the
+   * history anymore, or not sent yet. Together with
+   * #rtprtxsend:num-rtx-requests this gives the hit rate of the history,
+   * a high miss rate means #rtprtxsend:max-size-time or
+   * #rtprtxsend:max-size-packets are too small.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_NUM_RTX_MISSES,
+      g_param_spec_uint ("num-rtx-misses", "Num RTX Misses",
+          "Number of retransmission requests for packets not in the history",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * rtprtxsend::add-extension:
    *
@@ -358,6 +521,7 @@ gst_rtp_rtx_send_reset (GstRtpRtxSend * rtx)
   g_hash_table_remove_all (rtx->rtx_ssrcs);
   rtx->num_rtx_requests = 0;
   rtx->num_rtx_packets = 0;
+  rtx->num_rtx_misses = 0;
   GST_OBJECT_UNLOCK (rtx);
 }
 
@@ -666,9 +830,12 @@ rewrite_header_extensions (GstRtpRtxSend * rtx, GstRTPBuffer * rtp)
 
 /* Copy fixed header and extension. Add OSN before to copy payload
  * Copy memory to avoid to manually copy each rtp buffer field.
+ * Must be called without the lock, @ssrc, @seqnum and @fmtp are the header
+ * fields of the rtx packet.
  */
 static GstBuffer *
-gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
+gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer,
+    guint32 ssrc, guint16 seqnum, guint8 fmtp)
 {
   GstMemory *mem = NULL;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
@@ -676,21 +843,9 @@ gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
   GstBuffer *new_buffer = gst_buffer_new ();
   GstMapInfo map;
   guint payload_len = 0;
-  SSRCRtxData *data;
-  guint32 ssrc;
-  guint16 seqnum;
-  guint8 fmtp;
 
   gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp);
 
-  /* get needed data from GstRtpRtxSend */
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  data = gst_rtp_rtx_send_get_ssrc_data (rtx, ssrc);
-  ssrc = data->rtx_ssrc;
-  seqnum = data->next_seqnum++;
-  fmtp = GPOINTER_TO_UINT (g_hash_table_lookup (rtx->rtx_pt_map,
-          GUINT_TO_POINTER (gst_rtp_buffer_get_payload_type (&rtp))));
-
   GST_DEBUG_OBJECT (rtx, "creating rtx buffer, orig seqnum: %u, "
       "rtx seqnum: %u, rtx ssrc: %X", gst_rtp_buffer_get_seq (&rtp),
       seqnum, ssrc);
@@ -704,7 +859,9 @@ gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
 
   /* copy extension if any */
   if (rtp.size[1]) {
+    GST_OBJECT_LOCK (rtx);
     mem = rewrite_header_extensions (rtx, &rtp);
+    GST_OBJECT_UNLOCK (rtx);
     gst_buffer_append_memory (new_buffer, mem);
   }
 
@@ -740,16 +897,6 @@ gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
   return new_buffer;
 }
 
-static gint
-buffer_queue_items_cmp (BufferQueueItem * a, BufferQueueItem * b,
-    gpointer user_data)
-{
-  /* gst_rtp_buffer_compare_seqnum returns the opposite of what we want,
-   * it returns negative when seqnum1 > seqnum2 and we want negative
-   * when b > a, i.e. a is smaller, so it comes first in the sequence */
-  return gst_rtp_buffer_compare_seqnum (b->seqnum, a->seqnum);
-}
-
 static gboolean
 gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -765,7 +912,10 @@ gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       if (gst_structure_has_name (s, "GstRTPRetransmissionRequest")) {
         guint seqnum = 0;
         guint ssrc = 0;
-        GstBuffer *rtx_buf = NULL;
+        GstBuffer *buffer = NULL;
+        guint32 rtx_ssrc = 0;
+        guint16 rtx_seqnum = 0;
+        guint8 rtx_pt = 0;
 
         /* retrieve seqnum of the packet that need to be retransmitted */
         if (!gst_structure_get_uint (s, "seqnum", &seqnum))
@@ -782,34 +932,33 @@ gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         /* check if request is for us */
         if (g_hash_table_contains (rtx->ssrc_data, GUINT_TO_POINTER (ssrc))) {
           SSRCRtxData *data;
-          GSequenceIter *iter;
-          BufferQueueItem search_item;
+          BufferQueueItem *item;
 
           /* update statistics */
           ++rtx->num_rtx_requests;
 
           data = gst_rtp_rtx_send_get_ssrc_data (rtx, ssrc);
 
-          search_item.seqnum = seqnum;
-          iter = g_sequence_lookup (data->queue, &search_item,
-              (GCompareDataFunc) buffer_queue_items_cmp, NULL);
-          if (iter) {
-            BufferQueueItem *item = g_sequence_get (iter);
+          item = ssrc_rtx_data_lookup (data, seqnum);
+          if (item) {
             GST_LOG_OBJECT (rtx, "found %u", item->seqnum);
-            rtx_buf = gst_rtp_rtx_buffer_new (rtx, item->buffer);
-          }
-#ifndef GST_DISABLE_DEBUG
-          else {
-            BufferQueueItem *item = NULL;
 
-            iter = g_sequence_get_begin_iter (data->queue);
-            if (!g_sequence_iter_is_end (iter))
-              item = g_sequence_get (iter);
+            /* only take what is needed for the rtx packet here, it is
+             * created without holding the lock the streaming thread needs */
+            buffer = gst_buffer_ref (item->buffer);
+            rtx_ssrc = data->rtx_ssrc;
+            rtx_seqnum = data->next_seqnum++;
+            rtx_pt = GPOINTER_TO_UINT (g_hash_table_lookup (rtx->rtx_pt_map,
+                    GUINT_TO_POINTER (item->payload_type)));
+          } else {
+            ++rtx->num_rtx_misses;
 
-            if (item && seqnum < item->seqnum) {
+            if (data->n_packets > 0 &&
+                gst_rtp_buffer_compare_seqnum (data->first_seqnum,
+                    seqnum) < 0) {
               GST_DEBUG_OBJECT (rtx, "requested seqnum %u has already been "
                   "removed from the rtx queue; the first available is %u",
-                  seqnum, item->seqnum);
+                  seqnum, data->first_seqnum);
             } else {
               GST_WARNING_OBJECT (rtx, "requested seqnum %u has not been "
                   "transmitted yet in the original stream; either the remote end "
@@ -817,12 +966,17 @@ gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
                   seqnum);
             }
           }
-#endif
         }
         GST_OBJECT_UNLOCK (rtx);
 
-        if (rtx_buf)
+        if (buffer) {
+          GstBuffer *rtx_buf;
+
+          rtx_buf = gst_rtp_rtx_buffer_new (rtx, buffer, rtx_ssrc, rtx_seqnum,
+              rtx_pt);
+          gst_buffer_unref (buffer);
           gst_rtp_rtx_send_push_out (rtx, rtx_buf);
+        }
 
         gst_event_unref (event);
         res = TRUE;
@@ -981,14 +1135,12 @@ gst_rtp_rtx_send_get_ts_diff (SSRCRtxData * data)
   BufferQueueItem *high_buf, *low_buf;
   guint32 result;
 
-  high_buf =
-      g_sequence_get (g_sequence_iter_prev (g_sequence_get_end_iter
-          (data->queue)));
-  low_buf = g_sequence_get (g_sequence_get_begin_iter (data->queue));
-
-  if (!high_buf || !low_buf || high_buf == low_buf)
+  if (data->n_packets < 2)
     return 0;
 
+  high_buf = HISTORY_SLOT (data, data->first_seqnum + data->span - 1);
+  low_buf = HISTORY_SLOT (data, data->first_seqnum);
+
   if (data->clock_rate) {
     high_ts = high_buf->timestamp;
     low_ts = low_buf->timestamp;
@@ -1014,7 +1166,6 @@ static void
 process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
 {
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
-  BufferQueueItem *item;
   SSRCRtxData *data;
   guint16 seqnum;
   guint8 payload_type;
@@ -1042,20 +1193,16 @@ process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
     }
 
     /* add current rtp buffer to queue history */
-    item = g_new0 (BufferQueueItem, 1);
-    item->seqnum = seqnum;
-    item->timestamp = rtptime;
-    item->buffer = gst_buffer_ref (buffer);
-    g_sequence_append (data->queue, item);
+    ssrc_rtx_data_store (data, seqnum, payload_type, rtptime, buffer);
 
     /* remove oldest packets from history if they are too many */
     if (rtx->max_size_packets) {
-      while (g_sequence_get_length (data->queue) > rtx->max_size_packets)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+      while (data->n_packets > rtx->max_size_packets)
+        ssrc_rtx_data_pop_oldest (data);
     }
     if (rtx->max_size_time) {
       while (gst_rtp_rtx_send_get_ts_diff (data) > rtx->max_size_time)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+        ssrc_rtx_data_pop_oldest (data);
     }
   }
 }
@@ -1107,13 +1254,46 @@ gst_rtp_rtx_send_src_loop (GstRtpRtxSend * rtx)
     GST_LOG_OBJECT (rtx, "pushing rtx buffer %p", data->object);
 
     if (G_LIKELY (GST_IS_BUFFER (data->object))) {
+      GstBufferList *list = NULL;
+      GstBuffer *buffer = GST_BUFFER (data->object);
+
+      data->object = NULL;
+      data->destroy (data);
+      data = NULL;
+
+      /* a burst of requests queues many rtx packets, push all the ones that
+       * are already waiting at once. Only this task pops, so popping does not
+       * block when the queue is not empty. It fails when flushing. An event
+       * popped here is handled after the packets. */
+      while (!gst_data_queue_is_empty (rtx->queue)
+          && gst_data_queue_pop (rtx->queue, &data)) {
+        if (!GST_IS_BUFFER (data->object))
+          break;
+
+        if (list == NULL) {
+          list = gst_buffer_list_new ();
+          gst_buffer_list_add (list, buffer);
+        }
+        gst_buffer_list_add (list, GST_BUFFER (data->object));
+        data->object = NULL;
+        data->destroy (data);
+        data = NULL;
+      }
+
       GST_OBJECT_LOCK (rtx);
       /* Update statistics just before pushing. */
-      rtx->num_rtx_packets++;
+      rtx->num_rtx_packets += list ? gst_buffer_list_length (list) : 1;
       GST_OBJECT_UNLOCK (rtx);
 
-      gst_pad_push (rtx->srcpad, GST_BUFFER (data->object));
-    } else if (GST_IS_EVENT (data->object)) {
+      if (list)
+        gst_pad_push_list (rtx->srcpad, list);
+      else
+        gst_pad_push (rtx->srcpad, buffer);
+    }
+
+    if (data != NULL) {
+      g_assert (GST_IS_EVENT (data->object));
+
       gst_pad_push_event (rtx->srcpad, GST_EVENT (data->object));
 
       /* after EOS, we should not send any more buffers,
@@ -1121,12 +1301,10 @@ gst_rtp_rtx_send_src_loop (GstRtpRtxSend * rtx)
       if (GST_EVENT_TYPE (data->object) == GST_EVENT_EOS) {
         gst_rtp_rtx_send_set_flushing (rtx, TRUE);
       }
-    } else {
-      g_assert_not_reached ();
-    }
 
-    data->object = NULL;        /* we no longer own that object */
-    data->destroy (data);
+      data->object = NULL;      /* we no longer own that object */
+      data->destroy (data);
+    }
   } else {
     GST_LOG_OBJECT (rtx, "flushing");
     gst_rtp_rtx_send_set_task_state (rtx, RTX_TASK_PAUSE);
@@ -1187,6 +1365,11 @@ gst_rtp_rtx_send_get_property (GObject * object,
       g_value_set_uint (value, rtx->num_rtx_packets);
       GST_OBJECT_UNLOCK (rtx);
       break;
+    case PROP_NUM_RTX_MISSES:
+      GST_OBJECT_LOCK (rtx);
+      g_value_set_uint (value, rtx->num_rtx_misses);
+      GST_OBJECT_UNLOCK (rtx);
+      break;
     case PROP_CLOCK_RATE_MAP:
       GST_OBJECT_LOCK (rtx);
       g_value_set_boxed (value, rtx->clock_rate_map_structure);
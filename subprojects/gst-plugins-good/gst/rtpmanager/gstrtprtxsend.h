@@ -77,6 +77,7 @@ struct _GstRtpRtxSend
   /* statistics */
   guint num_rtx_requests;
   guint num_rtx_packets;
+  guint num_rtx_misses;
 
   /* list of relevant RTP Header Extensions */
   GstRTPHeaderExtension *rid_stream;
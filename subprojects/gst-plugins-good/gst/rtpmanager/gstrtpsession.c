@@ -205,6 +205,7 @@ enum
   SIGNAL_ON_SENDER_TIMEOUT,
   SIGNAL_ON_NEW_SENDER_SSRC,
   SIGNAL_ON_SENDER_SSRC_ACTIVE,
+  SIGNAL_ON_BANDWIDTH_ESTIMATE,
   LAST_SIGNAL
 };
 
@@ -669,6 +670,27 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRtpSessionClass,
           on_ssrc_active), NULL, NULL, NULL, G_TYPE_NONE, 1, G_TYPE_UINT);
 
+  /**
+   * GstRtpSession::on-bandwidth-estimate:
+   * @sess: the object which received the signal
+   * @bitrate_sent: the bitrate sent, in bits per second
+   * @bitrate_recv: the bitrate estimated for the receiver, in bits per second
+   * @packet_loss_pct: the packet loss percentage reported by the receiver
+   * @avg_delta_of_delta: the average difference in inter-packet spacing
+   *   between sender and receiver, in nanoseconds
+   *
+   * Notify of a new bandwidth estimate derived from TWCC feedback. This
+   * carries the same values as the #GstRtpSession:twcc-stats property
+   * without having to parse a #GstStructure, and is emitted from the thread
+   * that received the RTCP packet.
+   *
+   * Since: 1.28
+   */
+  gst_rtp_session_signals[SIGNAL_ON_BANDWIDTH_ESTIMATE] =
+      g_signal_new ("on-bandwidth-estimate", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL, G_TYPE_NONE, 4, G_TYPE_UINT,
+      G_TYPE_UINT, G_TYPE_DOUBLE, G_TYPE_INT64);
+
   g_object_class_install_property (gobject_class, PROP_BANDWIDTH,
       g_param_spec_double ("bandwidth", "Bandwidth",
           "The bandwidth of the session in bytes per second (0 for auto-discover)",
@@ -2995,6 +3017,14 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   GstEvent *event;
   GstPad *send_rtp_src;
   GstPad *send_rtp_sink;
+  guint bitrate_sent = 0, bitrate_recv = 0;
+  gdouble packet_loss_pct = 0.0;
+  gint64 avg_delta_of_delta = GST_CLOCK_STIME_NONE;
+
+  gst_structure_get (twcc_stats, "bitrate-sent", G_TYPE_UINT, &bitrate_sent,
+      "bitrate-recv", G_TYPE_UINT, &bitrate_recv,
+      "packet-loss-pct", G_TYPE_DOUBLE, &packet_loss_pct,
+      "avg-delta-of-delta", G_TYPE_INT64, &avg_delta_of_delta, NULL);
 
   GST_RTP_SESSION_LOCK (rtpsession);
   if ((send_rtp_sink = rtpsession->send_rtp_sink))
@@ -3024,6 +3054,10 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
 
   gst_structure_free (twcc_packets);
   g_object_notify (G_OBJECT (rtpsession), "twcc-stats");
+
+  g_signal_emit (rtpsession,
+      gst_rtp_session_signals[SIGNAL_ON_BANDWIDTH_ESTIMATE], 0, bitrate_sent,
+      bitrate_recv, packet_loss_pct, avg_delta_of_delta);
 }
 
 static void
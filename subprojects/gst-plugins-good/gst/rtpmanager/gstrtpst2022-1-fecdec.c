@@ -87,6 +87,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecdec.h"
+#include "gstrtputils.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtpst_2022_1_fecdec_debug);
 #define GST_CAT_DEFAULT gst_rtpst_2022_1_fecdec_debug
@@ -139,6 +140,10 @@ struct _GstRTPST_2022_1_FecDec
   GSequence *packets;
   GHashTable *column_fec_packets;
   GSequence *fec_packets[2];
+  /* Scratch storage for recovering a packet, only valid until the
+   * recovered packet is stored */
+  GPtrArray *xor_packets;
+  GArray *xor_maps;
   /* N columns */
   guint l;
   /* N rows */
@@ -371,28 +376,18 @@ done:
 }
 
 static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
+unmap_xor_packets (GstRTPST_2022_1_FecDec * dec)
 {
   guint i;
 
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
+  for (i = 0; i < dec->xor_maps->len; i++)
+    gst_rtp_buffer_unmap (&g_array_index (dec->xor_maps, GstRTPBuffer, i));
+  g_array_set_size (dec->xor_maps, 0);
 }
 
 static GstFlowReturn
-xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
-    guint16 seqnum)
+xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec,
+    GPtrArray * packets, guint16 seqnum)
 {
   guint8 *xored;
   guint32 xored_timestamp;
@@ -400,27 +395,34 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
   guint16 xored_payload_len;
   Item *item;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
-  GList *tmp;
+  guint i;
   GstFlowReturn ret = GST_FLOW_OK;
   GstBuffer *buffer;
   gboolean xored_marker;
   gboolean xored_padding;
   gboolean xored_extension;
 
-  /* Figure out the recovered packet length first */
+  /* Map all media packets once and figure out the recovered packet
+   * length first */
   xored_payload_len = fec->len;
-  for (tmp = packets; tmp; tmp = tmp->next) {
-    GstRTPBuffer media_rtp = GST_RTP_BUFFER_INIT;
-    Item *item = (Item *) tmp->data;
-
-    gst_rtp_buffer_map (item->buffer, GST_MAP_READ, &media_rtp);
-    xored_payload_len ^= gst_rtp_buffer_get_payload_len (&media_rtp);
-    gst_rtp_buffer_unmap (&media_rtp);
+  g_array_set_size (dec->xor_maps, packets->len);
+  for (i = 0; i < packets->len; i++) {
+    GstRTPBuffer *media_rtp = &g_array_index (dec->xor_maps, GstRTPBuffer, i);
+    Item *item = g_ptr_array_index (packets, i);
+
+    *media_rtp = (GstRTPBuffer) GST_RTP_BUFFER_INIT;
+    if (!gst_rtp_buffer_map (item->buffer, GST_MAP_READ, media_rtp)) {
+      g_array_set_size (dec->xor_maps, i);
+      unmap_xor_packets (dec);
+      goto done;
+    }
+    xored_payload_len ^= gst_rtp_buffer_get_payload_len (media_rtp);
   }
 
   if (xored_payload_len > fec->payload_len) {
     GST_WARNING_OBJECT (dec, "FEC payload len %u < length recovery %u",
         fec->payload_len, xored_payload_len);
+    unmap_xor_packets (dec);
     goto done;
   }
 
@@ -437,22 +439,20 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
   xored_padding = fec->padding;
   xored_extension = fec->extension;
 
-  for (tmp = packets; tmp; tmp = tmp->next) {
-    GstRTPBuffer media_rtp = GST_RTP_BUFFER_INIT;
-    Item *item = (Item *) tmp->data;
+  for (i = 0; i < dec->xor_maps->len; i++) {
+    GstRTPBuffer *media_rtp = &g_array_index (dec->xor_maps, GstRTPBuffer, i);
 
-    gst_rtp_buffer_map (item->buffer, GST_MAP_READ, &media_rtp);
-    _xor_mem (xored, gst_rtp_buffer_get_payload (&media_rtp),
-        MIN (gst_rtp_buffer_get_payload_len (&media_rtp), xored_payload_len));
-    xored_timestamp ^= gst_rtp_buffer_get_timestamp (&media_rtp);
-    xored_pt ^= gst_rtp_buffer_get_payload_type (&media_rtp);
-    xored_marker ^= gst_rtp_buffer_get_marker (&media_rtp);
-    xored_padding ^= gst_rtp_buffer_get_padding (&media_rtp);
-    xored_extension ^= gst_rtp_buffer_get_extension (&media_rtp);
-
-    gst_rtp_buffer_unmap (&media_rtp);
+    gst_rtp_xor_mem (xored, gst_rtp_buffer_get_payload (media_rtp),
+        MIN (gst_rtp_buffer_get_payload_len (media_rtp), xored_payload_len));
+    xored_timestamp ^= gst_rtp_buffer_get_timestamp (media_rtp);
+    xored_pt ^= gst_rtp_buffer_get_payload_type (media_rtp);
+    xored_marker ^= gst_rtp_buffer_get_marker (media_rtp);
+    xored_padding ^= gst_rtp_buffer_get_padding (media_rtp);
+    xored_extension ^= gst_rtp_buffer_get_extension (media_rtp);
   }
 
+  unmap_xor_packets (dec);
+
   GST_DEBUG_OBJECT (dec,
       "Recovered buffer through %s FEC with seqnum %u, payload len %u and timestamp %u",
       fec->D ? "row" : "column", seqnum, xored_payload_len, xored_timestamp);
@@ -498,12 +498,15 @@ done:
 static GstFlowReturn
 check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
 {
-  GList *packets = NULL;
+  GPtrArray *packets = dec->xor_packets;
   gint missing_seq = -1;
   guint n_packets = 0;
   guint required_n_packets;
   GstFlowReturn ret = GST_FLOW_OK;
 
+  /* xor_items() may recurse in here, only ever clear before use */
+  g_ptr_array_set_size (packets, 0);
+
   if (fec->D) {
     guint i = 0;
 
@@ -513,7 +516,7 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
       Item *item = lookup_media_packet (dec, fec->seq + i);
 
       if (item) {
-        packets = g_list_prepend (packets, item);
+        g_ptr_array_add (packets, item);
         n_packets += 1;
       } else {
         missing_seq = fec->seq + i;
@@ -528,7 +531,7 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
       Item *item = lookup_media_packet (dec, fec->seq + i * dec->l);
 
       if (item) {
-        packets = g_list_prepend (packets, item);
+        g_ptr_array_add (packets, item);
         n_packets += 1;
       } else {
         missing_seq = fec->seq + i * dec->l;
@@ -548,7 +551,6 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
     ret = GST_FLOW_CUSTOM_SUCCESS;
     GST_LOG_OBJECT (dec, "Too many media packets missing, storing FEC packet");
   }
-  g_list_free (packets);
 
   return ret;
 }
@@ -833,6 +835,9 @@ gst_rtpst_2022_1_fecdec_finalize (GObject * object)
 
   gst_rtpst_2022_1_fecdec_reset (dec, FALSE);
 
+  g_ptr_array_unref (dec->xor_packets);
+  g_array_unref (dec->xor_maps);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1010,4 +1015,7 @@ gst_rtpst_2022_1_fecdec_init (GstRTPST_2022_1_FecDec * dec)
 
   dec->d = G_MAXUINT;
   dec->l = G_MAXUINT;
+
+  dec->xor_packets = g_ptr_array_new ();
+  dec->xor_maps = g_array_new (FALSE, FALSE, sizeof (GstRTPBuffer));
 }
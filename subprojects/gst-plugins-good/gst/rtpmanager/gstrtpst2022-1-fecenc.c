@@ -69,6 +69,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecenc.h"
+#include "gstrtputils.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtpst_2022_1_fecenc_debug);
 #define GST_CAT_DEFAULT gst_rtpst_2022_1_fecenc_debug
@@ -98,7 +99,9 @@ typedef struct
 
 typedef struct
 {
+  /* kept across matrices, only grows when a bigger payload shows up */
   guint8 *xored_payload;
+  guint payload_alloc;
   guint32 xored_timestamp;
   guint8 xored_pt;
   guint16 xored_payload_len;
@@ -221,23 +224,24 @@ free_fec_packet (FecPacket * packet)
 }
 
 static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
+fec_packet_reserve (FecPacket * fec, guint size)
 {
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
+  if (fec->payload_alloc < size) {
+    fec->xored_payload = g_realloc (fec->xored_payload, size);
+    fec->payload_alloc = size;
   }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
+}
+
+/* Prepares @fec for the next matrix, keeping its payload storage */
+static void
+fec_packet_clear (FecPacket * fec)
+{
+  guint8 *xored_payload = fec->xored_payload;
+  guint payload_alloc = fec->payload_alloc;
+
+  memset (fec, 0x00, sizeof (FecPacket));
+  fec->xored_payload = xored_payload;
+  fec->payload_alloc = payload_alloc;
 }
 
 static void
@@ -252,15 +256,14 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker = gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding = gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension = gst_rtp_buffer_get_extension (rtp);
-    fec->xored_payload = g_malloc (sizeof (guint8) * fec->payload_len);
+    fec_packet_reserve (fec, fec->payload_len);
     memcpy (fec->xored_payload, gst_rtp_buffer_get_payload (rtp),
         fec->payload_len);
   } else {
     guint plen = gst_rtp_buffer_get_payload_len (rtp);
 
     if (fec->payload_len < plen) {
-      fec->xored_payload =
-          g_realloc (fec->xored_payload, sizeof (guint8) * plen);
+      fec_packet_reserve (fec, plen);
       memset (fec->xored_payload + fec->payload_len, 0,
           plen - fec->payload_len);
       fec->payload_len = plen;
@@ -272,7 +275,8 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker ^= gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding ^= gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension ^= gst_rtp_buffer_get_extension (rtp);
-    _xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp), plen);
+    gst_rtp_xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp),
+        plen);
   }
 
   fec->n_packets += 1;
@@ -445,8 +449,7 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
     fec_packet_update (enc->row, &rtp);
     if (enc->row->n_packets == enc->l) {
       queue_fec_packet (enc, enc->row, TRUE);
-      g_free (enc->row->xored_payload);
-      memset (enc->row, 0x00, sizeof (FecPacket));
+      fec_packet_clear (enc->row);
     }
   }
 
@@ -456,8 +459,7 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
     fec_packet_update (column, &rtp);
     if (column->n_packets == enc->d) {
       queue_fec_packet (enc, column, FALSE);
-      g_free (column->xored_payload);
-      memset (column, 0x00, sizeof (FecPacket));
+      fec_packet_clear (column);
     }
 
     enc->current_column++;
@@ -633,8 +635,7 @@ gst_rtpst_2022_1_fecenc_set_property (GObject * object, guint prop_id,
         if (enc->columns) {
           for (i = 0; i < enc->l; i++) {
             FecPacket *column = g_ptr_array_index (enc->columns, i);
-            g_free (column->xored_payload);
-            memset (column, 0x00, sizeof (FecPacket));
+            fec_packet_clear (column);
           }
         }
         enc->current_column = 0;
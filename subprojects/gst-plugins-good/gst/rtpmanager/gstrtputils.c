@@ -19,6 +19,14 @@
 
 #include "gstrtputils.h"
 
+#include <string.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 guint8
 gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
     const gchar * ext_name)
@@ -42,3 +50,71 @@ gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
   }
   return extmap_id;
 }
+
+/* XORs @length bytes of @src into @dst, which must not overlap. This is the
+ * parity computation of the FEC elements, so it works on 64 bytes per
+ * iteration with the vector instructions the target always has (SSE2 on
+ * x86-64, NEON on aarch64) and falls back to 64 bit words otherwise. */
+void
+gst_rtp_xor_mem (guint8 * restrict dst, const guint8 * restrict src,
+    gsize length)
+{
+  gsize i = 0;
+
+#if defined (__SSE2__)
+  for (; i + 64 <= length; i += 64) {
+    __m128i d0 = _mm_loadu_si128 ((const __m128i *) (dst + i));
+    __m128i d1 = _mm_loadu_si128 ((const __m128i *) (dst + i + 16));
+    __m128i d2 = _mm_loadu_si128 ((const __m128i *) (dst + i + 32));
+    __m128i d3 = _mm_loadu_si128 ((const __m128i *) (dst + i + 48));
+
+    d0 = _mm_xor_si128 (d0, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    d1 = _mm_xor_si128 (d1,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 16)));
+    d2 = _mm_xor_si128 (d2,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 32)));
+    d3 = _mm_xor_si128 (d3,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 48)));
+
+    _mm_storeu_si128 ((__m128i *) (dst + i), d0);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 16), d1);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 32), d2);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 48), d3);
+  }
+  for (; i + 16 <= length; i += 16) {
+    __m128i d = _mm_loadu_si128 ((const __m128i *) (dst + i));
+
+    d = _mm_xor_si128 (d, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    _mm_storeu_si128 ((__m128i *) (dst + i), d);
+  }
+#elif defined (__ARM_NEON)
+  for (; i + 64 <= length; i += 64) {
+    uint8x16_t d0 = veorq_u8 (vld1q_u8 (dst + i), vld1q_u8 (src + i));
+    uint8x16_t d1 = veorq_u8 (vld1q_u8 (dst + i + 16),
+        vld1q_u8 (src + i + 16));
+    uint8x16_t d2 = veorq_u8 (vld1q_u8 (dst + i + 32),
+        vld1q_u8 (src + i + 32));
+    uint8x16_t d3 = veorq_u8 (vld1q_u8 (dst + i + 48),
+        vld1q_u8 (src + i + 48));
+
+    vst1q_u8 (dst + i, d0);
+    vst1q_u8 (dst + i + 16, d1);
+    vst1q_u8 (dst + i + 32, d2);
+    vst1q_u8 (dst + i + 48, d3);
+  }
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8 (dst + i, veorq_u8 (vld1q_u8 (dst + i), vld1q_u8 (src + i)));
+#endif
+
+  for (; i + 8 <= length; i += 8) {
+    guint64 d, s;
+
+    memcpy (&d, dst + i, sizeof (d));
+    memcpy (&s, src + i, sizeof (s));
+    d ^= s;
+    memcpy (dst + i, &d, sizeof (d));
+  }
+
+  for (; i < length; i++)
+    dst[i] ^= src[i];
+}
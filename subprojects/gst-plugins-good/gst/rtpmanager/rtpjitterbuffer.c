@@ -114,6 +114,7 @@ rtp_jitter_buffer_finalize (GObject * object)
     gst_object_unref (jbuf->pipeline_clock);
 
   rtp_jitter_buffer_flush (jbuf, NULL, NULL);
+  g_free (jbuf->index);
 
   g_mutex_clear (&jbuf->clock_lock);
 
@@ -758,6 +759,175 @@ queue_do_insert (RTPJitterBuffer * jbuf, GList * list, GList * item)
   queue->length++;
 }
 
+/* The seqnum index is a power of two sized ring where each queued item with a
+ * seqnum is stored at seqnum & (size - 1). It is kept large enough to cover the
+ * seqnum range of the queue so that slots never collide, which is at most half
+ * of the seqnum space as the queue is not ordered anymore beyond that. */
+#define RTP_JITTER_BUFFER_MIN_INDEX 256
+#define RTP_JITTER_BUFFER_MAX_INDEX 32768
+
+static GList *
+queue_find_seqnum_item (GList * list, gboolean forward)
+{
+  while (list && ((RTPJitterBufferItem *) list)->seqnum == -1)
+    list = forward ? list->next : list->prev;
+
+  return list;
+}
+
+static inline RTPJitterBufferItem *
+index_lookup (RTPJitterBuffer * jbuf, guint16 seqnum)
+{
+  RTPJitterBufferItem *item;
+
+  item = jbuf->index[seqnum & (jbuf->index_size - 1)];
+  if (item && item->seqnum == seqnum)
+    return item;
+
+  return NULL;
+}
+
+static inline void
+index_add (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  if (jbuf->index_valid && item->seqnum != -1)
+    jbuf->index[item->seqnum & (jbuf->index_size - 1)] = item;
+}
+
+static inline void
+index_remove (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  guint slot;
+
+  if (!jbuf->index_valid || item->seqnum == -1)
+    return;
+
+  slot = item->seqnum & (jbuf->index_size - 1);
+  if (jbuf->index[slot] == item)
+    jbuf->index[slot] = NULL;
+}
+
+static gboolean
+index_rebuild (RTPJitterBuffer * jbuf, guint span)
+{
+  guint size = RTP_JITTER_BUFFER_MIN_INDEX;
+  GList *list;
+
+  while (size <= span)
+    size <<= 1;
+
+  if (size != jbuf->index_size) {
+    g_free (jbuf->index);
+    jbuf->index = g_new (RTPJitterBufferItem *, size);
+    jbuf->index_size = size;
+  }
+  memset (jbuf->index, 0, size * sizeof (RTPJitterBufferItem *));
+  jbuf->index_valid = TRUE;
+
+  for (list = jbuf->packets.head; list; list = list->next) {
+    RTPJitterBufferItem *item = (RTPJitterBufferItem *) list;
+
+    if (item->seqnum == -1)
+      continue;
+
+    if (jbuf->index[item->seqnum & (size - 1)] != NULL) {
+      GST_DEBUG ("seqnum index collision, falling back to list walk");
+      jbuf->index_valid = FALSE;
+      return FALSE;
+    }
+    index_add (jbuf, item);
+  }
+
+  GST_DEBUG ("rebuilt seqnum index with %u slots", size);
+
+  return TRUE;
+}
+
+/* Make sure the index covers the queued packets and @seqnum. Returns %FALSE
+ * when the range is too large for the index to be used. @low and @high are
+ * set to the first and last queued items with a seqnum. */
+static gboolean
+index_update (RTPJitterBuffer * jbuf, guint16 seqnum, GList ** low,
+    GList ** high)
+{
+  guint span = 0;
+
+  *low = queue_find_seqnum_item (jbuf->packets.head, TRUE);
+  *high = queue_find_seqnum_item (jbuf->packets.tail, FALSE);
+
+  if (*low) {
+    RTPJitterBufferItem *low_item = (RTPJitterBufferItem *) (*low);
+    RTPJitterBufferItem *high_item = (RTPJitterBufferItem *) (*high);
+    guint16 low_seqnum = low_item->seqnum;
+    guint16 high_seqnum = high_item->seqnum;
+    gint low_gap, high_gap, range;
+
+    range = gst_rtp_buffer_compare_seqnum (low_seqnum, high_seqnum);
+    low_gap = gst_rtp_buffer_compare_seqnum (low_seqnum, seqnum);
+    high_gap = gst_rtp_buffer_compare_seqnum (high_seqnum, seqnum);
+
+    if (range < 0)
+      goto too_large;
+
+    span = range;
+    if (low_gap < 0)
+      span += -low_gap;
+    if (high_gap > 0)
+      span += high_gap;
+
+    if (span >= RTP_JITTER_BUFFER_MAX_INDEX)
+      goto too_large;
+  }
+
+  if (jbuf->index_valid && span < jbuf->index_size)
+    return TRUE;
+
+  /* after a fallback the queue might not be ordered, wait until it contains
+   * no more packets before using the index again */
+  if (!jbuf->index_valid && *low != NULL && jbuf->index_size > 0)
+    return FALSE;
+
+  return index_rebuild (jbuf, span);
+
+too_large:
+  jbuf->index_valid = FALSE;
+  return FALSE;
+}
+
+/* Find the queued item with the highest seqnum lower than @seqnum, using the
+ * index. Only the slots of the missing seqnums in between are visited. */
+static GList *
+index_find_prev (RTPJitterBuffer * jbuf, guint16 seqnum, GList * low,
+    GList * high)
+{
+  guint16 low_seqnum, i;
+  gint gap;
+
+  if (low == NULL)
+    return NULL;
+
+  /* most packets are appended after the highest seqnum */
+  if (gst_rtp_buffer_compare_seqnum (((RTPJitterBufferItem *) high)->seqnum,
+          seqnum) > 0)
+    return high;
+
+  low_seqnum = ((RTPJitterBufferItem *) low)->seqnum;
+  gap = gst_rtp_buffer_compare_seqnum (low_seqnum, seqnum);
+  if (gap < 0)
+    return NULL;
+
+  for (i = seqnum - 1;; i--) {
+    RTPJitterBufferItem *item = index_lookup (jbuf, i);
+
+    if (item)
+      return (GList *) item;
+    if (i == low_seqnum)
+      break;
+  }
+
+  return low;
+}
+
 GstClockTime
 rtp_jitter_buffer_calculate_pts (RTPJitterBuffer * jbuf, GstClockTime dts,
     gboolean estimated_dts, guint32 rtptime, GstClockTime base_time,
@@ -1152,7 +1322,7 @@ static gboolean
 rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     gboolean * head, gint * percent)
 {
-  GList *list, *event = NULL;
+  GList *list, *event = NULL, *low, *high;
   guint16 seqnum;
 
   if (G_LIKELY (head))
@@ -1171,6 +1341,20 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
   seqnum = item->seqnum;
 
+  if (G_LIKELY (index_update (jbuf, seqnum, &low, &high))) {
+    if (index_lookup (jbuf, seqnum))
+      goto duplicate;
+
+    /* the packet goes after the previous packet and after the events that
+     * directly follow it */
+    list = index_find_prev (jbuf, seqnum, low, high);
+    for (event = list ? list->next : jbuf->packets.head; event &&
+        ((RTPJitterBufferItem *) event)->seqnum == -1; event = event->next)
+      list = event;
+
+    goto append;
+  }
+
   /* loop the list to skip strictly larger seqnum buffers */
   for (; list; list = g_list_previous (list)) {
     guint16 qseq;
@@ -1211,6 +1395,7 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
 append:
   queue_do_insert (jbuf, list, (GList *) item);
+  index_add (jbuf, item);
 
   /* buffering mode, update buffer stats */
   if (jbuf->mode == RTP_JITTER_BUFFER_MODE_BUFFER)
@@ -1410,6 +1595,7 @@ rtp_jitter_buffer_pop (RTPJitterBuffer * jbuf, gint * percent)
     else
       queue->tail = NULL;
     queue->length--;
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
   }
 
   /* buffering mode, update buffer stats */
@@ -1464,8 +1650,10 @@ rtp_jitter_buffer_flush (RTPJitterBuffer * jbuf, GFunc free_func,
   if (free_func == NULL)
     free_func = (GFunc) rtp_jitter_buffer_free_item;
 
-  while ((item = g_queue_pop_head_link (&jbuf->packets)))
+  while ((item = g_queue_pop_head_link (&jbuf->packets))) {
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
     free_func ((RTPJitterBufferItem *) item, user_data);
+  }
 }
 
 /**
@@ -75,6 +75,12 @@ struct _RTPJitterBuffer {
 
   GQueue         packets;
 
+  /* ring of the queued items indexed by seqnum, for constant time duplicate
+   * checks and insert position lookups */
+  RTPJitterBufferItem **index;
+  guint          index_size;
+  gboolean       index_valid;
+
   RTPJitterBufferMode mode;
 
   GstClockTime   delay;
@@ -84,6 +84,10 @@ enum
 #define DEFAULT_UPDATE_NTP64_HEADER_EXT TRUE
 #define DEFAULT_TIMEOUT_INACTIVE_SOURCES TRUE
 
+/* number of sources handled in one go while generating RTCP before letting
+ * the RTP path take the session lock */
+#define RTCP_SOURCES_PER_LOCK 32
+
 enum
 {
   PROP_0,
@@ -768,6 +772,7 @@ rtp_session_init (RTPSession * sess)
   sess->is_doing_ptp = TRUE;
 
   sess->twcc = rtp_twcc_manager_new (sess->mtu);
+  g_mutex_init (&sess->twcc_lock);
   sess->twcc_stats = rtp_twcc_stats_new ();
 }
 
@@ -791,7 +796,9 @@ rtp_session_finalize (GObject * object)
     g_hash_table_destroy (sess->ssrcs[i]);
 
   g_object_unref (sess->twcc);
+  g_clear_pointer (&sess->twcc_pending, g_array_unref);
   rtp_twcc_stats_free (sess->twcc_stats);
+  g_mutex_clear (&sess->twcc_lock);
 
   g_mutex_clear (&sess->lock);
 
@@ -2978,29 +2985,48 @@ rtp_session_process_sr_req (RTPSession * sess, guint32 sender_ssrc,
   rtp_session_send_rtcp (sess, 5 * GST_SECOND);
 }
 
+/* Only parses the feedback, the packets of all the TWCC feedback in a
+ * compound RTCP packet are processed together by
+ * rtp_session_process_twcc_packets() once the session lock is released */
 static void
 rtp_session_process_twcc (RTPSession * sess, guint32 sender_ssrc,
     guint32 media_ssrc, guint8 * fci_data, guint fci_length)
 {
   GArray *twcc_packets;
-  GstStructure *twcc_packets_s;
-  GstStructure *twcc_stats_s;
 
   twcc_packets = rtp_twcc_manager_parse_fci (sess->twcc,
       fci_data, fci_length * sizeof (guint32));
   if (twcc_packets == NULL)
     return;
 
+  if (sess->twcc_pending == NULL)
+    sess->twcc_pending = g_array_sized_new (FALSE, FALSE,
+        sizeof (RTPTWCCPacket), twcc_packets->len);
+  g_array_append_vals (sess->twcc_pending, twcc_packets->data,
+      twcc_packets->len);
+
+  g_array_unref (twcc_packets);
+}
+
+/* Must be called without the session lock */
+static void
+rtp_session_process_twcc_packets (RTPSession * sess, GArray * twcc_packets)
+{
+  GstStructure *twcc_packets_s;
+  GstStructure *twcc_stats_s;
+
   twcc_packets_s = rtp_twcc_stats_get_packets_structure (twcc_packets);
+
+  g_mutex_lock (&sess->twcc_lock);
   twcc_stats_s =
       rtp_twcc_stats_process_packets (sess->twcc_stats, twcc_packets);
+  g_mutex_unlock (&sess->twcc_lock);
 
   GST_DEBUG_OBJECT (sess, "Parsed TWCC: %" GST_PTR_FORMAT, twcc_packets_s);
   GST_INFO_OBJECT (sess, "Current TWCC stats %" GST_PTR_FORMAT, twcc_stats_s);
 
   g_array_unref (twcc_packets);
 
-  RTP_SESSION_UNLOCK (sess);
   if (sess->callbacks.notify_twcc)
     sess->callbacks.notify_twcc (sess, g_steal_pointer (&twcc_packets_s),
         g_steal_pointer (&twcc_stats_s), sess->notify_twcc_user_data);
@@ -3008,7 +3034,6 @@ rtp_session_process_twcc (RTPSession * sess, guint32 sender_ssrc,
     gst_structure_free (twcc_packets_s);
     gst_structure_free (twcc_stats_s);
   }
-  RTP_SESSION_LOCK (sess);
 }
 
 static void
@@ -3142,6 +3167,7 @@ rtp_session_process_rtcp (RTPSession * sess, GstBuffer * buffer,
   RTPPacketInfo pinfo = { 0, };
   GstFlowReturn result = GST_FLOW_OK;
   GstRTCPBuffer rtcp = { NULL, };
+  GArray *twcc_packets;
 
   g_return_val_if_fail (RTP_IS_SESSION (sess), GST_FLOW_ERROR);
   g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
@@ -3219,8 +3245,12 @@ rtp_session_process_rtcp (RTPSession * sess, GstBuffer * buffer,
 
   GST_DEBUG ("%p, received RTCP packet, avg size %u, %u", &sess->stats,
       sess->stats.avg_rtcp_packet_size, pinfo.bytes);
+  twcc_packets = g_steal_pointer (&sess->twcc_pending);
   RTP_SESSION_UNLOCK (sess);
 
+  if (twcc_packets)
+    rtp_session_process_twcc_packets (sess, twcc_packets);
+
   if (has_report) {
     g_object_notify_by_pspec (G_OBJECT (sess), properties[PROP_STATS]);
   }
@@ -3805,6 +3835,18 @@ typedef struct
   GstBuffer *buffer;
 } ReportOutput;
 
+/* copy of the stats of a remote source for a report block */
+typedef struct
+{
+  guint32 ssrc;
+  guint8 fractionlost;
+  gint32 packetslost;
+  guint32 exthighestseq;
+  guint32 jitter;
+  guint32 lsr;
+  guint32 dlsr;
+} ReportBlock;
+
 typedef struct
 {
   GstRTCPBuffer rtcpbuf;
@@ -3825,6 +3867,8 @@ typedef struct
   GQueue output;
   guint nacked_seqnums;
   gboolean timeout_inactive_sources;
+  /* the sources the report is generated for */
+  GPtrArray *sources;
 } ReportData;
 
 static gboolean
@@ -3878,33 +3922,26 @@ session_start_rtcp (RTPSession * sess, ReportData * data)
   return TRUE;
 }
 
-/* construct a Sender or Receiver Report */
-static void
-session_report_blocks (const gchar * key, RTPSource * source, ReportData * data)
+/* get the stats for the report block of @source in the report of the current
+ * internal source. Returns %FALSE if @source is not reported there. */
+static gboolean
+session_report_block (RTPSource * source, ReportData * data,
+    ReportBlock * rb)
 {
   RTPSession *sess = data->sess;
-  GstRTCPPacket *packet = &data->packet;
-  guint8 fractionlost;
-  gint32 packetslost;
-  guint32 exthighestseq, jitter;
-  guint32 lsr, dlsr;
+  gboolean ret = FALSE;
 
   /* don't report for sources in future generations */
   if (((gint16) (source->generation - sess->generation)) > 0) {
     GST_DEBUG ("source %08x generation %u > %u", source->ssrc,
         source->generation, sess->generation);
-    return;
+    return FALSE;
   }
 
   if (g_hash_table_contains (source->reported_in_sr_of,
           GUINT_TO_POINTER (data->source->ssrc))) {
     GST_DEBUG ("source %08x already reported in this generation", source->ssrc);
-    return;
-  }
-
-  if (gst_rtcp_packet_get_rb_count (packet) == GST_RTCP_MAX_RB_COUNT) {
-    GST_DEBUG ("max RB count reached");
-    return;
+    return FALSE;
   }
 
   /* only report about remote sources */
@@ -3924,26 +3961,57 @@ session_report_blocks (const gchar * key, RTPSource * source, ReportData * data)
   GST_DEBUG ("create RB for SSRC %08x", source->ssrc);
 
   /* get new stats */
-  rtp_source_get_new_rb (source, data->current_time, &fractionlost,
-      &packetslost, &exthighestseq, &jitter, &lsr, &dlsr);
+  rb->ssrc = source->ssrc;
+  rtp_source_get_new_rb (source, data->current_time, &rb->fractionlost,
+      &rb->packetslost, &rb->exthighestseq, &rb->jitter, &rb->lsr, &rb->dlsr);
 
   /* store last generated RR packet */
   source->last_rr.is_valid = TRUE;
   source->last_rr.ssrc = data->source->ssrc;
-  source->last_rr.fractionlost = fractionlost;
-  source->last_rr.packetslost = packetslost;
-  source->last_rr.exthighestseq = exthighestseq;
-  source->last_rr.jitter = jitter;
-  source->last_rr.lsr = lsr;
-  source->last_rr.dlsr = dlsr;
-
-  /* packet is not yet filled, add report block for this source. */
-  gst_rtcp_packet_add_rb (packet, source->ssrc, fractionlost, packetslost,
-      exthighestseq, jitter, lsr, dlsr);
+  source->last_rr.fractionlost = rb->fractionlost;
+  source->last_rr.packetslost = rb->packetslost;
+  source->last_rr.exthighestseq = rb->exthighestseq;
+  source->last_rr.jitter = rb->jitter;
+  source->last_rr.lsr = rb->lsr;
+  source->last_rr.dlsr = rb->dlsr;
+  ret = TRUE;
 
 reported:
   g_hash_table_add (source->reported_in_sr_of,
       GUINT_TO_POINTER (data->source->ssrc));
+
+  return ret;
+}
+
+/* construct the report blocks of a Sender or Receiver Report. The stats of
+ * the sources are copied in batches of RTCP_SOURCES_PER_LOCK, releasing the
+ * session lock in between, and added to the packet afterwards. Sources that
+ * don't fit anymore are left for the next generation. */
+static void
+session_report_blocks (RTPSession * sess, ReportData * data)
+{
+  ReportBlock rbs[GST_RTCP_MAX_RB_COUNT];
+  guint i, n_rbs = 0;
+
+  for (i = 0; i < data->sources->len && n_rbs < GST_RTCP_MAX_RB_COUNT; i++) {
+    if (i > 0 && i % RTCP_SOURCES_PER_LOCK == 0) {
+      RTP_SESSION_UNLOCK (sess);
+      g_thread_yield ();
+      RTP_SESSION_LOCK (sess);
+    }
+    if (session_report_block (g_ptr_array_index (data->sources, i), data,
+            &rbs[n_rbs]))
+      n_rbs++;
+  }
+
+  if (n_rbs == GST_RTCP_MAX_RB_COUNT)
+    GST_DEBUG ("max RB count reached");
+
+  for (i = 0; i < n_rbs; i++) {
+    gst_rtcp_packet_add_rb (&data->packet, rbs[i].ssrc, rbs[i].fractionlost,
+        rbs[i].packetslost, rbs[i].exthighestseq, rbs[i].jitter, rbs[i].lsr,
+        rbs[i].dlsr);
+  }
 }
 
 /* construct FIR */
@@ -4475,10 +4543,42 @@ is_rtcp_time (RTPSession * sess, GstClockTime current_time, ReportData * data)
   return TRUE;
 }
 
+/* Take a reference to all the sources of the session, so that they can be
+ * iterated while the session lock is released. */
+static GPtrArray *
+session_get_sources_snapshot (RTPSession * sess)
+{
+  GHashTable *table = sess->ssrcs[sess->mask_idx];
+  GPtrArray *sources;
+  GHashTableIter iter;
+  RTPSource *source;
+
+  sources = g_ptr_array_new_full (g_hash_table_size (table),
+      (GDestroyNotify) g_object_unref);
+  g_hash_table_iter_init (&iter, table);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & source))
+    g_ptr_array_add (sources, g_object_ref (source));
+
+  return sources;
+}
+
+/* Call @func for all sources of a snapshot. With many sources, the session
+ * lock is released regularly so that the RTP path is not blocked for the whole
+ * RTCP generation. */
 static void
-clone_ssrcs_hashtable (gchar * key, RTPSource * source, GHashTable * hash_table)
+session_foreach_snapshot (RTPSession * sess, GPtrArray * sources,
+    GHFunc func, ReportData * data)
 {
-  g_hash_table_insert (hash_table, key, g_object_ref (source));
+  guint i;
+
+  for (i = 0; i < sources->len; i++) {
+    if (i > 0 && i % RTCP_SOURCES_PER_LOCK == 0) {
+      RTP_SESSION_UNLOCK (sess);
+      g_thread_yield ();
+      RTP_SESSION_LOCK (sess);
+    }
+    func (NULL, g_ptr_array_index (sources, i), data);
+  }
 }
 
 static gboolean
@@ -4566,10 +4666,10 @@ generate_rtcp (const gchar * key, RTPSource * source, ReportData * data)
     make_source_bye (sess, source, data);
     is_bye = TRUE;
   } else if (!data->is_early) {
-    /* loop over all known sources and add report blocks. If we are early, we
-     * just make a minimal RTCP packet and skip this step */
-    g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-        (GHFunc) session_report_blocks, data);
+    /* add report blocks for the known sources. If we are early, we just make
+     * a minimal RTCP packet and skip this step. This might release the
+     * session lock. */
+    session_report_blocks (sess, data);
   }
   if (!data->has_sdes && (!data->is_early || !sess->reduced_size_rtcp
           || sr_req_pending))
@@ -4683,7 +4783,7 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
 {
   GstFlowReturn result = GST_FLOW_OK;
   ReportData data = { GST_RTCP_BUFFER_INIT };
-  GHashTable *table_copy;
+  GPtrArray *sources;
   ReportOutput *output;
   gboolean all_empty = FALSE;
 
@@ -4726,17 +4826,14 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
   sess->conflicting_addresses =
       timeout_conflicting_addresses (sess->conflicting_addresses, current_time);
 
-  /* Make a local copy of the hashtable. We need to do this because the
+  /* Make a local copy of the sources. We need to do this because the
    * cleanup stage below releases the session lock. */
-  table_copy = g_hash_table_new_full (NULL, NULL, NULL,
-      (GDestroyNotify) g_object_unref);
-  g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-      (GHFunc) clone_ssrcs_hashtable, table_copy);
+  sources = session_get_sources_snapshot (sess);
 
   /* Clean up the session, mark the source for removing, this might release the
    * session lock. */
-  g_hash_table_foreach (table_copy, (GHFunc) session_cleanup, &data);
-  g_hash_table_destroy (table_copy);
+  session_foreach_snapshot (sess, sources, (GHFunc) session_cleanup, &data);
+  g_ptr_array_unref (sources);
 
   /* Now remove the marked sources */
   g_hash_table_foreach_remove (sess->ssrcs[sess->mask_idx],
@@ -4752,27 +4849,27 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
   /* check if all the buffers are empty after generation */
   all_empty = TRUE;
 
-  /* Make a local copy of the hashtable. We need to do this because the
+  /* Make a local copy of the sources. We need to do this because the
    * generate_rtcp stage below releases the session lock. */
-  table_copy = g_hash_table_new_full (NULL, NULL, NULL,
-      (GDestroyNotify) g_object_unref);
-  g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-      (GHFunc) clone_ssrcs_hashtable, table_copy);
+  sources = session_get_sources_snapshot (sess);
+  data.sources = sources;
 
   GST_DEBUG
       ("doing RTCP generation %u for %u sources, early %d",
       sess->generation, data.num_to_report, data.is_early);
 
   /* generate RTCP for all internal sources, this might release the
-   * session lock. */
-  g_hash_table_foreach (table_copy, (GHFunc) generate_rtcp, &data);
+   * session lock. The generation and the reported sources are only changed
+   * here, so they stay consistent while the lock is released. */
+  session_foreach_snapshot (sess, sources, (GHFunc) generate_rtcp, &data);
 
-  g_hash_table_foreach (table_copy, (GHFunc) generate_twcc, &data);
+  session_foreach_snapshot (sess, sources, (GHFunc) generate_twcc, &data);
 
   /* update the generation for all the sources that have been reported */
-  g_hash_table_foreach (table_copy, (GHFunc) update_generation, &data);
+  session_foreach_snapshot (sess, sources, (GHFunc) update_generation, &data);
 
-  g_hash_table_destroy (table_copy);
+  data.sources = NULL;
+  g_ptr_array_unref (sources);
 
   /* we keep track of the last report time in order to timeout inactive
    * receivers or senders */
@@ -4852,11 +4949,13 @@ done:
   if (all_empty)
     GST_ERROR ("generated empty RTCP messages for all the sources");
 
-  /* schedule remaining nacks */
+  /* schedule remaining nacks, this releases the session lock */
   RTP_SESSION_LOCK (sess);
-  g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-      (GHFunc) schedule_remaining_nacks, &data);
+  sources = session_get_sources_snapshot (sess);
+  session_foreach_snapshot (sess, sources, (GHFunc) schedule_remaining_nacks,
+      &data);
   RTP_SESSION_UNLOCK (sess);
+  g_ptr_array_unref (sources);
 
   return result;
 }
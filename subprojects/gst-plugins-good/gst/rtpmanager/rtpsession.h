@@ -321,6 +321,10 @@ struct _RTPSession {
 
   /* Transport-wide cc-extension */
   RTPTWCCManager *twcc;
+  /* TWCC feedback parsed from the RTCP packet being processed */
+  GArray *twcc_pending;
+  /* protects twcc_stats, which are updated without the session lock */
+  GMutex twcc_lock;
   RTPTWCCStats *twcc_stats;
 };
 
@@ -288,6 +288,33 @@ rtp_timer_queue_insert_head (RtpTimerQueue * queue, RtpTimer * timer)
     rtp_timer_queue_insert_before (queue, it, timer);
 }
 
+/* Timers are mostly created in seqnum order with increasing timeouts, so the
+ * timer of the previous seqnum is a good starting point to look for the
+ * position of a new timer. This keeps the insertion cost independent of the
+ * number of queued timers when timers for reordered or lost packets land in
+ * the middle of the queue. */
+static gboolean
+rtp_timer_queue_insert_near (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *it;
+
+  it = rtp_timer_queue_find (queue, (guint16) (timer->seqnum - 1));
+  if (it == NULL || it == rtp_timer_queue_get_tail (queue))
+    return FALSE;
+
+  if (rtp_timer_is_later (timer, it)) {
+    while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
+      it = rtp_timer_get_next (it);
+    rtp_timer_queue_insert_after (queue, it, timer);
+  } else {
+    while (rtp_timer_is_sooner (timer, rtp_timer_get_prev (it)))
+      it = rtp_timer_get_prev (it);
+    rtp_timer_queue_insert_before (queue, it, timer);
+  }
+
+  return TRUE;
+}
+
 static void
 rtp_timer_queue_init (RtpTimerQueue * queue)
 {
@@ -397,8 +424,9 @@ rtp_timer_queue_new (void)
  *
  * Insert a timer into the queue. Earliest timer are at the head and then
  * timer are sorted by seqnum (smaller seqnum first). This function is o(n)
- * but it is expected that most timers added are schedule later, in which case
- * the insertion will be faster.
+ * but it is expected that most timers added are schedule later, or close to
+ * the timer of the previous seqnum, in which case the insertion will be
+ * faster.
  *
  * Returns: %FALSE if a timer with the same seqnum already existed
  */
@@ -415,7 +443,7 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
 
   if (timer->timeout == -1)
     rtp_timer_queue_insert_head (queue, timer);
-  else
+  else if (!rtp_timer_queue_insert_near (queue, timer))
     rtp_timer_queue_insert_tail (queue, timer);
 
   g_hash_table_insert (queue->hashtable,
@@ -72,6 +72,14 @@ typedef struct
   gboolean lost;
 } SentPacket;
 
+/* we forget about sent packets that were not reported back to us before
+   half of the seqnum space has been used */
+#define MAX_SENT_PACKETS 0x8000
+#define MIN_SENT_PACKETS_SIZE 256
+
+#define SENT_PACKET_SLOT(twcc,seqnum) \
+    (&(twcc)->sent_packets[(seqnum) & ((twcc)->sent_packets_size - 1)])
+
 struct _RTPTWCCManager
 {
   GObject object;
@@ -87,7 +95,13 @@ struct _RTPTWCCManager
   guint64 fb_pkt_count;
   gint32 last_seqnum;
 
-  GArray *sent_packets;
+  /* ring of sent packets indexed by seqnum, holding sent_packets_len
+     packets starting at first_sent_seqnum */
+  SentPacket *sent_packets;
+  guint sent_packets_size;
+  guint sent_packets_len;
+  guint16 first_sent_seqnum;
+
   GArray *parsed_packets;
   GQueue *rtcp_buffers;
 
@@ -114,8 +128,7 @@ static void
 rtp_twcc_manager_init (RTPTWCCManager * twcc)
 {
   twcc->recv_packets = g_array_new (FALSE, FALSE, sizeof (RecvPacket));
-  twcc->sent_packets = g_array_new (FALSE, FALSE, sizeof (SentPacket));
-  twcc->parsed_packets = g_array_new (FALSE, FALSE, sizeof (RecvPacket));
+  twcc->parsed_packets = g_array_new (FALSE, FALSE, sizeof (RTPTWCCPacket));
 
   twcc->rtcp_buffers = g_queue_new ();
 
@@ -137,7 +150,7 @@ rtp_twcc_manager_finalize (GObject * object)
   RTPTWCCManager *twcc = RTP_TWCC_MANAGER_CAST (object);
 
   g_array_unref (twcc->recv_packets);
-  g_array_unref (twcc->sent_packets);
+  g_free (twcc->sent_packets);
   g_array_unref (twcc->parsed_packets);
   g_queue_free_full (twcc->rtcp_buffers, (GDestroyNotify) gst_buffer_unref);
 
@@ -250,6 +263,36 @@ sent_packet_init (SentPacket * packet, guint16 seqnum, RTPPacketInfo * pinfo,
   packet->lost = FALSE;
 }
 
+static void
+_append_sent_packet (RTPTWCCManager * twcc, const SentPacket * packet)
+{
+  /* seqnums are handed out in order, so the sent packets are contiguous */
+  if (twcc->sent_packets_len == 0) {
+    twcc->first_sent_seqnum = packet->seqnum;
+  } else if (twcc->sent_packets_len == MAX_SENT_PACKETS) {
+    twcc->first_sent_seqnum++;
+    twcc->sent_packets_len--;
+  }
+
+  if (twcc->sent_packets_len == twcc->sent_packets_size) {
+    SentPacket *old_packets = twcc->sent_packets;
+    guint old_size = twcc->sent_packets_size;
+    guint i;
+
+    twcc->sent_packets_size = MAX (old_size * 2, MIN_SENT_PACKETS_SIZE);
+    twcc->sent_packets = g_new (SentPacket, twcc->sent_packets_size);
+    for (i = 0; i < twcc->sent_packets_len; i++) {
+      guint16 seqnum = twcc->first_sent_seqnum + i;
+
+      *SENT_PACKET_SLOT (twcc, seqnum) = old_packets[seqnum & (old_size - 1)];
+    }
+    g_free (old_packets);
+  }
+
+  *SENT_PACKET_SLOT (twcc, packet->seqnum) = *packet;
+  twcc->sent_packets_len++;
+}
+
 static void
 _set_twcc_seqnum_data (RTPTWCCManager * twcc, RTPPacketInfo * pinfo,
     GstBuffer * buf, guint8 ext_id)
@@ -265,7 +308,7 @@ _set_twcc_seqnum_data (RTPTWCCManager * twcc, RTPPacketInfo * pinfo,
 
       GST_WRITE_UINT16_BE (data, seqnum);
       sent_packet_init (&packet, seqnum, pinfo, &rtp);
-      g_array_append_val (twcc->sent_packets, packet);
+      _append_sent_packet (twcc, &packet);
 
       GST_LOG ("Send: twcc-seqnum: %u, pt: %u, marker: %d, len: %u, ts: %"
           GST_TIME_FORMAT, seqnum, packet.pt, pinfo->marker, packet.size,
@@ -585,7 +628,7 @@ rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
   guint16 packet_count;
   GstClockTime base_time;
   GstClockTime ts_rounded;
-  guint i;
+  guint i, n;
   GArray *packet_chunks = g_array_new (FALSE, FALSE, 2);
   RTPTWCCHeader header;
   guint header_size = sizeof (RTPTWCCHeader);
@@ -603,19 +646,20 @@ rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
 
   g_array_sort (twcc->recv_packets, _twcc_seqnum_sort);
 
-  /* Quick scan to remove duplicates */
-  prev = &g_array_index (twcc->recv_packets, RecvPacket, 0);
-  for (i = 1; i < twcc->recv_packets->len;) {
+  /* Quick scan to remove duplicates, compacting the array in one pass */
+  for (i = 1, n = 1; i < twcc->recv_packets->len; i++) {
     RecvPacket *cur = &g_array_index (twcc->recv_packets, RecvPacket, i);
 
+    prev = &g_array_index (twcc->recv_packets, RecvPacket, n - 1);
     if (prev->seqnum == cur->seqnum) {
       GST_DEBUG ("Removing duplicate packet #%u", cur->seqnum);
-      g_array_remove_index (twcc->recv_packets, i);
     } else {
-      prev = cur;
-      i += 1;
+      if (n != i)
+        *(prev + 1) = *cur;
+      n++;
     }
   }
+  g_array_set_size (twcc->recv_packets, n);
 
   /* get first and last packet */
   first = &g_array_index (twcc->recv_packets, RecvPacket, 0);
@@ -945,20 +989,20 @@ _parse_status_vector_chunk (GstBitReader * reader, GArray * twcc_packets,
 static void
 _prune_sent_packets (RTPTWCCManager * twcc, GArray * twcc_packets)
 {
-  SentPacket *first;
   RTPTWCCPacket *last;
   guint16 last_idx;
 
-  if (twcc_packets->len == 0 || twcc->sent_packets->len == 0)
+  if (twcc_packets->len == 0 || twcc->sent_packets_len == 0)
     return;
 
-  first = &g_array_index (twcc->sent_packets, SentPacket, 0);
   last = &g_array_index (twcc_packets, RTPTWCCPacket, twcc_packets->len - 1);
 
-  last_idx = last->seqnum - first->seqnum;
+  last_idx = last->seqnum - twcc->first_sent_seqnum;
 
-  if (last_idx < twcc->sent_packets->len)
-    g_array_remove_range (twcc->sent_packets, 0, last_idx);
+  if (last_idx < twcc->sent_packets_len) {
+    twcc->first_sent_seqnum += last_idx;
+    twcc->sent_packets_len -= last_idx;
+  }
 }
 
 static void
@@ -1012,6 +1056,8 @@ done:
   return;
 }
 
+/* The returned array is reused by the next call, so it has to be released
+   before parsing the next feedback */
 GArray *
 rtp_twcc_manager_parse_fci (RTPTWCCManager * twcc,
     guint8 * fci_data, guint fci_length)
@@ -1026,7 +1072,6 @@ rtp_twcc_manager_parse_fci (RTPTWCCManager * twcc,
   guint packets_parsed = 0;
   guint fci_parsed;
   guint i;
-  SentPacket *first_sent_pkt = NULL;
 
   if (fci_length < 10) {
     GST_WARNING ("Malformed TWCC RTCP feedback packet");
@@ -1047,8 +1092,8 @@ rtp_twcc_manager_parse_fci (RTPTWCCManager * twcc,
       base_seqnum, packet_count, GST_TIME_ARGS (base_time * REF_TIME_UNIT),
       fb_pkt_count);
 
-  twcc_packets = g_array_sized_new (FALSE, FALSE,
-      sizeof (RTPTWCCPacket), packet_count);
+  twcc_packets = g_array_ref (twcc->parsed_packets);
+  g_array_set_size (twcc_packets, 0);
 
   _check_for_lost_packets (twcc, twcc_packets,
       base_seqnum, packet_count, fb_pkt_count);
@@ -1072,9 +1117,6 @@ rtp_twcc_manager_parse_fci (RTPTWCCManager * twcc,
     fci_parsed += 2;
   }
 
-  if (twcc->sent_packets->len > 0)
-    first_sent_pkt = &g_array_index (twcc->sent_packets, SentPacket, 0);
-
   if (twcc->remote_ts_base == -1) {
     /* Add an initial offset of 1 << 24 so that we don't risk going below 0 if
      * a future extended timestamp is earlier than the first. */
@@ -1121,11 +1163,11 @@ rtp_twcc_manager_parse_fci (RTPTWCCManager * twcc,
           pkt->status);
     }
 
-    if (first_sent_pkt) {
+    if (twcc->sent_packets_len > 0) {
       SentPacket *found = NULL;
-      guint16 sent_idx = pkt->seqnum - first_sent_pkt->seqnum;
-      if (sent_idx < twcc->sent_packets->len)
-        found = &g_array_index (twcc->sent_packets, SentPacket, sent_idx);
+      guint16 sent_idx = pkt->seqnum - twcc->first_sent_seqnum;
+      if (sent_idx < twcc->sent_packets_len)
+        found = SENT_PACKET_SLOT (twcc, pkt->seqnum);
       if (found && found->seqnum == pkt->seqnum) {
         if (GST_CLOCK_TIME_IS_VALID (found->socket_ts)) {
           pkt->local_ts = found->socket_ts;
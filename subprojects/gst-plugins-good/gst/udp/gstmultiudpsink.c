@@ -44,6 +44,10 @@
 
 #include <gio/gnetworking.h>
 
+#ifndef G_PLATFORM_WIN32
+#include <netinet/udp.h>
+#endif
+
 #include "gst/net/net.h"
 #include "gst/glib-compat-private.h"
 
@@ -52,6 +56,87 @@ GST_DEBUG_CATEGORY_STATIC (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* maximum number of packets the kernel accepts in a single GSO send */
+#define UDP_GSO_MAX_SEGMENTS 64
+
+#ifdef UDP_SEGMENT
+GType gst_udp_segment_message_get_type (void);
+
+#define GST_TYPE_UDP_SEGMENT_MESSAGE          (gst_udp_segment_message_get_type ())
+#define GST_UDP_SEGMENT_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessage))
+#define GST_IS_UDP_SEGMENT_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_UDP_SEGMENT_MESSAGE))
+
+typedef struct _GstUDPSegmentMessage GstUDPSegmentMessage;
+typedef struct _GstUDPSegmentMessageClass GstUDPSegmentMessageClass;
+
+struct _GstUDPSegmentMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Asks the kernel to split a message into packets of gso_size bytes */
+struct _GstUDPSegmentMessage
+{
+  GSocketControlMessage parent;
+  guint16 gso_size;
+};
+
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  memcpy (data, &GST_UDP_SEGMENT_MESSAGE (message)->gso_size,
+      sizeof (guint16));
+}
+
+static GSocketControlMessage *
+gst_udp_segment_message_deserialize (gint level, gint type, gsize size,
+    gpointer data)
+{
+  /* only ever sent */
+  return NULL;
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * message)
+{
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+  scm_class->deserialize = gst_udp_segment_message_deserialize;
+}
+#endif
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -92,6 +177,7 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_GSO                FALSE
 
 enum
 {
@@ -114,7 +200,10 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_GSO,
+  PROP_PACKETS_SERVED,
+  PROP_SEND_CALLS
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -351,6 +440,50 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Hand runs of equally sized packets of a buffer list going to the same
+   * client to the kernel as a single message, which is then split into the
+   * original packets by the kernel or the network card (UDP generic
+   * segmentation offload). Falls back to sending the packets one by one if
+   * the kernel or the network device doesn't support it.
+   *
+   * Only supported on Linux, takes effect when the sink is started.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "GSO",
+          "Use UDP generic segmentation offload for runs of equally sized "
+          "packets", DEFAULT_GSO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:packets-served:
+   *
+   * Total number of packets sent to all clients. Together with
+   * #GstMultiUDPSink:send-calls, this gives the number of packets sent per
+   * system call.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_PACKETS_SERVED,
+      g_param_spec_uint64 ("packets-served", "Packets served",
+          "Total number of packets sent to all clients", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:send-calls:
+   *
+   * Number of calls made to the kernel to send packets.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_SEND_CALLS,
+      g_param_spec_uint64 ("send-calls", "Send calls",
+          "Number of calls made to the kernel to send packets", 0,
+          G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -419,6 +552,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->gso = DEFAULT_GSO;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -524,6 +658,7 @@ static void
 gst_multiudpsink_finalize (GObject * object)
 {
   GstMultiUDPSink *sink;
+  guint i;
 
   sink = GST_MULTIUDPSINK (object);
 
@@ -557,6 +692,10 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  for (i = 0; i < sink->n_gso_msgs; i++)
+    g_object_unref (sink->gso_msgs[i]);
+  g_free (sink->gso_msgs);
+  sink->gso_msgs = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -634,6 +773,111 @@ gst_udp_address_get_string (GSocketAddress * addr, gchar * s, gsize size)
   return s;
 }
 
+static guint
+gst_udp_message_get_gso_size (GstOutputMessage * msg)
+{
+#ifdef UDP_SEGMENT
+  if (msg->num_control_messages == 1
+      && GST_IS_UDP_SEGMENT_MESSAGE (msg->control_messages[0]))
+    return GST_UDP_SEGMENT_MESSAGE (msg->control_messages[0])->gso_size;
+#endif
+
+  return 0;
+}
+
+static guint
+gst_udp_message_get_n_packets (GstOutputMessage * msg)
+{
+  guint gso_size = gst_udp_message_get_gso_size (msg);
+  gsize size;
+
+  if (gso_size == 0)
+    return 1;
+
+  size = gst_udp_calc_message_size (msg);
+
+  return MAX (1, (size + gso_size - 1) / gso_size);
+}
+
+#ifdef UDP_SEGMENT
+static void
+gst_multiudpsink_set_gso_size (GstMultiUDPSink * sink, GstOutputMessage * msg,
+    guint idx, guint16 gso_size)
+{
+  guint i;
+
+  if (sink->n_gso_msgs <= idx) {
+    guint n = GST_ROUND_UP_16 (idx + 1);
+
+    sink->gso_msgs = g_renew (GSocketControlMessage *, sink->gso_msgs, n);
+    for (i = sink->n_gso_msgs; i < n; i++)
+      sink->gso_msgs[i] = g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+    sink->n_gso_msgs = n;
+  }
+
+  GST_UDP_SEGMENT_MESSAGE (sink->gso_msgs[idx])->gso_size = gso_size;
+  msg->control_messages = &sink->gso_msgs[idx];
+  msg->num_control_messages = 1;
+}
+#endif
+
+static GstFlowReturn gst_multiudpsink_send_messages (GstMultiUDPSink * sink,
+    GSocket * socket, GstOutputMessage * messages, guint num_messages);
+
+/* Sends the packets of a GSO message one by one, after the kernel refused to
+ * do the segmentation for us */
+static GstFlowReturn
+gst_multiudpsink_send_segments (GstMultiUDPSink * sink, GSocket * socket,
+    GstOutputMessage * msg, guint gso_size)
+{
+  GstOutputMessage *seg_msgs;
+  GOutputVector *seg_vecs;
+  GstFlowReturn flow_ret;
+  gsize msg_size, offset = 0;
+  guint n_segs, n_vecs = 0, v = 0, i;
+
+  msg_size = gst_udp_calc_message_size (msg);
+  n_segs = (msg_size + gso_size - 1) / gso_size;
+
+  seg_msgs = g_newa (GstOutputMessage, n_segs);
+  seg_vecs = g_newa (GOutputVector, msg->num_vectors + n_segs);
+
+  for (i = 0; i < n_segs; ++i) {
+    gsize remaining = MIN (gso_size, msg_size - i * gso_size);
+
+    seg_msgs[i].address = msg->address;
+    seg_msgs[i].vectors = &seg_vecs[n_vecs];
+    seg_msgs[i].num_vectors = 0;
+    seg_msgs[i].bytes_sent = 0;
+    seg_msgs[i].control_messages = NULL;
+    seg_msgs[i].num_control_messages = 0;
+
+    while (remaining > 0) {
+      const GOutputVector *vec = &msg->vectors[v];
+      gsize len = MIN (remaining, vec->size - offset);
+
+      seg_vecs[n_vecs].buffer = (const guint8 *) vec->buffer + offset;
+      seg_vecs[n_vecs].size = len;
+      n_vecs++;
+      seg_msgs[i].num_vectors++;
+
+      remaining -= len;
+      offset += len;
+      if (offset == vec->size) {
+        v++;
+        offset = 0;
+      }
+    }
+  }
+
+  flow_ret = gst_multiudpsink_send_messages (sink, socket, seg_msgs, n_segs);
+
+  for (i = 0; i < n_segs; ++i)
+    msg->bytes_sent += seg_msgs[i].bytes_sent;
+
+  return flow_ret;
+}
+
 /* Wrapper around g_socket_send_messages() plus error handling (ignoring).
  * Returns FALSE if we got cancelled, otherwise TRUE. */
 static GstFlowReturn
@@ -645,12 +889,18 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
   while (num_messages > 0) {
     gchar astr[64] G_GNUC_UNUSED;
     GError *err = NULL;
-    guint msg_size, skip, i;
+    guint msg_size, gso_size, skip, i;
     gint ret, err_idx;
 
     ret = g_socket_send_messages (socket, messages, num_messages, 0,
         sink->cancellable, &err);
 
+    if (G_LIKELY (ret > 0)) {
+      sink->send_calls++;
+      for (i = 0; i < (guint) ret; ++i)
+        sink->packets_served += gst_udp_message_get_n_packets (&messages[i]);
+    }
+
     if (G_UNLIKELY (ret < 0)) {
       GstOutputMessage *msg;
 
@@ -674,6 +924,29 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
       msg = &messages[err_idx];
       msg_size = gst_udp_calc_message_size (msg);
 
+      /* the kernel or the network device can't segment this for us, disable
+       * GSO and send the packets of this message separately */
+      gso_size = gst_udp_message_get_gso_size (msg);
+      if (gso_size > 0
+          && (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)
+              || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED)
+              || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_FAILED))) {
+        GstFlowReturn flow_ret;
+
+        GST_WARNING_OBJECT (sink, "UDP GSO send of %u bytes failed, "
+            "disabling GSO: %s", msg_size, err->message);
+        g_clear_error (&err);
+        sink->gso_enabled = FALSE;
+
+        flow_ret = gst_multiudpsink_send_segments (sink, socket, msg, gso_size);
+        if (flow_ret != GST_FLOW_OK)
+          return flow_ret;
+
+        messages += err_idx + 1;
+        num_messages -= err_idx + 1;
+        continue;
+      }
+
       GST_LOG_OBJECT (sink, "error sending %u bytes to client %s: %s", msg_size,
           gst_udp_address_get_string (msg->address, astr, sizeof (astr)),
           err->message);
@@ -725,9 +998,11 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   GstMapInfo *map_infos;
   GstFlowReturn flow_ret;
   guint num_addr_v4, num_addr_v6;
-  guint num_addr, num_msgs;
+  guint num_addr, num_msgs, num_tmpl;
   guint i, j, mem;
   gsize size = 0;
+  gsize *sizes;
+  guint *packets;
   GList *l;
 
   send_duplicates = sink->send_duplicates;
@@ -784,29 +1059,63 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   }
   msgs = sink->messages;
 
-  /* populate first num_buffers messages with output vectors for the buffers */
+  sizes = g_newa (gsize, num_buffers);
+  packets = g_newa (guint, num_buffers);
+
   for (i = 0, mem = 0; i < num_buffers; ++i) {
-    size += fill_vectors (&vecs[mem], &map_infos[mem], mem_nums[i], buffers[i]);
-    msgs[i].vectors = &vecs[mem];
-    msgs[i].num_vectors = mem_nums[i];
-    msgs[i].num_control_messages = 0;
-    msgs[i].bytes_sent = 0;
-    msgs[i].control_messages = NULL;
-    msgs[i].address = clients[0]->addr;
+    sizes[i] = fill_vectors (&vecs[mem], &map_infos[mem], mem_nums[i],
+        buffers[i]);
+    size += sizes[i];
     mem += mem_nums[i];
   }
 
+  /* populate the first num_tmpl messages with output vectors for the buffers,
+   * one message per buffer. With GSO, a run of equally sized buffers goes
+   * into a single message instead, of which only the last one may be
+   * smaller */
+  for (i = 0, mem = 0, num_tmpl = 0; i < num_buffers; ++num_tmpl) {
+    GstOutputMessage *msg = &msgs[num_tmpl];
+    gsize seg_size = sizes[i], msg_size = sizes[i];
+
+    msg->vectors = &vecs[mem];
+    msg->num_vectors = mem_nums[i];
+    msg->num_control_messages = 0;
+    msg->bytes_sent = 0;
+    msg->control_messages = NULL;
+    msg->address = clients[0]->addr;
+    packets[num_tmpl] = 1;
+    mem += mem_nums[i++];
+
+    while (sink->gso_enabled && seg_size > 0 && i < num_buffers
+        && sizes[i] > 0 && sizes[i] <= seg_size
+        && msg_size + sizes[i] <= UDP_MAX_SIZE
+        && packets[num_tmpl] < UDP_GSO_MAX_SEGMENTS) {
+      msg->num_vectors += mem_nums[i];
+      msg_size += sizes[i];
+      packets[num_tmpl]++;
+      mem += mem_nums[i];
+      if (sizes[i++] < seg_size)
+        break;
+    }
+
+#ifdef UDP_SEGMENT
+    if (packets[num_tmpl] > 1)
+      gst_multiudpsink_set_gso_size (sink, msg, num_tmpl, seg_size);
+#endif
+  }
+
   /* FIXME: how about some locking? (there wasn't any before either, but..) */
   sink->bytes_to_serve += size;
 
-  /* now copy the pre-filled num_buffer messages over to the next num_buffer
+  /* now copy the pre-filled num_tmpl messages over to the next num_tmpl
    * messages for the next client, where we also change the target address */
   for (i = 1; i < num_addr; ++i) {
-    for (j = 0; j < num_buffers; ++j) {
-      msgs[i * num_buffers + j] = msgs[j];
-      msgs[i * num_buffers + j].address = clients[i]->addr;
+    for (j = 0; j < num_tmpl; ++j) {
+      msgs[i * num_tmpl + j] = msgs[j];
+      msgs[i * num_tmpl + j].address = clients[i]->addr;
     }
   }
+  num_msgs = num_addr * num_tmpl;
 
   /* now send it! */
 
@@ -815,8 +1124,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
         msgs, num_msgs);
   } else {
-    guint num_msgs_v4 = num_buffers * num_addr_v4;
-    guint num_msgs_v6 = num_buffers * num_addr_v6;
+    guint num_msgs_v4 = num_tmpl * num_addr_v4;
+    guint num_msgs_v6 = num_tmpl * num_addr_v6;
 
     /* our client list is sorted with IPv4 clients first and IPv6 ones last */
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
@@ -838,13 +1147,13 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   for (i = 0; i < num_addr; ++i) {
     GstUDPClient *client = clients[i];
 
-    for (j = 0; j < num_buffers; ++j) {
+    for (j = 0; j < num_tmpl; ++j) {
       gsize bytes_sent;
 
-      bytes_sent = msgs[i * num_buffers + j].bytes_sent;
+      bytes_sent = msgs[i * num_tmpl + j].bytes_sent;
 
       client->bytes_sent += bytes_sent;
-      client->packets_sent++;
+      client->packets_sent += packets[j];
       sink->bytes_served += bytes_sent;
     }
     gst_udp_client_unref (client);
@@ -1094,6 +1403,9 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1167,6 +1479,15 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
+    case PROP_PACKETS_SERVED:
+      g_value_set_uint64 (value, udpsink->packets_served);
+      break;
+    case PROP_SEND_CALLS:
+      g_value_set_uint64 (value, udpsink->send_calls);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1436,6 +1757,30 @@ gst_multiudpsink_start (GstBaseSink * bsink)
 
   sink->bytes_to_serve = 0;
   sink->bytes_served = 0;
+  sink->packets_served = 0;
+  sink->send_calls = 0;
+
+  sink->gso_enabled = FALSE;
+  if (sink->gso) {
+#ifdef UDP_SEGMENT
+    GSocket *socket = sink->used_socket ? sink->used_socket :
+        sink->used_socket_v6;
+    gint gso_size;
+
+    /* kernels without UDP GSO support don't know the option */
+    if (g_socket_get_option (socket, IPPROTO_UDP, UDP_SEGMENT, &gso_size,
+            &err)) {
+      GST_DEBUG_OBJECT (sink, "UDP GSO enabled");
+      sink->gso_enabled = TRUE;
+    } else {
+      GST_WARNING_OBJECT (sink, "UDP GSO not supported: %s", err->message);
+      g_clear_error (&err);
+    }
+#else
+    GST_WARNING_OBJECT (sink, "gso was requested but UDP_SEGMENT is not "
+        "defined");
+#endif
+  }
 
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
@@ -102,6 +102,16 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+
+  /* UDP generic segmentation offload */
+  gboolean       gso;
+  gboolean       gso_enabled;
+  GSocketControlMessage **gso_msgs;
+  guint          n_gso_msgs;
+
+  /* stats */
+  guint64        packets_served;
+  guint64        send_calls;
 };
 
 struct _GstMultiUDPSinkClass {
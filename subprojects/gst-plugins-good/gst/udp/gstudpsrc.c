@@ -125,6 +125,7 @@
  * on non-Windows and can be included after glib.h */
 #ifndef G_PLATFORM_WIN32
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 #endif
 
 /* Control messages for getting the destination address */
@@ -507,6 +508,88 @@ gst_socket_timestamp_message_class_init (GstSocketTimestampMessageClass * class)
 }
 #endif
 
+#ifdef UDP_GRO
+GType gst_udp_gro_message_get_type (void);
+
+#define GST_TYPE_UDP_GRO_MESSAGE          (gst_udp_gro_message_get_type ())
+#define GST_UDP_GRO_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessage))
+#define GST_UDP_GRO_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessageClass))
+#define GST_IS_UDP_GRO_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_IS_UDP_GRO_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_UDP_GRO_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessageClass))
+
+typedef struct _GstUDPGROMessage GstUDPGROMessage;
+typedef struct _GstUDPGROMessageClass GstUDPGROMessageClass;
+
+struct _GstUDPGROMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Size of the segments the kernel coalesced into a single datagram */
+struct _GstUDPGROMessage
+{
+  GSocketControlMessage parent;
+  gint gso_size;
+};
+
+G_DEFINE_TYPE (GstUDPGROMessage, gst_udp_gro_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_gro_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (gint);
+}
+
+static int
+gst_udp_gro_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_gro_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_GRO;
+}
+
+static GSocketControlMessage *
+gst_udp_gro_message_deserialize (gint level, gint type, gsize size,
+    gpointer data)
+{
+  GstUDPGROMessage *message;
+
+  if (level != IPPROTO_UDP || type != UDP_GRO)
+    return NULL;
+
+  if (size < sizeof (gint))
+    return NULL;
+
+  message = g_object_new (GST_TYPE_UDP_GRO_MESSAGE, NULL);
+  memcpy (&message->gso_size, data, sizeof (gint));
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_udp_gro_message_init (GstUDPGROMessage * message)
+{
+}
+
+static void
+gst_udp_gro_message_class_init (GstUDPGROMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_gro_message_get_size;
+  scm_class->get_level = gst_udp_gro_message_get_level;
+  scm_class->get_type = gst_udp_gro_message_get_msg_type;
+  scm_class->deserialize = gst_udp_gro_message_deserialize;
+}
+#endif
+
 static gboolean
 gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 {
@@ -555,6 +638,27 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+static GstStaticCaps unix_reference_timestamp_caps =
+GST_STATIC_CAPS ("timestamp/x-unix");
+
+/* We only get woken up once packets are there, don't block in the batched
+ * receive waiting for more */
+#ifdef MSG_DONTWAIT
+#define UDP_BATCH_RECEIVE_FLAGS MSG_DONTWAIT
+#else
+#define UDP_BATCH_RECEIVE_FLAGS 0
+#endif
+
+struct _GstUDPSrcBatchSlot
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GInputVector vec;
+  GSocketAddress *addr;
+  GSocketControlMessage **msgs;
+  guint n_msgs;
+};
+
 #define UDP_DEFAULT_PORT                5004
 #define UDP_DEFAULT_MULTICAST_GROUP     "0.0.0.0"
 #define UDP_DEFAULT_MULTICAST_IFACE     NULL
@@ -572,6 +676,8 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
 #define UDP_DEFAULT_MULTICAST_SOURCE   NULL
+#define UDP_DEFAULT_BATCH_SIZE         1
+#define UDP_DEFAULT_GRO                FALSE
 
 enum
 {
@@ -596,6 +702,8 @@ enum
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
   PROP_MULTICAST_SOURCE,
+  PROP_BATCH_SIZE,
+  PROP_GRO,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -604,6 +712,8 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
 
 static void gst_udpsrc_finalize (GObject * object);
@@ -649,6 +759,9 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
 #ifdef SO_TIMESTAMPNS
   GST_TYPE_SOCKET_TIMESTAMP_MESSAGE;
 #endif
+#ifdef UDP_GRO
+  GST_TYPE_UDP_GRO_MESSAGE;
+#endif
 
   gobject_class->set_property = gst_udpsrc_set_property;
   gobject_class->get_property = gst_udpsrc_get_property;
@@ -798,6 +911,39 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           UDP_DEFAULT_MULTICAST_SOURCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of packets to read with a single system call. When bigger
+   * than 1, packets are pushed downstream as buffer lists and each buffer is
+   * timestamped individually.
+   *
+   * In this mode packets bigger than #GstUDPSrc:mtu are dropped.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Maximum number of packets to read per system call, pushed "
+          "downstream as buffer lists if bigger than 1", 1, 1024,
+          UDP_DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstUDPSrc:gro:
+   *
+   * Let the kernel coalesce consecutive packets of a flow into a single
+   * datagram (UDP generic receive offload) when #GstUDPSrc:batch-size is
+   * bigger than 1. udpsrc splits them again into the original packets
+   * without copying. Only supported on Linux, takes effect when the socket
+   * is opened.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_GRO,
+      g_param_spec_boolean ("gro", "GRO",
+          "Enable UDP generic receive offload in batched mode",
+          UDP_DEFAULT_GRO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -812,6 +958,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->unlock_stop = gst_udpsrc_unlock_stop;
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
+  gstbasesrc_class->create = gst_udpsrc_create;
 
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
@@ -840,6 +987,9 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
+  udpsrc->gro = UDP_DEFAULT_GRO;
+  g_queue_init (&udpsrc->gro_spare);
   udpsrc->source_list =
       g_ptr_array_new_with_free_func ((GDestroyNotify) g_free);
 
@@ -935,6 +1085,608 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   g_clear_object (&src->cancellable);
 }
 
+/* optimization: use messages only in multicast mode and
+ * if we can't let the kernel do the filtering for us */
+static gboolean
+gst_udpsrc_needs_control_messages (GstUDPSrc * udpsrc)
+{
+  gboolean res;
+
+  res =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
+#ifdef IP_MULTICAST_ALL
+  if (g_inet_address_get_family (g_inet_socket_address_get_address
+          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
+    res = FALSE;
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
+    res = TRUE;
+#endif
+  /* the segment size of coalesced packets comes as a control message */
+  if (udpsrc->gro_enabled)
+    res = TRUE;
+
+  return res;
+}
+
+/* wait until the socket is readable, posting timeout messages meanwhile */
+static GstFlowReturn
+gst_udpsrc_wait (GstUDPSrc * udpsrc)
+{
+  GError *err = NULL;
+  gboolean try_again;
+
+  do {
+    gint64 timeout;
+
+    try_again = FALSE;
+
+    if (udpsrc->timeout)
+      timeout = udpsrc->timeout / 1000;
+    else
+      timeout = -1;
+
+    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
+
+    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
+            timeout, udpsrc->cancellable, &err)) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        goto stopped;
+      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        g_clear_error (&err);
+        /* timeout, post element message */
+        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
+            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
+                gst_structure_new ("GstUDPSrcTimeout",
+                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
+      } else {
+        goto select_error;
+      }
+
+      try_again = TRUE;
+    }
+  } while (G_UNLIKELY (try_again));
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+}
+
+/* Handles the control messages received along with a packet: checks the
+ * destination address, sets the DTS of @outbuf from the socket timestamp and
+ * retrieves the segment size of coalesced packets. Takes ownership of @msgs.
+ * Returns %TRUE if the packet was sent to a different multicast address and
+ * must be dropped. */
+static gboolean
+gst_udpsrc_handle_control_messages (GstUDPSrc * udpsrc, GstBuffer * outbuf,
+    GSocketControlMessage ** msgs, gint n_msgs, gint * gro_size)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
+
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+      GstCaps *ts_caps;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      /* keep the kernel timestamp around for elements downstream */
+      ts_caps = gst_static_caps_get (&unix_reference_timestamp_caps);
+      gst_buffer_add_reference_timestamp_meta (outbuf, ts_caps, socket_ts,
+          GST_CLOCK_TIME_NONE);
+      gst_caps_unref (ts_caps);
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+          } else {
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+#ifdef UDP_GRO
+    if (GST_IS_UDP_GRO_MESSAGE (msgs[i]) && gro_size)
+      *gro_size = GST_UDP_GRO_MESSAGE (msgs[i])->gso_size;
+#endif
+  }
+
+  for (i = 0; i < n_msgs; i++) {
+    g_object_unref (msgs[i]);
+  }
+  g_free (msgs);
+
+  return skip_packet;
+}
+
+static GstClockTime
+gst_udpsrc_get_running_time (GstUDPSrc * udpsrc)
+{
+  GstClock *clock;
+  GstClockTime now, base_time, running_time = GST_CLOCK_TIME_NONE;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+  if (clock != NULL) {
+    now = gst_clock_get_time (clock);
+    base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+    running_time = now > base_time ? now - base_time : 0;
+    gst_object_unref (clock);
+  }
+
+  return running_time;
+}
+
+static void
+gst_udpsrc_ensure_batch (GstUDPSrc * udpsrc, guint n_slots)
+{
+  if (udpsrc->batch_alloc >= n_slots)
+    return;
+
+  g_free (udpsrc->batch_msgs);
+  g_free (udpsrc->batch_slots);
+  udpsrc->batch_msgs = g_new0 (GInputMessage, n_slots);
+  udpsrc->batch_slots = g_new0 (GstUDPSrcBatchSlot, n_slots);
+  udpsrc->batch_alloc = n_slots;
+}
+
+static void
+gst_udpsrc_free_batch (GstUDPSrc * udpsrc)
+{
+  g_clear_pointer (&udpsrc->batch_msgs, g_free);
+  g_clear_pointer (&udpsrc->batch_slots, g_free);
+  udpsrc->batch_alloc = 0;
+  g_queue_clear_full (&udpsrc->gro_spare, (GDestroyNotify) gst_buffer_unref);
+}
+
+/* In GRO mode every packet can be a datagram of up to 64k coalesced by the
+ * kernel, which doesn't fit the pool buffers. These receive buffers are only
+ * passed downstream for large coalesced datagrams, all others are copied out
+ * and the receive buffers reused for the next call. */
+static GstFlowReturn
+gst_udpsrc_acquire_batch_buffer (GstUDPSrc * udpsrc, GstBufferPool * pool,
+    GstBuffer ** buffer)
+{
+  GstStructure *config;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+
+  if (!udpsrc->gro_enabled)
+    return gst_buffer_pool_acquire_buffer (pool, buffer, NULL);
+
+  if ((*buffer = g_queue_pop_head (&udpsrc->gro_spare)))
+    return GST_FLOW_OK;
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &allocator, &params);
+  *buffer =
+      gst_buffer_new_allocate (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
+  gst_structure_free (config);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  return *buffer ? GST_FLOW_OK : GST_FLOW_ERROR;
+}
+
+static void
+gst_udpsrc_release_batch_buffer (GstUDPSrc * udpsrc, GstBuffer * buffer)
+{
+  GstBuffer *spare;
+
+  if (!udpsrc->gro_enabled) {
+    gst_buffer_unref (buffer);
+    return;
+  }
+
+  /* only keep the memory, not the metadata of the packet received into it */
+  spare = gst_buffer_new ();
+  gst_buffer_copy_into (spare, buffer, GST_BUFFER_COPY_MEMORY, 0, -1);
+  gst_buffer_unref (buffer);
+  g_queue_push_tail (&udpsrc->gro_spare, spare);
+}
+
+/* Copies @size bytes at @pos of the receive buffer @buffer, and its metadata,
+ * into a buffer from @pool, or into a new buffer if they don't fit */
+static GstFlowReturn
+gst_udpsrc_copy_packet (GstUDPSrc * udpsrc, GstBufferPool * pool,
+    GstBuffer * buffer, gsize pos, gsize size, GstBuffer ** outbuf)
+{
+  GstFlowReturn ret;
+  GstMapInfo map;
+
+  ret = gst_buffer_pool_acquire_buffer (pool, outbuf, NULL);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
+  if (G_UNLIKELY (gst_buffer_get_size (*outbuf) < size)) {
+    gst_buffer_unref (*outbuf);
+    *outbuf = gst_buffer_new_allocate (NULL, size, NULL);
+  } else {
+    gst_buffer_resize (*outbuf, 0, size);
+  }
+
+  if (!gst_buffer_map (*outbuf, &map, GST_MAP_WRITE)) {
+    gst_clear_buffer (outbuf);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    return GST_FLOW_ERROR;
+  }
+  gst_buffer_extract (buffer, pos, map.data, size);
+  gst_buffer_unmap (*outbuf, &map);
+
+  gst_buffer_copy_into (*outbuf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+
+  return GST_FLOW_OK;
+}
+
+/* Receives up to batch-size packets with a single system call. Coalesced GRO
+ * datagrams are split back into the original packets. Those only share the
+ * received memory if they fill at least half of it, otherwise they are copied
+ * into right-sized buffers. @list is set to %NULL if all packets were
+ * dropped. */
+static GstFlowReturn
+gst_udpsrc_receive_batch (GstUDPSrc * udpsrc, GstBufferList ** list)
+{
+  GstBufferPool *pool;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GError *err = NULL;
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+  gboolean want_msgs, share, short_packet = FALSE;
+  guint i, n_slots, n_acquired = 0;
+  gsize offset, pos, seg_max;
+  gint res;
+
+  *list = NULL;
+
+#ifdef MSG_DONTWAIT
+  n_slots = MAX (udpsrc->batch_size, 1);
+#else
+  /* without non-blocking reads we could wait for packets that didn't arrive
+   * yet while holding back those that did */
+  n_slots = 1;
+#endif
+  gst_udpsrc_ensure_batch (udpsrc, n_slots);
+
+  want_msgs = gst_udpsrc_needs_control_messages (udpsrc);
+  offset = udpsrc->skip_first_bytes;
+
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  for (i = 0; i < n_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+    ret = gst_udpsrc_acquire_batch_buffer (udpsrc, pool, &slot->buffer);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      break;
+
+    if (!gst_buffer_map (slot->buffer, &slot->map, GST_MAP_READWRITE)) {
+      gst_udpsrc_release_batch_buffer (udpsrc, slot->buffer);
+      slot->buffer = NULL;
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("Failed to map memory"));
+      ret = GST_FLOW_ERROR;
+      break;
+    }
+    slot->vec.buffer = slot->map.data;
+    slot->vec.size = slot->map.size;
+    n_acquired++;
+  }
+
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto done;
+
+retry:
+  ret = gst_udpsrc_wait (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto done;
+
+  for (i = 0; i < n_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+
+    /* Retrieve sender address unless we've been configured not to do so */
+    msg->address = udpsrc->retrieve_sender_address ? &slot->addr : NULL;
+    msg->vectors = &slot->vec;
+    msg->num_vectors = 1;
+    msg->bytes_received = 0;
+    msg->flags = 0;
+    msg->control_messages = want_msgs ? &slot->msgs : NULL;
+    msg->num_control_messages = want_msgs ? &slot->n_msgs : NULL;
+  }
+
+  res = g_socket_receive_messages (udpsrc->used_socket, udpsrc->batch_msgs,
+      n_slots, UDP_BATCH_RECEIVE_FLAGS, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res < 0)) {
+    /* see gst_udpsrc_fill(), a "port unreachable" ICMP response for a packet
+     * we sent isn't fatal. Someone else might also have read what woke us
+     * up. */
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+      g_clear_error (&err);
+      goto retry;
+    }
+    goto receive_error;
+  }
+
+  GST_LOG_OBJECT (udpsrc, "received %d packets in one call", res);
+
+  *list = gst_buffer_list_new_sized (res);
+  for (i = 0; i < (guint) res; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+    GstBuffer *outbuf = slot->buffer;
+    gsize size = msg->bytes_received;
+    gboolean skip_packet = FALSE;
+    gint gro_size = 0;
+
+    gst_buffer_unmap (outbuf, &slot->map);
+    slot->buffer = NULL;
+
+    if (slot->msgs) {
+      skip_packet = gst_udpsrc_handle_control_messages (udpsrc, outbuf,
+          slot->msgs, slot->n_msgs, &gro_size);
+      slot->msgs = NULL;
+      slot->n_msgs = 0;
+    }
+#ifdef MSG_TRUNC
+    if (msg->flags & MSG_TRUNC) {
+      GST_WARNING_OBJECT (udpsrc, "Dropping packet larger than the mtu (%u), "
+          "increase the mtu property", udpsrc->mtu);
+      skip_packet = TRUE;
+    }
+#endif
+
+    if (skip_packet) {
+      GST_DEBUG_OBJECT (udpsrc, "Dropping packet");
+      g_clear_object (&slot->addr);
+      gst_udpsrc_release_batch_buffer (udpsrc, outbuf);
+      continue;
+    }
+
+    /* basesrc only timestamps the first buffer of a list */
+    if (!GST_BUFFER_DTS_IS_VALID (outbuf)) {
+      if (!GST_CLOCK_TIME_IS_VALID (now))
+        now = gst_udpsrc_get_running_time (udpsrc);
+      GST_BUFFER_DTS (outbuf) = now;
+    }
+
+    /* use buffer metadata so receivers can also track the address */
+    if (slot->addr) {
+      gst_buffer_add_net_address_meta (outbuf, slot->addr);
+      g_clear_object (&slot->addr);
+    }
+
+    if (!udpsrc->gro_enabled) {
+      if (G_UNLIKELY (size < offset)) {
+        short_packet = TRUE;
+        gst_buffer_unref (outbuf);
+      } else {
+        gst_buffer_resize (outbuf, offset, size - offset);
+        gst_buffer_list_add (*list, outbuf);
+      }
+      continue;
+    }
+
+    if (gro_size <= 0 || size <= (gsize) gro_size) {
+      seg_max = size;
+      share = FALSE;
+    } else {
+      GST_LOG_OBJECT (udpsrc, "splitting %" G_GSIZE_FORMAT " bytes into "
+          "packets of %d bytes", size, gro_size);
+      seg_max = gro_size;
+      /* a few small packets would otherwise each keep the whole receive
+       * buffer alive downstream */
+      share = size * 2 >= gst_buffer_get_size (outbuf);
+    }
+
+    pos = 0;
+    do {
+      gsize seg_size = MIN (seg_max, size - pos);
+      GstBuffer *packet;
+
+      if (G_UNLIKELY (seg_size < offset)) {
+        short_packet = TRUE;
+        break;
+      }
+
+      if (share) {
+        packet = gst_buffer_copy_region (outbuf, GST_BUFFER_COPY_ALL,
+            pos + offset, seg_size - offset);
+      } else {
+        ret = gst_udpsrc_copy_packet (udpsrc, pool, outbuf, pos + offset,
+            seg_size - offset, &packet);
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          break;
+      }
+      gst_buffer_list_add (*list, packet);
+      pos += seg_size;
+    } while (pos < size);
+
+    if (share)
+      gst_buffer_unref (outbuf);
+    else
+      gst_udpsrc_release_batch_buffer (udpsrc, outbuf);
+
+    if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+      gst_clear_buffer_list (list);
+      goto done;
+    }
+  }
+
+  if (G_UNLIKELY (short_packet))
+    goto skip_error;
+
+  if (gst_buffer_list_length (*list) == 0)
+    gst_clear_buffer_list (list);
+
+done:
+  for (i = 0; i < n_acquired; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+    if (slot->buffer) {
+      gst_buffer_unmap (slot->buffer, &slot->map);
+      gst_udpsrc_release_batch_buffer (udpsrc, slot->buffer);
+      slot->buffer = NULL;
+    }
+    if (slot->msgs) {
+      gint j;
+
+      for (j = 0; j < slot->n_msgs; j++)
+        g_object_unref (slot->msgs[j]);
+      g_clear_pointer (&slot->msgs, g_free);
+      slot->n_msgs = 0;
+    }
+    g_clear_object (&slot->addr);
+  }
+  gst_clear_object (&pool);
+
+  return ret;
+
+  /* ERRORS */
+receive_error:
+  {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      ret = GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      ret = GST_FLOW_ERROR;
+    }
+    g_clear_error (&err);
+    goto done;
+  }
+skip_error:
+  {
+    gst_clear_buffer_list (list);
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (bsrc);
+  GstBufferList *list;
+  GstFlowReturn ret;
+
+  /* one packet at a time, let GstPushSrc call our fill function */
+  if (udpsrc->batch_size <= 1 && !udpsrc->gro_enabled)
+    return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, length,
+        buf);
+
+  do {
+    ret = gst_udpsrc_receive_batch (udpsrc, &list);
+  } while (ret == GST_FLOW_OK && list == NULL);
+
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  gst_base_src_submit_buffer_list (bsrc, list);
+  *buf = NULL;
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -942,33 +1694,20 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
   GSocketAddress *saddr = NULL;
   GSocketAddress **p_saddr;
   gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
+  GstFlowReturn ret;
   GError *err = NULL;
   gssize res;
   gsize offset;
   GSocketControlMessage **msgs = NULL;
   GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
+  gint n_msgs = 0;
   GstMapInfo info;
   GstMapInfo extra_info;
   GInputVector ivec[2];
 
   udpsrc = GST_UDPSRC_CAST (psrc);
 
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
-#ifdef IP_MULTICAST_ALL
-  if (g_inet_address_get_family (g_inet_socket_address_get_address
-          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
-#endif
-#ifdef SO_TIMESTAMPNS
-  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
-#endif
+  p_msgs = gst_udpsrc_needs_control_messages (udpsrc) ? &msgs : NULL;
 
   /* Retrieve sender address unless we've been configured not to do so */
   p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
@@ -1011,37 +1750,9 @@ retry:
     saddr = NULL;
   }
 
-  do {
-    gint64 timeout;
-
-    try_again = FALSE;
-
-    if (udpsrc->timeout)
-      timeout = udpsrc->timeout / 1000;
-    else
-      timeout = -1;
-
-    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
-
-    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
-            timeout, udpsrc->cancellable, &err)) {
-      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
-          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
-        goto stopped;
-      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
-        g_clear_error (&err);
-        /* timeout, post element message */
-        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
-            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
-                gst_structure_new ("GstUDPSrcTimeout",
-                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
-      } else {
-        goto select_error;
-      }
-
-      try_again = TRUE;
-    }
-  } while (G_UNLIKELY (try_again));
+  ret = gst_udpsrc_wait (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto wait_failed;
 
   res =
       g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
@@ -1063,107 +1774,11 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
-
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+    gboolean skip_packet;
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
-
-    for (i = 0; i < n_msgs; i++) {
-      g_object_unref (msgs[i]);
-    }
-    g_free (msgs);
+    skip_packet = gst_udpsrc_handle_control_messages (udpsrc, outbuf, msgs,
+        n_msgs, NULL);
+    msgs = NULL;
 
     if (skip_packet) {
       GST_DEBUG_OBJECT (udpsrc,
@@ -1215,22 +1830,11 @@ memory_map_error:
         ("Failed to map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
+wait_failed:
   {
     gst_buffer_unmap (outbuf, &info);
     gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
-  {
-    gst_buffer_unmap (outbuf, &info);
-    gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
+    return ret;
   }
 receive_error:
   {
@@ -1440,6 +2044,12 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
       }
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_GRO:
+      udpsrc->gro = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -1511,6 +2121,12 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_string (value, udpsrc->multicast_source);
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
+    case PROP_GRO:
+      g_value_set_boolean (value, udpsrc->gro);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1881,6 +2497,22 @@ gst_udpsrc_open (GstUDPSrc * src)
   }
 #endif
 
+  src->gro_enabled = FALSE;
+  if (src->gro && src->batch_size > 1) {
+#ifdef UDP_GRO
+    if (!g_socket_set_option (src->used_socket, IPPROTO_UDP, UDP_GRO, TRUE,
+            &err)) {
+      GST_WARNING_OBJECT (src, "Failed to enable UDP GRO: %s", err->message);
+      g_clear_error (&err);
+    } else {
+      GST_LOG_OBJECT (src, "UDP GRO enabled");
+      src->gro_enabled = TRUE;
+    }
+#else
+    GST_WARNING_OBJECT (src, "gro was requested but UDP_GRO is not defined");
+#endif
+  }
+
   /* NOTE: sockaddr_in.sin_port works for ipv4 and ipv6 because sin_port
    * follows ss_family on both */
   {
@@ -2070,6 +2702,8 @@ gst_udpsrc_close (GstUDPSrc * src)
   }
 
   gst_udpsrc_free_cancellable (src);
+  gst_udpsrc_free_batch (src);
+  src->gro_enabled = FALSE;
 
   return TRUE;
 }
@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
+typedef struct _GstUDPSrcBatchSlot GstUDPSrcBatchSlot;
 
 
 /**
@@ -100,6 +101,16 @@ struct _GstUDPSrc {
 
   gchar     *uri;
   GPtrArray *source_list;
+
+  /* batched receive */
+  guint      batch_size;
+  gboolean   gro;
+  gboolean   gro_enabled;
+  guint      batch_alloc;
+  GInputMessage *batch_msgs;
+  GstUDPSrcBatchSlot *batch_slots;
+  /* unused receive buffers for coalesced packets */
+  GQueue     gro_spare;
 };
 
 struct _GstUDPSrcClass {
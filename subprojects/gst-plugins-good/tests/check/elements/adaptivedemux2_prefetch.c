@@ -0,0 +1,365 @@
+/* GStreamer
+ *
+ * unit test for the adaptivedemux2 fragment prefetcher
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <string.h>
+
+#include "test_http_server.h"
+
+/* libsoup is dlopen()ed, the same way the plugin does it */
+#define BUILDING_ADAPTIVEDEMUX2
+
+#include "../../ext/adaptivedemux2/gstadaptivedemuxutils.c"
+#undef GST_CAT_DEFAULT
+#include "../../ext/adaptivedemux2/downloadrequest.c"
+#undef GST_CAT_DEFAULT
+#include "../../ext/adaptivedemux2/downloadhelper.c"
+#undef GST_CAT_DEFAULT
+#include "../../ext/adaptivedemux2/gstadaptivedemux-prefetcher.c"
+#undef GST_CAT_DEFAULT
+#include "../../ext/soup/gstsouploader.c"
+#undef GST_CAT_DEFAULT
+
+GST_DEBUG_CATEGORY (adaptivedemux2_debug);
+#define GST_CAT_DEFAULT adaptivedemux2_debug
+
+#define FRAGMENT_SIZE (64 * 1024)
+/* Server-side delay before answering each request, standing in for the round
+ * trip time of a remote server */
+#define RESPONSE_DELAY_MS 200
+
+static TestHttpServer *server;
+static GMainContext *context;
+static GstAdaptiveDemuxClock *demux_clock;
+static DownloadHelper *download_helper;
+
+/* Every fragment is FRAGMENT_SIZE bytes, filled with the last character of
+ * its path */
+static gint64
+fragment_get_size (const gchar * path, gpointer user_data)
+{
+  return FRAGMENT_SIZE;
+}
+
+static void
+fragment_fill (const gchar * path, guint8 * data, gsize size, gint64 offset,
+    gpointer user_data)
+{
+  memset (data, path[strlen (path) - 1], size);
+}
+
+static const TestHttpServerCallbacks fragment_callbacks = {
+  fragment_get_size,
+  fragment_fill,
+  NULL,
+};
+
+static gchar *
+fragment_uri (guint index)
+{
+  return g_strdup_printf ("http://127.0.0.1:%u/fragment%u",
+      test_http_server_get_port (server), index);
+}
+
+static void
+setup (void)
+{
+  server = test_http_server_new (&fragment_callbacks, RESPONSE_DELAY_MS, NULL);
+  fail_unless (server != NULL);
+
+  /* Download callbacks are despatched on the thread-default context of the
+   * submitter, which is the scheduler context in the demuxer */
+  context = g_main_context_new ();
+  g_main_context_push_thread_default (context);
+
+  demux_clock = gst_adaptive_demux_clock_new ();
+  download_helper = downloadhelper_new (demux_clock);
+  fail_unless (downloadhelper_start (download_helper));
+}
+
+static void
+teardown (void)
+{
+  downloadhelper_free (download_helper);
+  gst_adaptive_demux_clock_unref (demux_clock);
+
+  g_main_context_pop_thread_default (context);
+  g_main_context_unref (context);
+
+  test_http_server_free (server);
+}
+
+static gboolean
+on_timeout (gboolean * timed_out)
+{
+  *timed_out = TRUE;
+  return G_SOURCE_REMOVE;
+}
+
+/* Iterates the scheduler context until @condition holds, or fails the test
+ * after a few seconds */
+static void
+iterate_until (gboolean (*condition) (gpointer data), gpointer data)
+{
+  gboolean timed_out = FALSE;
+  GSource *timeout = g_timeout_source_new_seconds (10);
+
+  g_source_set_callback (timeout, (GSourceFunc) on_timeout, &timed_out, NULL);
+  g_source_attach (timeout, context);
+
+  while (!condition (data) && !timed_out)
+    g_main_context_iteration (context, TRUE);
+
+  g_source_destroy (timeout);
+  g_source_unref (timeout);
+
+  fail_if (timed_out, "Timed out waiting for downloads");
+}
+
+static gboolean
+prefetches_finished (GstAdaptiveDemuxPrefetcher * prefetcher)
+{
+  guint idx;
+
+  for (idx = 0; idx < prefetcher->active_prefetches->len; idx++) {
+    GstAdaptiveDemuxPrefetchRequest *req =
+        g_ptr_array_index (prefetcher->active_prefetches, idx);
+    if (!req->download_is_finished)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+typedef struct
+{
+  gboolean finished;
+  DownloadRequestState state;
+  gsize size;
+  guint8 value;
+} TargetResult;
+
+static void
+on_target_finished (DownloadRequest * request, DownloadRequestState state,
+    TargetResult * result)
+{
+  GstBuffer *buffer = download_request_take_buffer (request);
+
+  result->finished = TRUE;
+  result->state = state;
+
+  if (buffer != NULL) {
+    result->size = gst_buffer_get_size (buffer);
+    gst_buffer_extract (buffer, result->size - 1, &result->value, 1);
+    gst_buffer_unref (buffer);
+  }
+}
+
+static DownloadRequest *
+target_request_new (const gchar * uri, gint64 range_start, gint64 range_end,
+    TargetResult * result)
+{
+  DownloadRequest *request =
+      download_request_new_uri_range (uri, range_start, range_end);
+
+  download_request_set_callbacks (request,
+      (DownloadRequestEventCallback) on_target_finished,
+      (DownloadRequestEventCallback) on_target_finished,
+      (DownloadRequestEventCallback) on_target_finished, NULL, result);
+
+  return request;
+}
+
+static gboolean
+target_finished (TargetResult * result)
+{
+  return result->finished;
+}
+
+#define N_PREFETCH 4
+
+GST_START_TEST (test_prefetch_concurrent)
+{
+  GstAdaptiveDemuxPrefetcher *prefetcher =
+      gst_adaptive_demux_prefetcher_new (download_helper);
+  GstClockTime start = gst_util_get_timestamp ();
+  guint i, requests, max_active;
+
+  for (i = 0; i < N_PREFETCH; i++) {
+    gchar *uri = fragment_uri (i);
+    fail_unless (gst_adaptive_demux_prefetcher_load (prefetcher, uri, 0, -1));
+    g_free (uri);
+  }
+  fail_unless_equals_int (prefetcher->active_prefetches->len, N_PREFETCH);
+
+  iterate_until ((gboolean (*)(gpointer)) prefetches_finished, prefetcher);
+
+  /* The downloads overlapped instead of going one after the other */
+  test_http_server_get_stats (server, &requests, &max_active);
+  GST_INFO ("%u prefetches took %" GST_TIME_FORMAT ", up to %u in parallel",
+      N_PREFETCH, GST_TIME_ARGS (gst_util_get_timestamp () - start),
+      max_active);
+  fail_unless_equals_int (requests, N_PREFETCH);
+  fail_unless (max_active > 1);
+
+  /* Prefetched fragments are handed over when requested, without
+   * downloading them again */
+  for (i = 0; i < N_PREFETCH; i++) {
+    TargetResult result = { 0, };
+    gchar *uri = fragment_uri (i);
+    DownloadRequest *request = target_request_new (uri, 0, -1, &result);
+
+    fail_unless (gst_adaptive_demux_prefetcher_provide_request (prefetcher,
+            request));
+    fail_unless (result.finished);
+    fail_unless_equals_int (result.state, DOWNLOAD_REQUEST_STATE_COMPLETE);
+    fail_unless_equals_int (result.size, FRAGMENT_SIZE);
+    fail_unless_equals_int (result.value, '0' + i);
+    fail_unless_equals_int (request->status_code, 200);
+
+    download_request_unref (request);
+    g_free (uri);
+  }
+
+  fail_unless_equals_int (prefetcher->active_prefetches->len, 0);
+  test_http_server_get_stats (server, &requests, NULL);
+  fail_unless_equals_int (requests, N_PREFETCH);
+
+  gst_adaptive_demux_prefetcher_free (prefetcher);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_prefetch_provide_in_progress)
+{
+  GstAdaptiveDemuxPrefetcher *prefetcher =
+      gst_adaptive_demux_prefetcher_new (download_helper);
+  TargetResult result = { 0, };
+  DownloadRequest *request;
+  gchar *uri = fragment_uri (7);
+  guint requests;
+
+  fail_unless (gst_adaptive_demux_prefetcher_load (prefetcher, uri, 1024,
+          2047));
+
+  /* Only exact matches of the byte range are served */
+  request = target_request_new (uri, 0, 2047, &result);
+  fail_if (gst_adaptive_demux_prefetcher_provide_request (prefetcher,
+          request));
+  download_request_unref (request);
+
+  /* Claim the prefetch while its download is still ongoing */
+  request = target_request_new (uri, 1024, 2047, &result);
+  fail_unless (gst_adaptive_demux_prefetcher_provide_request (prefetcher,
+          request));
+  fail_if (result.finished);
+
+  iterate_until ((gboolean (*)(gpointer)) target_finished, &result);
+
+  fail_unless_equals_int (result.state, DOWNLOAD_REQUEST_STATE_COMPLETE);
+  fail_unless_equals_int (result.size, 1024);
+  fail_unless_equals_int (result.value, '7');
+  fail_unless_equals_int (request->status_code, 206);
+  fail_unless (GST_CLOCK_TIME_IS_VALID (request->download_end_time));
+  fail_unless_equals_int (prefetcher->active_prefetches->len, 0);
+  test_http_server_get_stats (server, &requests, NULL);
+  fail_unless_equals_int (requests, 1);
+
+  download_request_unref (request);
+  gst_adaptive_demux_prefetcher_free (prefetcher);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_prefetch_update_and_cancel)
+{
+  GstAdaptiveDemuxPrefetcher *prefetcher =
+      gst_adaptive_demux_prefetcher_new (download_helper);
+  TargetResult result = { 0, };
+  DownloadRequest *request;
+  gchar *uris[3];
+  guint i;
+
+  for (i = 0; i < 3; i++) {
+    uris[i] = fragment_uri (i);
+    fail_unless (gst_adaptive_demux_prefetcher_load (prefetcher, uris[i], 0,
+            -1));
+  }
+
+  /* Moving on to the next fragment keeps it and the ones after it, and
+   * drops the ones that are not wanted anymore */
+  gst_adaptive_demux_prefetcher_begin_update (prefetcher);
+  fail_unless (gst_adaptive_demux_prefetcher_retain (prefetcher, uris[1], 0,
+          -1));
+  fail_unless (gst_adaptive_demux_prefetcher_load (prefetcher, uris[2], 0,
+          -1));
+  gst_adaptive_demux_prefetcher_end_update (prefetcher);
+  fail_unless_equals_int (prefetcher->active_prefetches->len, 2);
+
+  request = target_request_new (uris[0], 0, -1, &result);
+  fail_if (gst_adaptive_demux_prefetcher_provide_request (prefetcher,
+          request));
+  download_request_unref (request);
+
+  /* Cancelling the target stops feeding it, without any callback */
+  request = target_request_new (uris[1], 0, -1, &result);
+  fail_unless (gst_adaptive_demux_prefetcher_provide_request (prefetcher,
+          request));
+  gst_adaptive_demux_prefetcher_cancel_target (prefetcher, request);
+  fail_unless_equals_int (prefetcher->active_prefetches->len, 1);
+  download_request_unref (request);
+
+  gst_adaptive_demux_prefetcher_cancel (prefetcher);
+  fail_unless_equals_int (prefetcher->active_prefetches->len, 0);
+  fail_if (result.finished);
+
+  gst_adaptive_demux_prefetcher_free (prefetcher);
+  for (i = 0; i < 3; i++)
+    g_free (uris[i]);
+}
+
+GST_END_TEST;
+
+static Suite *
+adaptivedemux2_prefetch_suite (void)
+{
+  Suite *s = suite_create ("adaptivedemux2_prefetch");
+  TCase *tc = tcase_create ("prefetch");
+
+  GST_DEBUG_CATEGORY_INIT (adaptivedemux2_debug, "adaptivedemux2", 0,
+      "adaptivedemux2 prefetch tests");
+
+  if (!gst_soup_load_library ()) {
+    GST_INFO ("Skipping tests, libsoup is not available");
+    return s;
+  }
+
+  tcase_add_checked_fixture (tc, setup, teardown);
+  tcase_add_test (tc, test_prefetch_concurrent);
+  tcase_add_test (tc, test_prefetch_provide_in_progress);
+  tcase_add_test (tc, test_prefetch_update_and_cancel);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
+
+GST_CHECK_MAIN (adaptivedemux2_prefetch);
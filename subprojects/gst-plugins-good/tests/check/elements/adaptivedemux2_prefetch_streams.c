@@ -0,0 +1,271 @@
+/* GStreamer
+ *
+ * unit test for fragment prefetching in hlsdemux2 and dashdemux2
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <string.h>
+
+#include "test_http_server.h"
+
+#define TS_PACKET_SIZE 188
+/* Every segment is 100 MPEG-TS packets, either in a file of its own or as a
+ * byte range of MEDIA_PATH */
+#define SEGMENT_SIZE (100 * TS_PACKET_SIZE)
+#define MEDIA_PATH "/media.ts"
+#define MEDIA_SEGMENTS 3
+/* Server-side delay before answering each request, so that prefetches are
+ * still in progress when the demuxer gets to their fragment */
+#define RESPONSE_DELAY_MS 50
+
+static const gchar hls_playlist[] =
+    "#EXTM3U\n"
+    "#EXT-X-VERSION:4\n"
+    "#EXT-X-TARGETDURATION:1\n"
+    "#EXT-X-MEDIA-SEQUENCE:0\n"
+    "#EXTINF:1.0,\n"
+    "segment0.ts\n"
+    "#EXTINF:1.0,\n"
+    "#EXT-X-BYTERANGE:18800@0\n"
+    "media.ts\n"
+    "#EXTINF:1.0,\n"
+    "#EXT-X-BYTERANGE:18800\n"
+    "media.ts\n"
+    "#EXTINF:1.0,\n"
+    "#EXT-X-BYTERANGE:18800\n"
+    "media.ts\n"
+    "#EXTINF:1.0,\n" "segment4.ts\n" "#EXT-X-ENDLIST\n";
+
+static const gchar dash_manifest[] =
+    "<?xml version=\"1.0\"?>"
+    "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\""
+    "     profiles=\"urn:mpeg:dash:profile:isoff-main:2011\""
+    "     type=\"static\" minBufferTime=\"PT1S\""
+    "     mediaPresentationDuration=\"PT5S\">"
+    "  <Period>"
+    "    <AdaptationSet mimeType=\"video/mp2t\">"
+    "      <Representation id=\"1\" bandwidth=\"250000\">"
+    "        <SegmentList duration=\"1\" timescale=\"1\">"
+    "          <SegmentURL media=\"segment0.ts\"/>"
+    "          <SegmentURL media=\"media.ts\" mediaRange=\"0-18799\"/>"
+    "          <SegmentURL media=\"media.ts\" mediaRange=\"18800-37599\"/>"
+    "          <SegmentURL media=\"media.ts\" mediaRange=\"37600-56399\"/>"
+    "          <SegmentURL media=\"segment4.ts\"/>"
+    "        </SegmentList>"
+    "      </Representation>"
+    "    </AdaptationSet>" "  </Period>" "</MPD>";
+
+/* The requests the demuxers must make for the segments above */
+static const gchar *expected_requests[] = {
+  "/segment0.ts",
+  "/media.ts 0-18799",
+  "/media.ts 18800-37599",
+  "/media.ts 37600-56399",
+  "/segment4.ts",
+};
+
+static TestHttpServer *server;
+/* Log of the media requests, protected by requests_lock */
+static GMutex requests_lock;
+static GPtrArray *requests;
+
+static const gchar *
+get_manifest (const gchar * path)
+{
+  if (g_str_has_suffix (path, ".m3u8"))
+    return hls_playlist;
+  if (g_str_has_suffix (path, ".mpd"))
+    return dash_manifest;
+  return NULL;
+}
+
+/* Serves the manifests above, and MPEG-TS null packets for anything else */
+static gint64
+stream_get_size (const gchar * path, gpointer user_data)
+{
+  const gchar *manifest = get_manifest (path);
+
+  if (manifest)
+    return strlen (manifest);
+
+  return !strcmp (path, MEDIA_PATH) ?
+      MEDIA_SEGMENTS * SEGMENT_SIZE : SEGMENT_SIZE;
+}
+
+static void
+stream_fill (const gchar * path, guint8 * data, gsize size, gint64 offset,
+    gpointer user_data)
+{
+  const gchar *manifest = get_manifest (path);
+  gsize i;
+
+  if (manifest) {
+    memcpy (data, manifest + offset, size);
+    return;
+  }
+
+  for (i = 0; i < size; i++) {
+    switch ((offset + i) % TS_PACKET_SIZE) {
+      case 0:
+        data[i] = 0x47;
+        break;
+      case 1:
+        data[i] = 0x1f;
+        break;
+      case 2:
+        data[i] = 0xff;
+        break;
+      case 3:
+        data[i] = 0x10;
+        break;
+      default:
+        data[i] = 0xff;
+        break;
+    }
+  }
+}
+
+static void
+stream_request (const gchar * path, gboolean has_range, gint64 range_start,
+    gint64 range_end, gpointer user_data)
+{
+  if (get_manifest (path))
+    return;
+
+  g_mutex_lock (&requests_lock);
+  if (has_range) {
+    g_ptr_array_add (requests,
+        g_strdup_printf ("%s %" G_GINT64_FORMAT "-%" G_GINT64_FORMAT, path,
+            range_start, range_end));
+  } else {
+    g_ptr_array_add (requests, g_strdup (path));
+  }
+  g_mutex_unlock (&requests_lock);
+}
+
+static const TestHttpServerCallbacks stream_callbacks = {
+  stream_get_size,
+  stream_fill,
+  stream_request,
+};
+
+static void
+setup (void)
+{
+  g_mutex_init (&requests_lock);
+  requests = g_ptr_array_new_with_free_func (g_free);
+  server = test_http_server_new (&stream_callbacks, RESPONSE_DELAY_MS, NULL);
+  fail_unless (server != NULL);
+}
+
+static void
+teardown (void)
+{
+  test_http_server_free (server);
+  g_ptr_array_unref (requests);
+  g_mutex_clear (&requests_lock);
+}
+
+/* Plays @manifest with @demux_name and a prefetch depth of 2. The prefetcher
+ * only hands over a download if the fragment the stream peeked matches the
+ * one it ends up requesting exactly, otherwise the fragment is downloaded a
+ * second time. So every segment must have been requested exactly once */
+static void
+check_prefetched_playback (const gchar * demux_name, const gchar * manifest)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  GstBus *bus;
+  gchar *desc;
+  guint i, j;
+
+  desc = g_strdup_printf ("souphttpsrc location=http://127.0.0.1:%u/%s ! "
+      "%s prefetch-depth=2 ! fakesink sync=false",
+      test_http_server_get_port (server), manifest, demux_name);
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL, "Timed out waiting for EOS");
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  g_mutex_lock (&requests_lock);
+  fail_unless_equals_int (requests->len,
+      G_N_ELEMENTS (expected_requests));
+  for (i = 0; i < G_N_ELEMENTS (expected_requests); i++) {
+    guint count = 0;
+
+    for (j = 0; j < requests->len; j++) {
+      if (!strcmp (g_ptr_array_index (requests, j),
+              expected_requests[i]))
+        count++;
+    }
+    fail_unless_equals_int (count, 1);
+  }
+  g_mutex_unlock (&requests_lock);
+}
+
+GST_START_TEST (test_hls_prefetch)
+{
+  check_prefetched_playback ("hlsdemux2", "index.m3u8");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_dash_prefetch)
+{
+  check_prefetched_playback ("dashdemux2", "manifest.mpd");
+}
+
+GST_END_TEST;
+
+static Suite *
+adaptivedemux2_prefetch_streams_suite (void)
+{
+  Suite *s = suite_create ("adaptivedemux2_prefetch_streams");
+  TCase *tc = tcase_create ("prefetch");
+  GstRegistry *registry = gst_registry_get ();
+
+  if (!gst_registry_check_feature_version (registry, "souphttpsrc", 1, 0, 0)) {
+    GST_INFO ("Skipping tests, souphttpsrc is not available");
+    return s;
+  }
+
+  tcase_add_checked_fixture (tc, setup, teardown);
+  if (gst_registry_check_feature_version (registry, "hlsdemux2", 1, 0, 0))
+    tcase_add_test (tc, test_hls_prefetch);
+  if (gst_registry_check_feature_version (registry, "dashdemux2", 1, 0, 0))
+    tcase_add_test (tc, test_dash_prefetch);
+
+  suite_add_tcase (s, tc);
+
+  return s;
+}
+
+GST_CHECK_MAIN (adaptivedemux2_prefetch_streams);
@@ -82,6 +82,50 @@ https://priv.example.com/fileSequence3003.ts\n\
 #EXTINF:8,\n\
 https://priv.example.com/fileSequence3004.ts";
 
+static const gchar *LIVE_ENCRYPTED_PLAYLIST = "#EXTM3U\n\
+#EXT-X-TARGETDURATION:2\n\
+#EXT-X-MEDIA-SEQUENCE:100\n\
+#EXT-X-DISCONTINUITY-SEQUENCE:3\n\
+#EXT-X-KEY:METHOD=AES-128,URI=\"https://priv.example.com/key.bin\",IV=0x00000000000000000000000000000007\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg100.ts\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg101.ts\n\
+#EXT-X-DISCONTINUITY\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg102.ts\n";
+
+static const gchar *LIVE_ENCRYPTED_PLAYLIST_UPDATE = "#EXTM3U\n\
+#EXT-X-TARGETDURATION:2\n\
+#EXT-X-MEDIA-SEQUENCE:101\n\
+#EXT-X-DISCONTINUITY-SEQUENCE:3\n\
+#EXT-X-KEY:METHOD=AES-128,URI=\"https://priv.example.com/key.bin\",IV=0x00000000000000000000000000000007\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg101.ts\n\
+#EXT-X-DISCONTINUITY\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg102.ts\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg103.ts\n\
+#EXT-X-KEY:METHOD=AES-128,URI=\"https://priv.example.com/key2.bin\"\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg104.ts\n";
+
+/* Same segments as LIVE_ENCRYPTED_PLAYLIST_UPDATE, but with a different
+ * target duration */
+static const gchar *LIVE_ENCRYPTED_PLAYLIST_NEW_HEADER = "#EXTM3U\n\
+#EXT-X-TARGETDURATION:3\n\
+#EXT-X-MEDIA-SEQUENCE:101\n\
+#EXT-X-DISCONTINUITY-SEQUENCE:3\n\
+#EXT-X-KEY:METHOD=AES-128,URI=\"https://priv.example.com/key.bin\",IV=0x00000000000000000000000000000007\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg101.ts\n\
+#EXT-X-DISCONTINUITY\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg102.ts\n\
+#EXTINF:2,\n\
+https://priv.example.com/seg103.ts\n";
+
 static const gchar *VARIANT_PLAYLIST = "#EXTM3U \n\
 #EXT-X-STREAM-INF:PROGRAM-ID=1,BANDWIDTH=128000\n\
 http://example.com/low.m3u8\n\
@@ -967,6 +1011,105 @@ GST_START_TEST (test_playlist_skip)
 
 GST_END_TEST;
 
+GST_START_TEST (test_parse_update_live_playlist)
+{
+  GstHLSMediaPlaylist *pl, *update, *full;
+  GstM3U8MediaSegment *file;
+  guint8 iv[16] = { 0, };
+  guint i;
+
+  pl = load_m3u8 (LIVE_ENCRYPTED_PLAYLIST);
+  assert_equals_int (pl->segments->len, 3);
+  fail_unless (pl->resume_offset != 0);
+
+  update = gst_hls_media_playlist_parse_update (pl,
+      g_strdup (LIVE_ENCRYPTED_PLAYLIST_UPDATE), GST_CLOCK_TIME_NONE,
+      "http://localhost/test.m3u8", NULL);
+  fail_unless (update != NULL);
+  full = load_m3u8 (LIVE_ENCRYPTED_PLAYLIST_UPDATE);
+
+  /* The segments still present are shared with the previous playlist */
+  assert_equals_int (update->segments->len, 4);
+  fail_unless (g_ptr_array_index (update->segments, 0) ==
+      g_ptr_array_index (pl->segments, 1));
+  fail_unless (g_ptr_array_index (update->segments, 1) ==
+      g_ptr_array_index (pl->segments, 2));
+
+  /* And the result is the same as parsing everything again */
+  assert_equals_int64 (update->media_sequence, full->media_sequence);
+  assert_equals_int64 (update->discont_sequence, full->discont_sequence);
+  assert_equals_uint64 (update->duration, full->duration);
+  fail_unless (update->has_ext_x_dsn);
+  fail_unless (update->ext_x_key_present);
+  assert_equals_int (update->segments->len, full->segments->len);
+  for (i = 0; i < full->segments->len; i++) {
+    GstM3U8MediaSegment *a = g_ptr_array_index (update->segments, i);
+    GstM3U8MediaSegment *b = g_ptr_array_index (full->segments, i);
+
+    assert_equals_string (a->uri, b->uri);
+    assert_equals_string (a->key, b->key);
+    assert_equals_int64 (a->sequence, b->sequence);
+    assert_equals_int64 (a->discont_sequence, b->discont_sequence);
+    assert_equals_uint64 (a->duration, b->duration);
+    fail_unless (a->discont == b->discont);
+    fail_unless (memcmp (a->iv, b->iv, 16) == 0);
+  }
+
+  /* The explicit IV carries over to appended segments until the next
+   * EXT-X-KEY, after which the media sequence number is used */
+  iv[15] = 7;
+  file = g_ptr_array_index (update->segments, 2);
+  assert_equals_int64 (file->sequence, 103);
+  fail_unless (memcmp (file->iv, iv, 16) == 0);
+  iv[15] = 104;
+  file = g_ptr_array_index (update->segments, 3);
+  assert_equals_string (file->key, "https://priv.example.com/key2.bin");
+  fail_unless (memcmp (file->iv, iv, 16) == 0);
+
+  gst_hls_media_playlist_unref (full);
+  gst_hls_media_playlist_unref (pl);
+
+  /* An update that doesn't append to the previous data is parsed fully */
+  pl = gst_hls_media_playlist_parse_update (update,
+      g_strdup (LIVE_ROTATED_PLAYLIST), GST_CLOCK_TIME_NONE,
+      "http://localhost/test.m3u8", NULL);
+  fail_unless (pl != NULL);
+  assert_equals_int (pl->segments->len, 4);
+  file = g_ptr_array_index (pl->segments, 0);
+  assert_equals_int64 (file->sequence, 3001);
+  fail_unless (file->key == NULL);
+
+  gst_hls_media_playlist_unref (pl);
+  gst_hls_media_playlist_unref (update);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_update_changed_header)
+{
+  GstHLSMediaPlaylist *pl, *update;
+
+  pl = load_m3u8 (LIVE_ENCRYPTED_PLAYLIST);
+  assert_equals_uint64 (pl->targetduration, 2 * GST_SECOND);
+
+  /* A header that changed in more than the sequence numbers is not taken
+   * over from the previous playlist */
+  update = gst_hls_media_playlist_parse_update (pl,
+      g_strdup (LIVE_ENCRYPTED_PLAYLIST_NEW_HEADER), GST_CLOCK_TIME_NONE,
+      "http://localhost/test.m3u8", NULL);
+  fail_unless (update != NULL);
+  assert_equals_uint64 (update->targetduration, 3 * GST_SECOND);
+  assert_equals_int64 (update->media_sequence, 101);
+  assert_equals_int (update->segments->len, 3);
+  fail_if (g_ptr_array_index (update->segments, 0) ==
+      g_ptr_array_index (pl->segments, 1));
+
+  gst_hls_media_playlist_unref (update);
+  gst_hls_media_playlist_unref (pl);
+}
+
+GST_END_TEST;
+
 static Suite *
 hlsdemux_suite (void)
 {
@@ -1003,6 +1146,8 @@ hlsdemux_suite (void)
   tcase_add_test (tc_m3u8, test_map_tag);
   tcase_add_test (tc_m3u8, test_low_latency_playlist);
   tcase_add_test (tc_m3u8, test_playlist_skip);
+  tcase_add_test (tc_m3u8, test_parse_update_live_playlist);
+  tcase_add_test (tc_m3u8, test_parse_update_changed_header);
   return s;
 }
 
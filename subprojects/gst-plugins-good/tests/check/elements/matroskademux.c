@@ -17,6 +17,7 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <glib/gstdio.h>
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
 
@@ -484,6 +485,84 @@ GST_START_TEST (test_segment_looping_middle_segment_with_rate)
 
 GST_END_TEST;
 
+static void
+check_seek_position (GstElement * pipeline, GstElement * sink,
+    GstClockTime target)
+{
+  GstSample *sample = NULL;
+  GstBuffer *buf;
+
+  fail_unless (gst_element_seek_simple (pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH, target));
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL, -1),
+      GST_STATE_CHANGE_SUCCESS);
+
+  g_object_get (sink, "last-sample", &sample, NULL);
+  fail_unless (sample != NULL);
+  buf = gst_sample_get_buffer (sample);
+  GST_INFO ("seek to %" GST_TIME_FORMAT " prerolled at %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (target), GST_TIME_ARGS (GST_BUFFER_PTS (buf)));
+  fail_unless (GST_BUFFER_PTS (buf) <= target);
+  fail_unless (GST_BUFFER_PTS (buf) + 5 * GST_SECOND >= target);
+  gst_sample_unref (sample);
+}
+
+/* Files without cues are seeked in by scanning for clusters, make sure
+ * repeated seeks in both directions end up at the right position. */
+GST_START_TEST (test_seek_without_cues)
+{
+  GstElement *pipeline, *sink;
+  GstMessage *msg;
+  GError *err = NULL;
+  gchar *location, *desc;
+
+  location = g_strdup_printf ("%s/%s-%d.mkv", g_get_tmp_dir (),
+      "matroskademuxtest", g_random_int ());
+
+  /* 60 seconds of audio, streamable means no cues are written */
+  desc = g_strdup_printf ("audiotestsrc num-buffers=600 samplesperbuffer=4410 "
+      "wave=white-noise ! audio/x-raw,rate=44100,channels=1 ! "
+      "matroskamux streamable=true ! filesink location=\"%s\"", location);
+  pipeline = gst_parse_launch (desc, &err);
+  fail_unless (pipeline != NULL, "%s", err ? err->message : "");
+  g_free (desc);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! matroskademux ! "
+      "fakesink name=sink sync=false", location);
+  pipeline = gst_parse_launch (desc, &err);
+  fail_unless (pipeline != NULL, "%s", err ? err->message : "");
+  g_free (desc);
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PAUSED) !=
+      GST_STATE_CHANGE_FAILURE);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL, -1),
+      GST_STATE_CHANGE_SUCCESS);
+
+  check_seek_position (pipeline, sink, 45 * GST_SECOND);
+  check_seek_position (pipeline, sink, 15 * GST_SECOND);
+  check_seek_position (pipeline, sink, 30 * GST_SECOND);
+  check_seek_position (pipeline, sink, 55 * GST_SECOND);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
 static Suite *
 matroskademux_suite (void)
 {
@@ -496,6 +575,7 @@ matroskademux_suite (void)
   tcase_add_test (tc_chain, test_segment_looping);
   tcase_add_test (tc_chain, test_segment_looping_middle_segment);
   tcase_add_test (tc_chain, test_segment_looping_middle_segment_with_rate);
+  tcase_add_test (tc_chain, test_seek_without_cues);
 
   return s;
 }
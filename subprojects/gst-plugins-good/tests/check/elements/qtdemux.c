@@ -1739,6 +1739,247 @@ GST_START_TEST (test_qtdemux_editlist)
 
 GST_END_TEST;
 
+GST_START_TEST (test_qtdemux_probe)
+{
+  GstElement *pipes[4];
+  gchar *location;
+  guint i;
+
+  location = g_build_filename (GST_TEST_FILES_PATH,
+      "sine-1kHztone-48kHzrate-mono-s32le-200000samples-itunes.m4a", NULL);
+
+  /* probe the same file a few times at once */
+  for (i = 0; i < G_N_ELEMENTS (pipes); i++) {
+    gchar *desc;
+
+    desc = g_strdup_printf ("filesrc location=\"%s\" ! qtdemux probe=true ! "
+        "appsink name=sink sync=false", location);
+    pipes[i] = gst_parse_launch (desc, NULL);
+    fail_unless (pipes[i] != NULL);
+    g_free (desc);
+
+    gst_element_set_state (pipes[i], GST_STATE_PLAYING);
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (pipes); i++) {
+    GstElement *sink;
+    GstSample *sample;
+    gint64 duration;
+    guint n_samples = 0;
+
+    sink = gst_bin_get_by_name (GST_BIN (pipes[i]), "sink");
+    fail_unless (sink != NULL);
+
+    /* only the first sample is output, then EOS */
+    while ((sample = gst_app_sink_pull_sample (GST_APP_SINK (sink)))) {
+      n_samples++;
+      gst_sample_unref (sample);
+    }
+    fail_unless_equals_int (n_samples, 1);
+    fail_unless (gst_app_sink_is_eos (GST_APP_SINK (sink)));
+
+    /* the headers are still parsed completely */
+    fail_unless (gst_element_query_duration (pipes[i], GST_FORMAT_TIME,
+            &duration));
+    fail_unless (duration > 0);
+
+    gst_element_set_state (pipes[i], GST_STATE_NULL);
+    gst_object_unref (sink);
+    gst_object_unref (pipes[i]);
+  }
+
+  g_free (location);
+}
+
+GST_END_TEST;
+
+#define MP4V_FRAME_DURATION (GST_SECOND / 25)
+
+/* writes @n_frames MPEG-4 video frames to a temporary mp4 file, the frames
+ * before @first_keyframe are delta units. Returns the file name */
+static gchar *
+create_mp4v_file (guint n_frames, guint first_keyframe)
+{
+  GstElement *pipe, *src;
+  GstMessage *msg;
+  gchar *location, *desc;
+  guint i;
+  gint fd;
+
+  fd = g_file_open_tmp ("qtdemux-XXXXXX.mp4", &location, NULL);
+  fail_unless (fd != -1);
+  g_close (fd, NULL);
+
+  desc = g_strdup_printf ("appsrc name=src format=time caps=\"video/mpeg, "
+      "mpegversion=(int)4, systemstream=(boolean)false, width=(int)16, "
+      "height=(int)16, framerate=(fraction)25/1\" ! mp4mux ! "
+      "filesink location=\"%s\"", location);
+  pipe = gst_parse_launch (desc, NULL);
+  fail_unless (pipe != NULL);
+  g_free (desc);
+
+  src = gst_bin_get_by_name (GST_BIN (pipe), "src");
+  fail_unless (src != NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, 4, NULL);
+
+    gst_buffer_memset (buf, 0, i & 0xff, 4);
+    GST_BUFFER_PTS (buf) = GST_BUFFER_DTS (buf) = i * MP4V_FRAME_DURATION;
+    GST_BUFFER_DURATION (buf) = MP4V_FRAME_DURATION;
+    if (i < first_keyframe)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    fail_unless_equals_int (gst_app_src_push_buffer (GST_APP_SRC (src), buf),
+        GST_FLOW_OK);
+  }
+  gst_app_src_end_of_stream (GST_APP_SRC (src));
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (src);
+  gst_object_unref (pipe);
+
+  return location;
+}
+
+static GstElement *
+create_demux_pipeline (const gchar * location, GstElement ** sink)
+{
+  GstElement *pipe;
+  gchar *desc;
+
+  desc = g_strdup_printf ("filesrc location=\"%s\" ! qtdemux name=demux ! "
+      "appsink name=sink sync=false", location);
+  pipe = gst_parse_launch (desc, NULL);
+  fail_unless (pipe != NULL);
+  g_free (desc);
+
+  *sink = gst_bin_get_by_name (GST_BIN (pipe), "sink");
+  fail_unless (*sink != NULL);
+
+  return pipe;
+}
+
+/* pulls the remaining samples and checks that they are consecutive frames
+ * starting at @first_frame, returns the number of samples */
+static guint
+pull_mp4v_frames (GstElement * sink, guint first_frame)
+{
+  GstSample *sample;
+  guint n_samples = 0;
+
+  while ((sample = gst_app_sink_pull_sample (GST_APP_SINK (sink)))) {
+    GstBuffer *buf = gst_sample_get_buffer (sample);
+    guint frame = first_frame + n_samples;
+    guint8 data[4];
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf),
+        frame * MP4V_FRAME_DURATION);
+    memset (data, frame & 0xff, sizeof (data));
+    fail_unless (gst_buffer_memcmp (buf, 0, data, sizeof (data)) == 0);
+    n_samples++;
+    gst_sample_unref (sample);
+  }
+  fail_unless (gst_app_sink_is_eos (GST_APP_SINK (sink)));
+
+  return n_samples;
+}
+
+GST_START_TEST (test_qtdemux_index_growth)
+{
+  GstElement *pipe, *sink;
+  gchar *location;
+
+  /* a few times the number of samples the index grows by at once */
+  location = create_mp4v_file (10000, 0);
+  pipe = create_demux_pipeline (location, &sink);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  fail_unless_equals_int (pull_mp4v_frames (sink, 0), 10000);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipe);
+  g_remove (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_qtdemux_seek_unparsed)
+{
+  GstElement *pipe, *sink;
+  gchar *location;
+
+  location = create_mp4v_file (10000, 0);
+  pipe = create_demux_pipeline (location, &sink);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipe, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  /* only the start of the sample tables has been parsed, seek far beyond */
+  fail_unless (gst_element_seek_simple (pipe, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT,
+          9000 * MP4V_FRAME_DURATION));
+  fail_unless_equals_int (gst_element_get_state (pipe, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  fail_unless_equals_int (pull_mp4v_frames (sink, 9000), 1000);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipe);
+  g_remove (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_qtdemux_probe_video)
+{
+  GstElement *pipe, *demux, *sink;
+  GstSample *sample;
+  GstBuffer *buf;
+  gchar *location;
+
+  /* the video starts with a few frames that are not keyframes */
+  location = create_mp4v_file (50, 3);
+  pipe = create_demux_pipeline (location, &sink);
+  demux = gst_bin_get_by_name (GST_BIN (pipe), "demux");
+  g_object_set (demux, "probe", TRUE, NULL);
+  gst_object_unref (demux);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  /* only the first keyframe is output */
+  sample = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  fail_unless (sample != NULL);
+  buf = gst_sample_get_buffer (sample);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), 3 * MP4V_FRAME_DURATION);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT));
+  gst_sample_unref (sample);
+
+  fail_unless_equals_int (pull_mp4v_frames (sink, 4), 0);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipe);
+  g_remove (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
 static Suite *
 qtdemux_suite (void)
 {
@@ -1758,6 +1999,10 @@ qtdemux_suite (void)
   tcase_add_test (tc_chain, test_qtdemux_gapless_nero_data_with_itunsmpb);
   tcase_add_test (tc_chain, test_qtdemux_gapless_nero_data_without_itunsmpb);
   tcase_add_test (tc_chain, test_qtdemux_editlist);
+  tcase_add_test (tc_chain, test_qtdemux_probe);
+  tcase_add_test (tc_chain, test_qtdemux_index_growth);
+  tcase_add_test (tc_chain, test_qtdemux_seek_unparsed);
+  tcase_add_test (tc_chain, test_qtdemux_probe_video);
 
   return s;
 }
@@ -649,6 +649,80 @@ GST_START_TEST (test_video_pad_frag_dd_finalise)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+check_fragment_list (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+  GstBuffer *moof, *mdat;
+
+  /* moof, mdat header and then the media buffers of the fragment */
+  fail_unless_equals_int (gst_buffer_list_length (list), 5);
+  moof = gst_buffer_list_get (list, 0);
+  fail_unless (gst_buffer_memcmp (moof, 4, "moof", 4) == 0);
+  fail_if (GST_BUFFER_FLAG_IS_SET (moof, GST_BUFFER_FLAG_DELTA_UNIT));
+  mdat = gst_buffer_list_get (list, 1);
+  fail_unless_equals_int (gst_buffer_get_size (mdat), 8);
+  fail_unless (gst_buffer_memcmp (mdat, 4, "mdat", 4) == 0);
+
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_video_pad_frag_buffer_list)
+{
+  GstElement *qtmux;
+  GstBuffer *inbuffer;
+  GstCaps *caps;
+  GstPad *srcpad;
+  GstSegment segment;
+  guint n_lists = 0;
+  gint i;
+
+  qtmux = setup_qtmux (&srcvideotemplate, "video_%u", TRUE);
+  g_object_set (qtmux, "fragment-duration", 2000, NULL);
+
+  srcpad = gst_element_get_static_pad (qtmux, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) check_fragment_list, &n_lists, NULL);
+  gst_object_unref (srcpad);
+
+  fail_unless (gst_element_set_state (qtmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+
+  caps = gst_pad_get_pad_template_caps (mysrcpad);
+  gst_pad_set_caps (mysrcpad, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < 3; i++) {
+    inbuffer = gst_buffer_new_and_alloc (1);
+    gst_buffer_memset (inbuffer, 0, i, 1);
+    GST_BUFFER_TIMESTAMP (inbuffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (inbuffer) = 40 * GST_MSECOND;
+    if (i > 0)
+      GST_BUFFER_FLAG_SET (inbuffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()) == TRUE);
+
+  wait_for_eos ();
+
+  /* the whole fragment went out as a single list */
+  fail_unless_equals_int (n_lists, 1);
+
+  cleanup_qtmux (qtmux, "video_%u");
+  gst_check_drop_buffers ();
+}
+
+GST_END_TEST;
+
 /* dts-method reorder */
 
 GST_START_TEST (test_video_pad_reorder)
@@ -1870,6 +1944,7 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_video_pad_frag_dd_streamable);
   tcase_add_test (tc_chain, test_audio_pad_frag_dd_streamable);
   tcase_add_test (tc_chain, test_video_pad_frag_dd_finalise);
+  tcase_add_test (tc_chain, test_video_pad_frag_buffer_list);
 
   tcase_add_test (tc_chain, test_video_pad_reorder);
   tcase_add_test (tc_chain, test_audio_pad_reorder);
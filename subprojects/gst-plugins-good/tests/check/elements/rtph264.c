@@ -1605,6 +1605,53 @@ GST_START_TEST (test_rtph264pay_avc_delta_unit_single_nal_multiple_memories)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_rtph264pay_avc_one_list_per_au)
+{
+  GstHarness *h = gst_harness_new_parse ("rtph264pay mtu=40");
+  GstElement *pay;
+  GstPad *srcpad;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  guint n_lists = 0;
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-h264,alignment=au,stream-format=avc,"
+      "codec_data=(buffer)01f4000dffe1001c67f4000d919b2884d80b50606064000003"
+      "000400000300f23c50a65801000668ebec448440");
+
+  pay = gst_harness_find_element (h, "rtph264pay");
+  srcpad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) count_buffer_lists, &n_lists, NULL);
+
+  buffer = wrap_static_buffer_with_pts (h264_idr_slice_1_avc,
+      sizeof (h264_idr_slice_1_avc), 0);
+  buffer = gst_buffer_append (buffer,
+      wrap_static_buffer_with_pts (h264_idr_slice_2_avc,
+          sizeof (h264_idr_slice_2_avc), 0));
+
+  ret = gst_harness_push (h, buffer);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+
+  /* both NALs are fragmented, all fragments of the AU go out in one list */
+  fail_unless_equals_int (n_lists, 1);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 4);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (pay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtph264_suite (void)
 {
@@ -1635,6 +1682,7 @@ rtph264_suite (void)
 
   tcase_add_test (tc_chain, test_rtph264pay_avc);
   tcase_add_test (tc_chain, test_rtph264pay_avc_two_slices_per_buffer);
+  tcase_add_test (tc_chain, test_rtph264pay_avc_one_list_per_au);
   tcase_add_test (tc_chain, test_rtph264pay_avc_incomplete_nal);
   tcase_add_test (tc_chain,
       test_rtph264pay_avc_two_slices_per_buffer_config_interval);
@@ -24,6 +24,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/check/check.h>
 #include <gst/app/app.h>
 #include <gst/rtp/gstrtpbuffer.h>
@@ -644,6 +646,108 @@ GST_START_TEST (test_rtph265pay_marker_for_fragmented_au)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Pulls the FU packets of @nal and checks that the headers written together
+ * with the fragments are right and that the fragments add up to the NAL */
+static void
+pull_and_check_fu_packets (GstHarness * h, const guint8 * nal, gsize nal_size,
+    guint n_packets, gboolean end_of_au)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  gsize pos = 2;
+  guint i;
+
+  for (i = 0; i < n_packets; i++) {
+    GstBuffer *buffer = gst_harness_pull (h);
+    gboolean first = (i == 0), last = (i == n_packets - 1);
+    guint8 *payload;
+    guint len;
+
+    fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+    payload = gst_rtp_buffer_get_payload (&rtp);
+    len = gst_rtp_buffer_get_payload_len (&rtp);
+    fail_unless (len > 3);
+
+    /* PayloadHdr with type 49 (FU) */
+    fail_unless_equals_int (payload[0], (nal[0] & 0x81) | (49 << 1));
+    fail_unless_equals_int (payload[1], nal[1]);
+    /* FU header */
+    fail_unless_equals_int (payload[2], (first << 7) | (last << 6) |
+        ((nal[0] >> 1) & 0x3f));
+    fail_unless_equals_int (gst_rtp_buffer_get_marker (&rtp), last
+        && end_of_au);
+
+    fail_unless (pos + len - 3 <= nal_size);
+    fail_unless_equals_int (memcmp (payload + 3, nal + pos, len - 3), 0);
+    pos += len - 3;
+
+    gst_rtp_buffer_unmap (&rtp);
+    gst_buffer_unref (buffer);
+  }
+
+  fail_unless_equals_int (pos, nal_size);
+}
+
+GST_START_TEST (test_rtph265pay_one_list_per_au)
+{
+  GstHarness *h = gst_harness_new_parse ("rtph265pay mtu=40"
+      " aggregate-mode=zero-latency");
+  GstElement *pay;
+  GstPad *srcpad;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  guint n_lists = 0;
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-h265,alignment=au,stream-format=byte-stream");
+
+  pay = gst_harness_find_element (h, "rtph265pay");
+  srcpad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) count_buffer_lists, &n_lists, NULL);
+
+  buffer = wrap_static_buffer_with_pts (h265_idr_slice_1,
+      sizeof (h265_idr_slice_1), 0);
+  buffer = gst_buffer_append (buffer,
+      wrap_static_buffer_with_pts (h265_idr_slice_2,
+          sizeof (h265_idr_slice_2), 0));
+
+  ret = gst_harness_push (h, buffer);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+
+  /* both NALs are fragmented, all fragments of the AU go out in one list */
+  fail_unless_equals_int (n_lists, 1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 4);
+
+  /* skip the start codes, only the last fragment of the AU has the marker */
+  pull_and_check_fu_packets (h, h265_idr_slice_1 + 4,
+      sizeof (h265_idr_slice_1) - 4, 2, FALSE);
+  pull_and_check_fu_packets (h, h265_idr_slice_2 + 3,
+      sizeof (h265_idr_slice_2) - 3, 2, TRUE);
+
+  /* the next AU is pushed as a separate list */
+  buffer = wrap_static_buffer_with_pts (h265_idr_slice_1,
+      sizeof (h265_idr_slice_1), GST_SECOND);
+  ret = gst_harness_push (h, buffer);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  fail_unless_equals_int (n_lists, 2);
+  pull_and_check_fu_packets (h, h265_idr_slice_1 + 4,
+      sizeof (h265_idr_slice_1) - 4, 2, TRUE);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (pay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtph265pay_aggregate_two_slices_per_buffer)
 {
   GstHarness *h = gst_harness_new_parse ("rtph265pay timestamp-offset=123"
@@ -1379,6 +1483,7 @@ rtph265_suite (void)
   tcase_add_test (tc_chain, test_rtph265pay_marker_for_flag);
   tcase_add_test (tc_chain, test_rtph265pay_marker_for_au);
   tcase_add_test (tc_chain, test_rtph265pay_marker_for_fragmented_au);
+  tcase_add_test (tc_chain, test_rtph265pay_one_list_per_au);
   tcase_add_test (tc_chain, test_rtph265pay_aggregate_two_slices_per_buffer);
   tcase_add_test (tc_chain, test_rtph265pay_aggregate_with_aud);
   tcase_add_test (tc_chain, test_rtph265pay_aggregate_with_ts_change);
@@ -214,6 +214,110 @@ GST_START_TEST (test_rtxsend_basic)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtxsend_misses)
+{
+  const guint32 main_ssrc = 1234567;
+  const guint main_pt = 96;
+  const guint32 rtx_ssrc = 7654321;
+  const guint rtx_pt = 106;
+  guint rtx_requests, rtx_packets, rtx_misses;
+  guint16 i;
+
+  GstHarness *h = gst_harness_new ("rtprtxsend");
+  GstStructure *ssrc_map =
+      create_rtx_map ("application/x-rtp-ssrc-map", main_ssrc, rtx_ssrc);
+  GstStructure *pt_map =
+      create_rtx_map ("application/x-rtp-pt-map", main_pt, rtx_pt);
+
+  g_object_set (h->element, "ssrc-map", ssrc_map, "payload-type-map", pt_map,
+      "max-size-packets", 10, NULL);
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp, "
+      "clock-rate = (int)90000");
+
+  /* push packets around the seqnum wraparound, only the last 10 are kept */
+  for (i = 65530; i != 10; i++) {
+    push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, i),
+        FALSE, main_ssrc, main_pt, i);
+  }
+
+  /* already removed from the history */
+  gst_harness_push_upstream_event (h,
+      create_rtx_event (main_ssrc, main_pt, 65535));
+  /* not sent yet */
+  gst_harness_push_upstream_event (h, create_rtx_event (main_ssrc, main_pt,
+          10));
+  /* still in the history */
+  gst_harness_push_upstream_event (h, create_rtx_event (main_ssrc, main_pt,
+          0));
+  pull_and_verify (h, TRUE, rtx_ssrc, rtx_pt, 0);
+
+  g_object_get (h->element, "num-rtx-requests", &rtx_requests,
+      "num-rtx-packets", &rtx_packets, "num-rtx-misses", &rtx_misses, NULL);
+  fail_unless_equals_int (rtx_requests, 3);
+  fail_unless_equals_int (rtx_packets, 1);
+  fail_unless_equals_int (rtx_misses, 2);
+
+  gst_structure_free (ssrc_map);
+  gst_structure_free (pt_map);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtxsend_history_span)
+{
+  const guint32 main_ssrc = 1234567;
+  const guint main_pt = 96;
+  const guint32 rtx_ssrc = 7654321;
+  const guint rtx_pt = 106;
+  guint rtx_requests, rtx_packets, rtx_misses;
+  guint i;
+
+  GstHarness *h = gst_harness_new ("rtprtxsend");
+  GstStructure *ssrc_map =
+      create_rtx_map ("application/x-rtp-ssrc-map", main_ssrc, rtx_ssrc);
+  GstStructure *pt_map =
+      create_rtx_map ("application/x-rtp-pt-map", main_pt, rtx_pt);
+
+  g_object_set (h->element, "ssrc-map", ssrc_map, "payload-type-map", pt_map,
+      "max-size-packets", 0, NULL);
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp, "
+      "clock-rate = (int)90000");
+
+  /* with no limit, push more packets than half of the seqnum space, the
+   * oldest ones are dropped instead of the whole history */
+  for (i = 0; i <= 0x8009; i++) {
+    push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, i),
+        FALSE, main_ssrc, main_pt, i);
+  }
+
+  /* the newest packet */
+  gst_harness_push_upstream_event (h, create_rtx_event (main_ssrc, main_pt,
+          0x8009));
+  pull_and_verify (h, TRUE, rtx_ssrc, rtx_pt, 0x8009);
+  /* the oldest packet still in the history */
+  gst_harness_push_upstream_event (h, create_rtx_event (main_ssrc, main_pt,
+          11));
+  pull_and_verify (h, TRUE, rtx_ssrc, rtx_pt, 11);
+  /* already removed from the history */
+  gst_harness_push_upstream_event (h, create_rtx_event (main_ssrc, main_pt,
+          10));
+
+  g_object_get (h->element, "num-rtx-requests", &rtx_requests,
+      "num-rtx-packets", &rtx_packets, "num-rtx-misses", &rtx_misses, NULL);
+  fail_unless_equals_int (rtx_requests, 3);
+  fail_unless_equals_int (rtx_packets, 2);
+  fail_unless_equals_int (rtx_misses, 1);
+
+  gst_structure_free (ssrc_map);
+  gst_structure_free (pt_map);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtxsend_disabled_enabled_disabled)
 {
   const guint32 main_ssrc = 1234567;
@@ -1173,6 +1277,8 @@ rtprtx_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_rtxsend_basic);
+  tcase_add_test (tc_chain, test_rtxsend_misses);
+  tcase_add_test (tc_chain, test_rtxsend_history_span);
   tcase_add_test (tc_chain, test_rtxsend_disabled_enabled_disabled);
   tcase_add_test (tc_chain, test_rtxsend_configured_not_playing_cleans_up);
 
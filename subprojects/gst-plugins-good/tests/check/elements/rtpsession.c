@@ -507,6 +507,75 @@ GST_START_TEST (test_multiple_senders_roundrobin_rbs)
 
 GST_END_TEST;
 
+/* This verifies that with many more senders than RBs fit in one RR, every
+ * sender is reported exactly once over the following RTCP generations */
+GST_START_TEST (test_many_senders_rtcp_generation)
+{
+  SessionHarness *h = session_harness_new ();
+  const gint num_ssrcs = 100;
+  GstFlowReturn res;
+  GstBuffer *buf;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket rtcp_packet;
+  GHashTable *reported;
+  gint i, j, remaining;
+  guint32 ssrc;
+
+  g_object_set (h->internal_session, "internal-ssrc", 0xDEADBEEF, NULL);
+
+  /* keep the sources from timing out while cranking through the
+   * generations */
+  g_object_set (h->session, "rtcp-min-interval", 20 * GST_SECOND, NULL);
+
+  for (j = 0; j < 5; j++) {
+    for (i = 0; i < num_ssrcs; i++) {
+      buf = generate_test_buffer (j, 10000 + i);
+      res = session_harness_recv_rtp (h, buf);
+      fail_unless_equals_int (GST_FLOW_OK, res);
+    }
+  }
+
+  reported = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  for (remaining = num_ssrcs; remaining > 0;
+      remaining -= GST_RTCP_MAX_RB_COUNT) {
+    guint expected_rb_count = MIN (remaining, GST_RTCP_MAX_RB_COUNT);
+
+    session_harness_produce_rtcp (h, 1);
+    buf = session_harness_pull_rtcp (h);
+    g_assert (buf != NULL);
+    fail_unless (gst_rtcp_buffer_validate (buf));
+
+    gst_rtcp_buffer_map (buf, GST_MAP_READ, &rtcp);
+    fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &rtcp_packet));
+    fail_unless_equals_int (GST_RTCP_TYPE_RR,
+        gst_rtcp_packet_get_type (&rtcp_packet));
+    fail_unless_equals_int (0xDEADBEEF,
+        gst_rtcp_packet_rr_get_ssrc (&rtcp_packet));
+    fail_unless_equals_int (expected_rb_count,
+        gst_rtcp_packet_get_rb_count (&rtcp_packet));
+
+    for (i = 0; i < expected_rb_count; i++) {
+      gst_rtcp_packet_get_rb (&rtcp_packet, i, &ssrc, NULL, NULL,
+          NULL, NULL, NULL, NULL);
+      g_assert_cmpint (ssrc, >=, 10000);
+      g_assert_cmpint (ssrc, <, 10000 + num_ssrcs);
+      /* no sender is reported twice before all others are reported */
+      fail_unless (g_hash_table_add (reported, GUINT_TO_POINTER (ssrc)));
+    }
+
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_unref (buf);
+  }
+
+  fail_unless_equals_int (num_ssrcs, g_hash_table_size (reported));
+
+  g_hash_table_unref (reported);
+  session_harness_free (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_no_rbs_for_internal_senders)
 {
   SessionHarness *h = session_harness_new ();
@@ -4125,6 +4194,79 @@ GST_START_TEST (test_twcc_send_and_recv)
 
 GST_END_TEST;
 
+typedef struct
+{
+  guint count;
+  guint bitrate_sent;
+  guint bitrate_recv;
+  gdouble packet_loss_pct;
+  gint64 avg_delta_of_delta;
+} BandwidthEstimate;
+
+static void
+on_bandwidth_estimate (GstElement * session, guint bitrate_sent,
+    guint bitrate_recv, gdouble packet_loss_pct, gint64 avg_delta_of_delta,
+    BandwidthEstimate * estimate)
+{
+  estimate->count++;
+  estimate->bitrate_sent = bitrate_sent;
+  estimate->bitrate_recv = bitrate_recv;
+  estimate->packet_loss_pct = packet_loss_pct;
+  estimate->avg_delta_of_delta = avg_delta_of_delta;
+}
+
+GST_START_TEST (test_twcc_bandwidth_estimate_signal)
+{
+  SessionHarness *h_send = session_harness_new ();
+  SessionHarness *h_recv = session_harness_new ();
+  BandwidthEstimate estimate = { 0, };
+  guint frame;
+  const guint num_frames = 2;
+  const guint num_slices = 15;
+
+  /* enable twcc */
+  session_harness_set_twcc_recv_ext_id (h_recv, TEST_TWCC_EXT_ID);
+  session_harness_set_twcc_send_ext_id (h_send, TEST_TWCC_EXT_ID);
+
+  g_signal_connect (h_send->session, "on-bandwidth-estimate",
+      G_CALLBACK (on_bandwidth_estimate), &estimate);
+
+  for (frame = 0; frame < num_frames; frame++) {
+    GstBuffer *buf;
+    guint slice;
+
+    for (slice = 0; slice < num_slices; slice++) {
+      guint seq = frame * num_slices + slice;
+
+      buf = generate_twcc_send_buffer (seq, slice == num_slices - 1);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_send_rtp (h_send, buf));
+      session_harness_advance_and_crank (h_send, TEST_BUF_DURATION);
+
+      buf = session_harness_pull_send_rtp (h_send);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_recv_rtp (h_recv, buf));
+    }
+
+    buf = session_harness_produce_twcc (h_recv);
+    session_harness_recv_rtcp (h_send, buf);
+
+    /* one estimate for each feedback, matching the twcc-stats */
+    fail_unless_equals_int (estimate.count, frame + 1);
+    if (frame > 0) {
+      fail_unless_equals_int (estimate.bitrate_sent, TEST_BUF_BPS);
+      fail_unless_equals_int (estimate.bitrate_recv, TEST_BUF_BPS);
+      fail_unless_equals_float (estimate.packet_loss_pct, 0.0f);
+      fail_unless_equals_int64 (estimate.avg_delta_of_delta, 0);
+    }
+  }
+
+  session_harness_free (h_send);
+  session_harness_free (h_recv);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_twcc_multiple_payloads_below_window)
 {
   SessionHarness *h_send = session_harness_new ();
@@ -4397,6 +4539,7 @@ rtpsession_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_multiple_ssrc_rr);
   tcase_add_test (tc_chain, test_multiple_senders_roundrobin_rbs);
+  tcase_add_test (tc_chain, test_many_senders_rtcp_generation);
   tcase_add_test (tc_chain, test_no_rbs_for_internal_senders);
   tcase_add_test (tc_chain, test_internal_sources_timeout);
   tcase_add_test (tc_chain, test_receive_rtcp_app_packet);
@@ -4462,6 +4605,7 @@ rtpsession_suite (void)
   tcase_add_test (tc_chain, test_twcc_recv_rtcp_reordered);
   tcase_add_test (tc_chain, test_twcc_no_exthdr_in_buffer);
   tcase_add_test (tc_chain, test_twcc_send_and_recv);
+  tcase_add_test (tc_chain, test_twcc_bandwidth_estimate_signal);
   tcase_add_test (tc_chain, test_twcc_multiple_payloads_below_window);
   tcase_add_loop_test (tc_chain, test_twcc_feedback_interval, 0,
       G_N_ELEMENTS (test_twcc_feedback_interval_ctx));
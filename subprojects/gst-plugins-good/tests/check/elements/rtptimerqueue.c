@@ -208,6 +208,44 @@ GST_START_TEST (test_timer_queue_reschedule)
 
 GST_END_TEST;
 
+GST_START_TEST (test_timer_queue_insert_near)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  RtpTimer *timer;
+  guint i;
+
+  for (i = 0; i < 10; i++) {
+    if (i != 5)
+      rtp_timer_queue_set_expected (queue, i, i * 10 * GST_MSECOND, 0, 0);
+  }
+  rtp_timer_queue_set_lost (queue, 100, GST_SECOND, 0, 0);
+
+  /* lands after the timer of seqnum 4 */
+  rtp_timer_queue_set_expected (queue, 5, 50 * GST_MSECOND, 0, 0);
+  timer = rtp_timer_queue_find (queue, 5);
+  fail_unless_equals_int (4, rtp_timer_get_prev (timer)->seqnum);
+  fail_unless_equals_int (6, rtp_timer_get_next (timer)->seqnum);
+
+  /* earlier than the timer of seqnum 9, must walk back to the head */
+  rtp_timer_queue_set_expected (queue, 10, 5 * GST_MSECOND, 0, 0);
+  timer = rtp_timer_queue_find (queue, 10);
+  fail_unless_equals_int (0, rtp_timer_get_prev (timer)->seqnum);
+  fail_unless_equals_int (1, rtp_timer_get_next (timer)->seqnum);
+
+  /* the ordering matches a plain walk from the tail */
+  timer = rtp_timer_queue_peek_earliest (queue);
+  for (i = 0; i < rtp_timer_queue_length (queue) - 1; i++) {
+    RtpTimer *next = rtp_timer_get_next (timer);
+    fail_unless (timer->timeout <= next->timeout);
+    timer = next;
+  }
+  fail_unless_equals_int (100, timer->seqnum);
+
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_timer_queue_pop_until)
 {
   RtpTimerQueue *queue = rtp_timer_queue_new ();
@@ -315,6 +353,7 @@ rtptimerqueue_suite (void)
   tcase_add_test (tc_chain, test_timer_queue_set_timer);
   tcase_add_test (tc_chain, test_timer_queue_insert_head);
   tcase_add_test (tc_chain, test_timer_queue_reschedule);
+  tcase_add_test (tc_chain, test_timer_queue_insert_near);
   tcase_add_test (tc_chain, test_timer_queue_pop_until);
   tcase_add_test (tc_chain, test_timer_queue_update_timer_seqnum);
   tcase_add_test (tc_chain, test_timer_queue_dup_timer);
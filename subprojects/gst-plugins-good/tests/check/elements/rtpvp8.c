@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/check/check.h>
 #include <gst/check/gstharness.h>
 
@@ -866,6 +868,100 @@ GST_START_TEST (test_pay_delta_unit_flag)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Pulls the packets of @frame and checks that the payload descriptors written
+ * together with the fragments are right and that the fragments add up to the
+ * frame */
+static void
+pull_and_check_frame_packets (GstHarness * h, const guint8 * frame,
+    gsize frame_size, guint n_packets, guint16 picture_id)
+{
+  gsize pos = 0;
+  guint i;
+
+  for (i = 0; i < n_packets; i++) {
+    GstBuffer *buffer = gst_harness_pull (h);
+    GstMapInfo map = GST_MAP_INFO_INIT;
+    gboolean first = (i == 0), last = (i == n_packets - 1);
+    gsize len;
+
+    fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+    fail_unless (map.size > 12 + 4);
+
+    /* marker only on the last packet of the frame */
+    fail_unless_equals_int ((map.data[1] & 0x80) != 0, last);
+
+    /* X=1, S set on the first packet, which starts partition 0 */
+    fail_unless_equals_int (map.data[12] & 0x80, 0x80);
+    if (first)
+      fail_unless_equals_int (map.data[12] & 0x1f, 0x10);
+    /* I=1 with a 15 bit picture id */
+    fail_unless_equals_int (map.data[13], 0x80);
+    fail_unless_equals_int (map.data[14], 0x80 | (picture_id >> 8));
+    fail_unless_equals_int (map.data[15], picture_id & 0xff);
+
+    len = map.size - 12 - 4;
+    fail_unless (pos + len <= frame_size);
+    fail_unless_equals_int (memcmp (map.data + 16, frame + pos, len), 0);
+    pos += len;
+
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_unref (buffer);
+  }
+
+  fail_unless_equals_int (pos, frame_size);
+}
+
+GST_START_TEST (test_pay_one_list_per_frame)
+{
+  guint8 vp8_bitstream_payload[] = {
+    0x30, 0x00, 0x00, 0x9d, 0x01, 0x2a, 0xb0, 0x00,
+    0x90, 0x00, 0x06, 0x47, 0x08, 0x85, 0x85, 0x88,
+    0x99, 0x84, 0x88, 0x21, 0x00
+  };
+  GstHarness *h = gst_harness_new_parse ("rtpvp8pay mtu=28");
+  GstElement *pay;
+  GstPad *srcpad;
+  GstFlowReturn ret;
+  guint n_lists = 0;
+  guint i;
+
+  gst_harness_set_src_caps_str (h, "video/x-vp8");
+
+  pay = gst_harness_find_element (h, "rtpvp8pay");
+  g_object_set (pay, "picture-id-mode", VP8_PAY_PICTURE_ID_15BITS,
+      "picture-id-offset", 0x5A5A, NULL);
+  srcpad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) count_buffer_lists, &n_lists, NULL);
+
+  for (i = 0; i < 2; i++) {
+    ret = gst_harness_push (h,
+        gst_buffer_new_memdup (vp8_bitstream_payload,
+            sizeof (vp8_bitstream_payload)));
+    fail_unless_equals_int (ret, GST_FLOW_OK);
+
+    /* the frame is split into two packets, pushed as one list */
+    fail_unless_equals_int (n_lists, i + 1);
+    fail_unless_equals_int (gst_harness_buffers_in_queue (h), 2);
+    pull_and_check_frame_packets (h, vp8_bitstream_payload,
+        sizeof (vp8_bitstream_payload), 2, 0x5A5A + i);
+  }
+
+  gst_object_unref (srcpad);
+  gst_object_unref (pay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtpvp8_suite (void)
 {
@@ -884,6 +980,7 @@ rtpvp8_suite (void)
   tcase_add_test (tc_chain, test_pay_tl0picidx_split_buffer);
   tcase_add_test (tc_chain, test_pay_continuous_picture_id_on_flush);
   tcase_add_test (tc_chain, test_pay_delta_unit_flag);
+  tcase_add_test (tc_chain, test_pay_one_list_per_frame);
 
   suite_add_tcase (s, (tc_chain = tcase_create ("vp8depay")));
   tcase_add_loop_test (tc_chain, test_depay_stop_gap_events, 0,
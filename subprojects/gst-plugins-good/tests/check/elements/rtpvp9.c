@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/check/check.h>
 #include <gst/check/gstharness.h>
 #include <gst/rtp/gstrtpbuffer.h>
@@ -479,6 +481,106 @@ GST_START_TEST (test_pay_delta_unit_flag)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, guint * n_lists)
+{
+  (*n_lists)++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Pulls the packets of the key frame @frame and checks that the payload
+ * descriptors written together with the fragments are right and that the
+ * fragments add up to the frame */
+static void
+pull_and_check_frame_packets (GstHarness * h, const guint8 * frame,
+    gsize frame_size, guint n_packets, guint16 picture_id)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  gsize pos = 0;
+  guint i;
+
+  for (i = 0; i < n_packets; i++) {
+    GstBuffer *buffer = gst_harness_pull (h);
+    gboolean first = (i == 0), last = (i == n_packets - 1);
+    guint8 *payload;
+    guint len, hdrlen;
+
+    fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+    payload = gst_rtp_buffer_get_payload (&rtp);
+    len = gst_rtp_buffer_get_payload_len (&rtp);
+
+    fail_unless_equals_int (gst_rtp_buffer_get_marker (&rtp), last);
+
+    /* I=1, B on the first packet, E on the last packet, SS (V) only with the
+     * start of the key frame */
+    fail_unless_equals_int (payload[0] & 0x80, 0x80);
+    fail_unless_equals_int ((payload[0] & 0x08) != 0, first);
+    fail_unless_equals_int ((payload[0] & 0x04) != 0, last);
+    fail_unless_equals_int ((payload[0] & 0x02) != 0, first);
+    /* M=1 with a 15 bit picture id */
+    fail_unless_equals_int (payload[1], 0x80 | (picture_id >> 8));
+    fail_unless_equals_int (payload[2], picture_id & 0xff);
+
+    hdrlen = first ? 3 + 8 : 3;
+    fail_unless (len > hdrlen);
+    fail_unless (pos + len - hdrlen <= frame_size);
+    fail_unless_equals_int (memcmp (payload + hdrlen, frame + pos,
+            len - hdrlen), 0);
+    pos += len - hdrlen;
+
+    gst_rtp_buffer_unmap (&rtp);
+    gst_buffer_unref (buffer);
+  }
+
+  fail_unless_equals_int (pos, frame_size);
+}
+
+GST_START_TEST (test_pay_one_list_per_frame)
+{
+  guint8 vp9_bitstream_payload[] = {
+    0xa2, 0x49, 0x83, 0x42, 0x20, 0x00, 0x1e, 0x00,
+    0x1e, 0xc0, 0x07, 0x04, 0x83, 0x83, 0x08, 0x40,
+    0x00, 0x06, 0x60, 0x00, 0x00, 0x10, 0xbf, 0xff,
+    0x5a, 0x0f, 0xff, 0xff, 0xff, 0xfb, 0xc9, 0x83,
+    0xff, 0xff, 0xff, 0xff, 0x34, 0xca, 0x00
+  };
+  GstHarness *h = gst_harness_new_parse ("rtpvp9pay mtu=48");
+  GstElement *pay;
+  GstPad *srcpad;
+  GstFlowReturn ret;
+  guint n_lists = 0;
+  guint i;
+
+  gst_harness_set_src_caps_str (h, "video/x-vp9");
+
+  pay = gst_harness_find_element (h, "rtpvp9pay");
+  gst_util_set_object_arg (G_OBJECT (pay), "picture-id-mode", "15-bit");
+  g_object_set (pay, "picture-id-offset", 0x5A5A, NULL);
+  srcpad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) count_buffer_lists, &n_lists, NULL);
+
+  for (i = 0; i < 2; i++) {
+    ret = gst_harness_push (h,
+        gst_buffer_new_memdup (vp9_bitstream_payload,
+            sizeof (vp9_bitstream_payload)));
+    fail_unless_equals_int (ret, GST_FLOW_OK);
+
+    /* the frame is split into two packets, pushed as one list */
+    fail_unless_equals_int (n_lists, i + 1);
+    fail_unless_equals_int (gst_harness_buffers_in_queue (h), 2);
+    pull_and_check_frame_packets (h, vp9_bitstream_payload,
+        sizeof (vp9_bitstream_payload), 2, 0x5A5A + i);
+  }
+
+  gst_object_unref (srcpad);
+  gst_object_unref (pay);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static void
 fail_unless_vp9_ss (GstBuffer * buf, gint width, gint height)
 {
@@ -607,6 +709,7 @@ rtpvp9_suite (void)
 
   suite_add_tcase (s, (tc_chain = tcase_create ("vp9pay")));
   tcase_add_test (tc_chain, test_pay_delta_unit_flag);
+  tcase_add_test (tc_chain, test_pay_one_list_per_frame);
 
   suite_add_tcase (s, (tc_chain =
           tcase_create ("vp9pay-ss-resolution-profile")));
@@ -0,0 +1,194 @@
+/* GStreamer
+ *
+ * Minimal HTTP/1.1 server for unit tests
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gio/gio.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test_http_server.h"
+
+struct _TestHttpServer
+{
+  GSocketService *service;
+  guint16 port;
+
+  TestHttpServerCallbacks callbacks;
+  guint response_delay_ms;
+  gpointer user_data;
+
+  GMutex lock;
+  guint requests;
+  guint active;
+  guint max_active;
+};
+
+static gboolean
+on_http_connection (GThreadedSocketService * service,
+    GSocketConnection * connection, GObject * source_object,
+    TestHttpServer * server)
+{
+  GOutputStream *out = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+  GDataInputStream *in;
+  gint64 range_start = 0, range_end = -1, total_size;
+  gboolean has_range = FALSE;
+  gchar *line, *path = NULL, *headers;
+  guint8 *body;
+  gsize size;
+
+  in = g_data_input_stream_new (g_io_stream_get_input_stream (G_IO_STREAM
+          (connection)));
+  g_filter_input_stream_set_close_base_stream (G_FILTER_INPUT_STREAM (in),
+      FALSE);
+
+  /* Request line, then headers up to the empty line */
+  line = g_data_input_stream_read_line (in, NULL, NULL, NULL);
+  if (line != NULL) {
+    gchar **tokens = g_strsplit (line, " ", 3);
+    if (g_strv_length (tokens) >= 2)
+      path = g_strdup (tokens[1]);
+    g_strfreev (tokens);
+    g_free (line);
+  }
+
+  while ((line = g_data_input_stream_read_line (in, NULL, NULL, NULL))) {
+    g_strchomp (line);
+    if (*line == '\0') {
+      g_free (line);
+      break;
+    }
+    if (!g_ascii_strncasecmp (line, "Range: bytes=", 13)) {
+      sscanf (line + 13, "%" G_GINT64_FORMAT "-%" G_GINT64_FORMAT,
+          &range_start, &range_end);
+      has_range = TRUE;
+    }
+    g_free (line);
+  }
+  g_object_unref (in);
+
+  if (path == NULL)
+    return TRUE;
+
+  if (server->callbacks.request) {
+    server->callbacks.request (path, has_range, range_start, range_end,
+        server->user_data);
+  }
+
+  g_mutex_lock (&server->lock);
+  server->requests++;
+  server->active++;
+  server->max_active = MAX (server->max_active, server->active);
+  g_mutex_unlock (&server->lock);
+
+  if (server->response_delay_ms > 0)
+    g_usleep (server->response_delay_ms * 1000);
+
+  total_size = server->callbacks.get_size (path, server->user_data);
+  if (range_end < 0 || range_end >= total_size)
+    range_end = total_size - 1;
+  size = range_end - range_start + 1;
+
+  body = g_malloc (size);
+  server->callbacks.fill (path, body, size, range_start, server->user_data);
+
+  if (has_range) {
+    headers = g_strdup_printf ("HTTP/1.1 206 Partial Content\r\n"
+        "Content-Range: bytes %" G_GINT64_FORMAT "-%" G_GINT64_FORMAT "/%"
+        G_GINT64_FORMAT "\r\n"
+        "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+        "Connection: close\r\n\r\n", range_start, range_end, total_size,
+        size);
+  } else {
+    headers = g_strdup_printf ("HTTP/1.1 200 OK\r\n"
+        "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+        "Connection: close\r\n\r\n", size);
+  }
+
+  g_output_stream_write_all (out, headers, strlen (headers), NULL, NULL, NULL);
+  g_output_stream_write_all (out, body, size, NULL, NULL, NULL);
+  g_io_stream_close (G_IO_STREAM (connection), NULL, NULL);
+
+  g_mutex_lock (&server->lock);
+  server->active--;
+  g_mutex_unlock (&server->lock);
+
+  g_free (headers);
+  g_free (body);
+  g_free (path);
+
+  return TRUE;
+}
+
+TestHttpServer *
+test_http_server_new (const TestHttpServerCallbacks * callbacks,
+    guint response_delay_ms, gpointer user_data)
+{
+  TestHttpServer *server = g_new0 (TestHttpServer, 1);
+  GError *err = NULL;
+
+  server->callbacks = *callbacks;
+  server->response_delay_ms = response_delay_ms;
+  server->user_data = user_data;
+  g_mutex_init (&server->lock);
+
+  server->service = g_threaded_socket_service_new (16);
+  server->port =
+      g_socket_listener_add_any_inet_port (G_SOCKET_LISTENER (server->service),
+      NULL, &err);
+  if (server->port == 0) {
+    GST_ERROR ("Failed to listen: %s", err->message);
+    g_clear_error (&err);
+    test_http_server_free (server);
+    return NULL;
+  }
+
+  g_signal_connect (server->service, "run", G_CALLBACK (on_http_connection),
+      server);
+  g_socket_service_start (server->service);
+
+  return server;
+}
+
+guint16
+test_http_server_get_port (TestHttpServer * server)
+{
+  return server->port;
+}
+
+void
+test_http_server_get_stats (TestHttpServer * server, guint * requests,
+    guint * max_active)
+{
+  g_mutex_lock (&server->lock);
+  if (requests)
+    *requests = server->requests;
+  if (max_active)
+    *max_active = server->max_active;
+  g_mutex_unlock (&server->lock);
+}
+
+void
+test_http_server_free (TestHttpServer * server)
+{
+  g_socket_service_stop (server->service);
+  g_socket_listener_close (G_SOCKET_LISTENER (server->service));
+  g_object_unref (server->service);
+  g_mutex_clear (&server->lock);
+  g_free (server);
+}
@@ -0,0 +1,98 @@
+/* GStreamer
+ *
+ * Minimal HTTP/1.1 server for unit tests
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TEST_HTTP_SERVER_H__
+#define __TEST_HTTP_SERVER_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Opaque structure used by the test server */
+typedef struct _TestHttpServer TestHttpServer;
+
+/* All callbacks are called from the server threads, one per connection */
+typedef struct _TestHttpServerCallbacks
+{
+  /**
+   * get_size:
+   * @path: the path of the requested resource
+   * @user_data: the value of user_data passed to test_http_server_new()
+   * Returns: the full size of the resource, in bytes
+   */
+  gint64 (*get_size) (const gchar * path, gpointer user_data);
+
+  /**
+   * fill:
+   * @path: the path of the requested resource
+   * @data: the response body to fill
+   * @size: the number of bytes to fill in @data
+   * @offset: the offset of @data in the resource
+   * @user_data: the value of user_data passed to test_http_server_new()
+   */
+  void (*fill) (const gchar * path, guint8 * data, gsize size, gint64 offset,
+      gpointer user_data);
+
+  /**
+   * request: (optional)
+   * @path: the path of the requested resource
+   * @has_range: whether the request has a Range header
+   * @range_start: the first requested byte
+   * @range_end: the last requested byte, or -1 for the end of the resource
+   * @user_data: the value of user_data passed to test_http_server_new()
+   *
+   * Called for every request, before it is answered.
+   */
+  void (*request) (const gchar * path, gboolean has_range, gint64 range_start,
+      gint64 range_end, gpointer user_data);
+} TestHttpServerCallbacks;
+
+/**
+ * test_http_server_new:
+ * @callbacks: the callbacks providing the resources
+ * @response_delay_ms: delay before answering each request, standing in for
+ * the round trip time of a remote server
+ * @user_data: a pointer that is passed to every callback
+ *
+ * Starts listening on a local port. Requests with a Range header are
+ * answered with 206 Partial Content, all others with 200 OK.
+ *
+ * Returns: the new server, or %NULL if it could not listen
+ */
+TestHttpServer *test_http_server_new (const TestHttpServerCallbacks * callbacks,
+    guint response_delay_ms, gpointer user_data);
+
+guint16 test_http_server_get_port (TestHttpServer * server);
+
+/**
+ * test_http_server_get_stats:
+ * @server: a #TestHttpServer
+ * @requests: (out) (optional): the number of requests so far
+ * @max_active: (out) (optional): the highest number of requests that were
+ * answered at the same time
+ */
+void test_http_server_get_stats (TestHttpServer * server, guint * requests,
+    guint * max_active);
+
+void test_http_server_free (TestHttpServer * server);
+
+G_END_DECLS
+
+#endif /* __TEST_HTTP_SERVER_H__ */
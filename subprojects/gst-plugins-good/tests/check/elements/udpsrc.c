@@ -17,6 +17,7 @@
  * Boston, MA 02110-1301, USA.
  */
 #include <gst/check/gstcheck.h>
+#include <gst/net/gstnetaddressmeta.h>
 #include <gio/gio.h>
 #include <stdlib.h>
 
@@ -27,7 +28,7 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
 
 static gboolean
 udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
-    GstPad ** sinkpad, GSocketAddress ** sa)
+    GstPad ** sinkpad, GSocketAddress ** sa, guint batch_size)
 {
   GInetAddress *ia;
   int port = 0;
@@ -35,7 +36,7 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
 
   *udpsrc = gst_check_setup_element ("udpsrc");
   fail_unless (*udpsrc != NULL);
-  g_object_set (*udpsrc, "port", 0, NULL);
+  g_object_set (*udpsrc, "port", 0, "batch-size", batch_size, NULL);
 
   *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
   fail_unless (*sinkpad != NULL);
@@ -70,7 +71,7 @@ GST_START_TEST (test_udpsrc_empty_packet)
   GSocket *socket = NULL;
   GstPad *sinkpad = NULL;
 
-  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa))
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 1))
     goto no_socket;
 
   if (g_socket_send_to (socket, sa, "HeLL0", 0, NULL, NULL) == 0) {
@@ -152,7 +153,7 @@ GST_START_TEST (test_udpsrc)
   for (i = 0; i < G_N_ELEMENTS (data); ++i)
     data[i] = i & 0xff;
 
-  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa))
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 1))
     goto no_socket;
 
   if ((sent = g_socket_send_to (socket, sa, data, 48000, NULL, &err)) == -1)
@@ -247,6 +248,94 @@ send_failure:
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  gint *n_listed = user_data;
+
+  g_atomic_int_add (n_listed,
+      gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info)));
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_udpsrc_batch)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstBuffer *buf;
+  gchar data[1000];
+  int i, len = 0;
+  gssize sent;
+  GError *err = NULL;
+  gint n_listed = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (data); ++i)
+    data[i] = i & 0xff;
+
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 8))
+    goto no_socket;
+
+  /* a plain buffer would not pass this probe */
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_buffer_lists, &n_listed, NULL);
+
+  for (i = 1; i <= 4; i++) {
+    if ((sent = g_socket_send_to (socket, sa, data, i * 100, NULL, &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, i * 100);
+  }
+
+  GST_INFO ("sent some packets");
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < 4) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+    GST_INFO ("%u buffers", len);
+  }
+
+  /* every packet is its own buffer, timestamped and with the sender address,
+   * whether or not it was received together with others */
+  for (i = 0; i < 4; i++) {
+    buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (buf), (i + 1) * 100);
+    fail_unless (gst_buffer_memcmp (buf, 0, data, (i + 1) * 100) == 0);
+    fail_unless (GST_BUFFER_DTS_IS_VALID (buf));
+    fail_unless (gst_buffer_get_net_address_meta (buf) != NULL);
+  }
+
+  /* and all of them were pushed in buffer lists */
+  fail_unless_equals_int (g_atomic_int_get (&n_listed), 4);
+
+  g_list_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
 static void
 on_multicast_source_updated (GObject * src, GParamSpec * pspec, guint * count)
 {
@@ -305,6 +394,7 @@ udpsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_udpsrc_empty_packet);
   tcase_add_test (tc_chain, test_udpsrc);
+  tcase_add_test (tc_chain, test_udpsrc_batch);
   tcase_add_test (tc_chain, test_udpsrc_multicast_source);
 
   return s;
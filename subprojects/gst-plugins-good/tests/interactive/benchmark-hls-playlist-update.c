@@ -0,0 +1,163 @@
+/* GStreamer HLS live playlist update parsing benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Generates successive updates of a live media playlist with a large sliding
+ * window (as used for long DVR windows) and measures how long it takes to
+ * parse every update from scratch, and on top of the previous update the
+ * way hlsdemux2 does for refreshes of the same playlist. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/gst.h>
+
+#include "m3u8.h"
+
+#define PLAYLIST_URI "http://localhost/live/media.m3u8"
+
+GST_DEBUG_CATEGORY (hls2_debug);
+
+static gchar *
+generate_playlist (guint first, guint n_segments, gboolean with_pdt)
+{
+  GString *s = g_string_sized_new (n_segments * 80);
+  GDateTime *epoch = g_date_time_new_utc (2024, 1, 1, 0, 0, 0);
+  guint i;
+
+  g_string_append_printf (s, "#EXTM3U\n"
+      "#EXT-X-VERSION:6\n"
+      "#EXT-X-TARGETDURATION:2\n"
+      "#EXT-X-MEDIA-SEQUENCE:%u\n"
+      "#EXT-X-DISCONTINUITY-SEQUENCE:0\n"
+      "#EXT-X-MAP:URI=\"init.mp4\"\n", first);
+
+  for (i = first; i < first + n_segments; i++) {
+    if (with_pdt) {
+      GDateTime *dt = g_date_time_add_seconds (epoch, 2.0 * i);
+      gchar *str = g_date_time_format_iso8601 (dt);
+
+      g_string_append_printf (s, "#EXT-X-PROGRAM-DATE-TIME:%s\n", str);
+      g_free (str);
+      g_date_time_unref (dt);
+    }
+    g_string_append_printf (s, "#EXTINF:2.000,\nsegment-%u.m4s\n", i);
+  }
+
+  g_date_time_unref (epoch);
+
+  return g_string_free (s, FALSE);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint n_segments = 10800;
+  gint n_updates = 100;
+  gint n_appended = 1;
+  gboolean with_pdt = FALSE;
+  GOptionContext *ctx;
+  GstHLSMediaPlaylist *full = NULL, *incremental = NULL;
+  GstClockTime start, full_time = 0, incremental_time = 0;
+  gsize size = 0;
+  gint i;
+  GOptionEntry options[] = {
+    {"segments", 's', 0, G_OPTION_ARG_INT, &n_segments,
+        "Number of segments in the playlist window", "N"},
+    {"updates", 'n', 0, G_OPTION_ARG_INT, &n_updates,
+        "Number of playlist updates to parse", "N"},
+    {"appended", 'a', 0, G_OPTION_ARG_INT, &n_appended,
+        "Number of segments appended by each update", "N"},
+    {"pdt", 0, 0, G_OPTION_ARG_NONE, &with_pdt,
+        "Add an EXT-X-PROGRAM-DATE-TIME tag to every segment", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("- HLS playlist update benchmark");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_segments <= 0 || n_updates <= 0 || n_appended <= 0) {
+    gst_printerrln ("usage: %s [-s N] [-n N] [-a N] [--pdt]", argv[0]);
+    return 1;
+  }
+
+  GST_DEBUG_CATEGORY_INIT (hls2_debug, "hlsdemux2", 0, "HLS demuxer");
+
+  for (i = 0; i <= n_updates; i++) {
+    gchar *data = generate_playlist (i * n_appended, n_segments, with_pdt);
+    GstHLSMediaPlaylist *pl;
+
+    size = strlen (data);
+
+    start = gst_util_get_timestamp ();
+    pl = gst_hls_media_playlist_parse (g_strdup (data), GST_CLOCK_TIME_NONE,
+        PLAYLIST_URI, NULL);
+    if (i > 0)
+      full_time += gst_util_get_timestamp () - start;
+    g_clear_pointer (&full, gst_hls_media_playlist_unref);
+    full = pl;
+
+    /* The first playlist is always parsed fully */
+    start = gst_util_get_timestamp ();
+    if (incremental) {
+      pl = gst_hls_media_playlist_parse_update (incremental, data,
+          GST_CLOCK_TIME_NONE, PLAYLIST_URI, NULL);
+    } else {
+      pl = gst_hls_media_playlist_parse (data, GST_CLOCK_TIME_NONE,
+          PLAYLIST_URI, NULL);
+    }
+    if (i > 0)
+      incremental_time += gst_util_get_timestamp () - start;
+    g_clear_pointer (&incremental, gst_hls_media_playlist_unref);
+    incremental = pl;
+
+    if (full == NULL || incremental == NULL) {
+      gst_printerrln ("Failed to parse update %d", i);
+      return 1;
+    }
+    if (full->segments->len != incremental->segments->len) {
+      gst_printerrln ("Update %d: %u segments with a full parse, %u on top of"
+          " the previous update", i, full->segments->len,
+          incremental->segments->len);
+      return 1;
+    }
+  }
+
+  gst_println ("%d segments (%" G_GSIZE_FORMAT " bytes), %d appended per "
+      "update", n_segments, size, n_appended);
+  gst_println ("full parse:        %" GST_TIME_FORMAT " per update",
+      GST_TIME_ARGS (full_time / n_updates));
+  gst_println ("incremental parse: %" GST_TIME_FORMAT " per update (%.1fx)",
+      GST_TIME_ARGS (incremental_time / n_updates),
+      (gdouble) full_time / MAX (incremental_time, 1));
+
+  gst_hls_media_playlist_unref (full);
+  gst_hls_media_playlist_unref (incremental);
+
+  return 0;
+}
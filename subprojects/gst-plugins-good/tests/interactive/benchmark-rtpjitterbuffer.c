@@ -0,0 +1,203 @@
+/* GStreamer RTP jitterbuffer packet and timer queue benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Replays reordering and loss patterns through the packet queue and the timer
+ * queue of the jitterbuffer, the same way the element uses them: every packet
+ * is inserted, its timer is cancelled, timers are scheduled for the gaps and
+ * packets are popped once they are older than the latency. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "gst/rtpmanager/rtpjitterbuffer.h"
+#include "gst/rtpmanager/rtptimerqueue.h"
+
+/* 50 Mbit/s of 1316 bytes payloads */
+#define DEFAULT_PACKET_RATE 4750
+#define DEFAULT_LATENCY 2000
+#define DEFAULT_PACKETS 500000
+
+/* maximum amount of expected timers scheduled for a single gap */
+#define MAX_GAP_TIMERS 1000
+
+typedef enum
+{
+  PATTERN_IN_ORDER,
+  PATTERN_REORDER,
+  PATTERN_LOSS,
+  PATTERN_LATE,
+} Pattern;
+
+static const gchar *pattern_names[] = {
+  "in-order", "reorder", "loss", "late"
+};
+
+static guint16 *
+generate_pattern (Pattern pattern, guint n_packets, guint depth,
+    guint * n_out)
+{
+  GRand *rand = g_rand_new_with_seed (42);
+  guint16 *seqnums = g_new (guint16, n_packets);
+  guint i, n = 0;
+
+  /* start close to the wraparound */
+  for (i = 0; i < n_packets; i++) {
+    if (pattern == PATTERN_LOSS && g_rand_int_range (rand, 0, 100) < 2)
+      continue;
+    seqnums[n++] = (guint16) (65000 + i);
+  }
+
+  for (i = 0; i < n; i++) {
+    guint other, dist;
+    guint16 tmp;
+
+    if (pattern == PATTERN_REORDER && g_rand_int_range (rand, 0, 10) == 0)
+      dist = g_rand_int_range (rand, 1, 33);
+    else if (pattern == PATTERN_LATE && g_rand_int_range (rand, 0, 100) == 0)
+      dist = MAX (depth / 2, 1);
+    else
+      continue;
+
+    other = MIN (i + dist, n - 1);
+    tmp = seqnums[i];
+    seqnums[i] = seqnums[other];
+    seqnums[other] = tmp;
+  }
+
+  g_rand_free (rand);
+  *n_out = n;
+
+  return seqnums;
+}
+
+static void
+do_benchmark (Pattern pattern, guint rate, guint latency, guint n_packets)
+{
+  RTPJitterBuffer *jbuf;
+  RtpTimerQueue *timers;
+  GstBuffer *buf;
+  GTimer *gtimer;
+  guint16 *seqnums, max_seqnum = 0;
+  GstClockTime duration, latency_ns;
+  guint i, n, depth, n_timers = 0;
+  gboolean have_max = FALSE;
+  gdouble elapsed;
+
+  depth = MAX ((guint64) rate * latency / 1000, 1);
+  duration = GST_SECOND / rate;
+  latency_ns = latency * GST_MSECOND;
+  seqnums = generate_pattern (pattern, n_packets, depth, &n);
+
+  jbuf = rtp_jitter_buffer_new ();
+  timers = rtp_timer_queue_new ();
+  buf = gst_buffer_new ();
+  gtimer = g_timer_new ();
+
+  for (i = 0; i < n; i++) {
+    GstClockTime now = i * duration;
+    guint16 seqnum = seqnums[i];
+    RtpTimer *timer;
+    gboolean duplicate;
+
+    rtp_jitter_buffer_append_buffer (jbuf, gst_buffer_ref (buf), now, now,
+        seqnum, 0, &duplicate, NULL);
+
+    timer = rtp_timer_queue_find (timers, seqnum);
+    if (timer) {
+      rtp_timer_queue_unschedule (timers, timer);
+      rtp_timer_free (timer);
+    }
+
+    if (!have_max) {
+      max_seqnum = seqnum;
+      have_max = TRUE;
+    } else if (gst_rtp_buffer_compare_seqnum (max_seqnum, seqnum) > 0) {
+      guint16 missing = max_seqnum + 1;
+      guint count = 0;
+
+      while (missing != seqnum && count++ < MAX_GAP_TIMERS) {
+        rtp_timer_queue_set_expected (timers, missing, now, latency_ns / 4,
+            duration);
+        missing++;
+        n_timers++;
+      }
+      max_seqnum = seqnum;
+    }
+
+    while (rtp_jitter_buffer_num_packets (jbuf) > depth)
+      rtp_jitter_buffer_free_item (rtp_jitter_buffer_pop (jbuf, NULL));
+
+    if (now > latency_ns)
+      rtp_timer_queue_remove_until (timers, now - latency_ns);
+  }
+
+  elapsed = g_timer_elapsed (gtimer, NULL);
+
+  gst_println ("%-8s %7u packets, depth %6u, %6u timers: %8.1f ns/packet",
+      pattern_names[pattern], n, depth, n_timers, elapsed * 1e9 / n);
+
+  g_timer_destroy (gtimer);
+  gst_buffer_unref (buf);
+  g_object_unref (timers);
+  g_object_unref (jbuf);
+  g_free (seqnums);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint rate = DEFAULT_PACKET_RATE;
+  gint latency = DEFAULT_LATENCY;
+  gint packets = DEFAULT_PACKETS;
+  GOptionContext *ctx;
+  Pattern pattern;
+  GOptionEntry options[] = {
+    {"rate", 'r', 0, G_OPTION_ARG_INT, &rate, "Packets per second", NULL},
+    {"latency", 'l', 0, G_OPTION_ARG_INT, &latency,
+        "Jitterbuffer latency (in milliseconds)", NULL},
+    {"packets", 'n', 0, G_OPTION_ARG_INT, &packets,
+        "Number of packets for each pattern", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (rate <= 0 || latency <= 0 || packets <= 0) {
+    gst_printerrln ("rate, latency and packets must be positive");
+    return 1;
+  }
+
+  for (pattern = PATTERN_IN_ORDER; pattern <= PATTERN_LATE; pattern++)
+    do_benchmark (pattern, rate, latency, packets);
+
+  return 0;
+}
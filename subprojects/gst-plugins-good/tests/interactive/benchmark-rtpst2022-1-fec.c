@@ -0,0 +1,282 @@
+/* GStreamer ST 2022-1 FEC encoder and decoder benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Pushes MPEG-TS sized RTP packets through rtpst2022-1-fecenc, drops some of
+ * the media packets and feeds the rest together with the row and column FEC
+ * packets into rtpst2022-1-fecdec. The elements are chained directly without
+ * any queues, so the time spent pushing is the time spent computing the FEC
+ * and recovering packets. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "gst/rtpmanager/gstrtpst2022-1-fecenc.h"
+#include "gst/rtpmanager/gstrtpst2022-1-fecdec.h"
+
+/* 7 MPEG-TS packets per RTP packet */
+#define PAYLOAD_SIZE (7 * 188)
+#define DEFAULT_BITRATE 1000
+#define DEFAULT_PACKETS 500000
+#define DEFAULT_LOSS 1.0
+
+typedef struct
+{
+  guint columns;
+  guint rows;
+} Matrix;
+
+static const Matrix matrices[] = {
+  {5, 5}, {10, 10}, {20, 5}, {20, 20},
+};
+
+typedef struct
+{
+  GRand *rand;
+  gdouble loss;
+  GstClockTime now;
+
+  guint n_dropped;
+  guint n_received;
+} Context;
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  Context *ctx = gst_pad_get_element_private (pad);
+
+  ctx->n_received++;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static GstPadProbeReturn
+drop_media (GstPad * pad, GstPadProbeInfo * info, Context * ctx)
+{
+  if (g_rand_double (ctx->rand) * 100.0 < ctx->loss) {
+    ctx->n_dropped++;
+    return GST_PAD_PROBE_DROP;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* FEC packets are timestamped on arrival like udpsrc would do, the decoder
+ * uses that to expire them */
+static GstPadProbeReturn
+stamp_fec (GstPad * pad, GstPadProbeInfo * info, Context * ctx)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  buffer = gst_buffer_make_writable (buffer);
+  GST_BUFFER_DTS (buffer) = ctx->now;
+  GST_PAD_PROBE_INFO_DATA (info) = buffer;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstBuffer *
+make_packet (guint16 seqnum, guint32 rtptime, const guint8 * payload)
+{
+  GstBuffer *buffer = gst_rtp_buffer_new_allocate (PAYLOAD_SIZE, 0, 0);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+  gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_payload_type (&rtp, 33);
+  gst_rtp_buffer_set_seq (&rtp, seqnum);
+  gst_rtp_buffer_set_timestamp (&rtp, rtptime);
+  gst_rtp_buffer_set_ssrc (&rtp, 0);
+  memcpy (gst_rtp_buffer_get_payload (&rtp), payload, PAYLOAD_SIZE);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buffer;
+}
+
+static void
+push_initial_events (GstPad * pad)
+{
+  GstSegment segment;
+
+  gst_pad_push_event (pad, gst_event_new_stream_start ("benchmark"));
+  gst_pad_push_event (pad,
+      gst_event_new_caps (gst_caps_new_simple ("application/x-rtp", "media",
+              G_TYPE_STRING, "video", "clock-rate", G_TYPE_INT, 90000,
+              "encoding-name", G_TYPE_STRING, "MP2T", "payload", G_TYPE_INT, 33,
+              NULL)));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (pad, gst_event_new_segment (&segment));
+}
+
+static void
+do_benchmark (const Matrix * matrix, gboolean decode, guint bitrate,
+    guint n_packets, gdouble loss)
+{
+  GstElement *enc, *dec = NULL;
+  GstPad *srcpad, *sinkpad, *pad, *fecpad;
+  Context ctx = { 0, };
+  guint8 payloads[8][PAYLOAD_SIZE];
+  GstClockTime duration, elapsed = 0;
+  guint i;
+
+  ctx.rand = g_rand_new_with_seed (42);
+  ctx.loss = loss;
+
+  for (i = 0; i < G_N_ELEMENTS (payloads); i++) {
+    guint j;
+
+    for (j = 0; j < PAYLOAD_SIZE; j++)
+      payloads[i][j] = g_rand_int (ctx.rand);
+  }
+
+  enc = g_object_new (GST_TYPE_RTPST_2022_1_FECENC, "columns",
+      matrix->columns, "rows", matrix->rows, NULL);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+
+  srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  gst_pad_set_element_private (sinkpad, &ctx);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  pad = gst_element_get_static_pad (enc, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+
+  if (decode) {
+    dec = g_object_new (GST_TYPE_RTPST_2022_1_FECDEC, NULL);
+    gst_element_set_state (dec, GST_STATE_PLAYING);
+
+    for (i = 0; i < 2; i++) {
+      gchar *name = g_strdup_printf ("fec_%u", i);
+
+      pad = gst_element_get_static_pad (enc, name);
+      fecpad = gst_element_request_pad_simple (dec, "fec_%u");
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          (GstPadProbeCallback) stamp_fec, &ctx, NULL);
+      gst_pad_link (pad, fecpad);
+      gst_object_unref (fecpad);
+      gst_object_unref (pad);
+      g_free (name);
+    }
+
+    pad = gst_element_get_static_pad (enc, "src");
+    fecpad = gst_element_get_static_pad (dec, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) drop_media, &ctx, NULL);
+    gst_pad_link (pad, fecpad);
+    gst_object_unref (fecpad);
+    gst_object_unref (pad);
+
+    pad = gst_element_get_static_pad (dec, "src");
+  } else {
+    pad = gst_element_get_static_pad (enc, "src");
+  }
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  push_initial_events (srcpad);
+
+  duration = gst_util_uint64_scale (PAYLOAD_SIZE * 8, GST_SECOND,
+      (guint64) bitrate * 1000000);
+
+  for (i = 0; i < n_packets; i++) {
+    GstBuffer *buffer;
+    GstClockTime start;
+
+    ctx.now = i * duration;
+    buffer = make_packet (i, gst_util_uint64_scale (ctx.now, 90000,
+            GST_SECOND), payloads[i % G_N_ELEMENTS (payloads)]);
+    GST_BUFFER_PTS (buffer) = GST_BUFFER_DTS (buffer) = ctx.now;
+
+    start = gst_util_get_timestamp ();
+    gst_pad_push (srcpad, buffer);
+    elapsed += gst_util_get_timestamp () - start;
+  }
+
+  gst_println ("%2ux%-2u %s: %8.1f ns/packet, %6.2f Gbit/s, "
+      "%u dropped, %u of %u delivered", matrix->columns, matrix->rows,
+      decode ? "enc+dec" : "enc    ", (gdouble) elapsed / n_packets,
+      (gdouble) n_packets * PAYLOAD_SIZE * 8 / MAX (elapsed, 1),
+      ctx.n_dropped, ctx.n_received, n_packets);
+
+  gst_element_set_state (enc, GST_STATE_NULL);
+  if (dec) {
+    gst_element_set_state (dec, GST_STATE_NULL);
+    gst_object_unref (dec);
+  }
+  gst_object_unref (enc);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  g_rand_free (ctx.rand);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint bitrate = DEFAULT_BITRATE;
+  gint packets = DEFAULT_PACKETS;
+  gdouble loss = DEFAULT_LOSS;
+  GOptionContext *ctx;
+  guint i;
+  GOptionEntry options[] = {
+    {"bitrate", 'b', 0, G_OPTION_ARG_INT, &bitrate,
+        "Media bitrate used for timestamping (in Mbit/s)", NULL},
+    {"packets", 'n', 0, G_OPTION_ARG_INT, &packets,
+        "Number of media packets for each matrix size", NULL},
+    {"loss", 'l', 0, G_OPTION_ARG_DOUBLE, &loss,
+        "Media packet loss (in percent)", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (bitrate <= 0 || packets <= 0 || loss < 0.0 || loss > 100.0) {
+    gst_printerrln ("bitrate and packets must be positive, loss a percentage");
+    return 1;
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (matrices); i++) {
+    do_benchmark (&matrices[i], FALSE, bitrate, packets, loss);
+    do_benchmark (&matrices[i], TRUE, bitrate, packets, loss);
+  }
+
+  return 0;
+}
@@ -0,0 +1,289 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Starts a local server and opens a number of fake clients against it. The
+ * clients are spread over a few worker threads that keep all connections open
+ * and send OPTIONS and DESCRIBE requests on them in turn. The request latency
+ * shows how well the thread pool of the server copes with many clients. */
+
+#include <gst/gst.h>
+#include <gst/rtsp/gstrtspconnection.h>
+
+#include <gst/rtsp-server/rtsp-server.h>
+
+#define DEFAULT_PORT "8554"
+#define DEFAULT_CLIENTS 1000
+#define DEFAULT_WORKERS 8
+#define DEFAULT_ROUNDS 10
+
+#define TIMEOUT (10 * G_USEC_PER_SEC)
+
+static gchar *port = (gchar *) DEFAULT_PORT;
+static gint n_clients = DEFAULT_CLIENTS;
+static gint n_workers = DEFAULT_WORKERS;
+static gint n_rounds = DEFAULT_ROUNDS;
+static gint max_threads = -1;
+static gboolean load_balancing = FALSE;
+
+static GOptionEntry entries[] = {
+  {"port", 'p', 0, G_OPTION_ARG_STRING, &port,
+      "Port to listen on (default: " DEFAULT_PORT ")", "PORT"},
+  {"clients", 'c', 0, G_OPTION_ARG_INT, &n_clients,
+      "Number of fake clients", "N"},
+  {"workers", 'w', 0, G_OPTION_ARG_INT, &n_workers,
+      "Number of threads running the fake clients", "N"},
+  {"rounds", 'r', 0, G_OPTION_ARG_INT, &n_rounds,
+      "Number of OPTIONS and DESCRIBE rounds for each client", "N"},
+  {"max-threads", 't', 0, G_OPTION_ARG_INT, &max_threads,
+      "Maximum number of server client threads (default: number of cores)",
+      "N"},
+  {"load-balancing", 'b', 0, G_OPTION_ARG_NONE, &load_balancing,
+      "Give new clients to the least loaded server thread", NULL},
+  {NULL}
+};
+
+typedef struct
+{
+  guint n_clients;
+  GThread *thread;
+
+  guint n_requests;
+  guint n_errors;
+  GstClockTime total_latency;
+  GstClockTime max_latency;
+} Worker;
+
+static GMainLoop *loop;
+static gint workers_running;
+
+static gboolean
+do_request (GstRTSPConnection * conn, GstRTSPMethod method, const gchar * url,
+    gint cseq)
+{
+  GstRTSPMessage request = { 0 };
+  GstRTSPMessage response = { 0 };
+  GstRTSPStatusCode code;
+  gchar *cseq_str;
+  gboolean res = FALSE;
+
+  if (gst_rtsp_message_init_request (&request, method, url) != GST_RTSP_OK)
+    return FALSE;
+
+  cseq_str = g_strdup_printf ("%d", cseq);
+  gst_rtsp_message_add_header (&request, GST_RTSP_HDR_CSEQ, cseq_str);
+  g_free (cseq_str);
+  if (method == GST_RTSP_DESCRIBE)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_ACCEPT,
+        "application/sdp");
+
+  if (gst_rtsp_connection_send_usec (conn, &request, TIMEOUT) != GST_RTSP_OK)
+    goto done;
+  if (gst_rtsp_connection_receive_usec (conn, &response, TIMEOUT)
+      != GST_RTSP_OK)
+    goto done;
+  if (gst_rtsp_message_parse_response (&response, &code, NULL,
+          NULL) != GST_RTSP_OK)
+    goto done;
+
+  res = code == GST_RTSP_STS_OK;
+
+done:
+  gst_rtsp_message_unset (&request);
+  gst_rtsp_message_unset (&response);
+
+  return res;
+}
+
+static gpointer
+run_worker (Worker * worker)
+{
+  GstRTSPConnection **conns;
+  GstRTSPUrl *url;
+  gchar *uri;
+  guint i, round;
+
+  uri = g_strdup_printf ("rtsp://127.0.0.1:%s/test", port);
+  gst_rtsp_url_parse (uri, &url);
+
+  conns = g_new0 (GstRTSPConnection *, worker->n_clients);
+
+  for (i = 0; i < worker->n_clients; i++) {
+    if (gst_rtsp_connection_create (url, &conns[i]) != GST_RTSP_OK ||
+        gst_rtsp_connection_connect_usec (conns[i], TIMEOUT) != GST_RTSP_OK) {
+      worker->n_errors++;
+      if (conns[i])
+        gst_rtsp_connection_free (conns[i]);
+      conns[i] = NULL;
+    }
+  }
+
+  /* all connections stay open, requests are sent on them in turn */
+  for (round = 0; round < n_rounds; round++) {
+    for (i = 0; i < worker->n_clients; i++) {
+      GstRTSPMethod method;
+      GstClockTime start, latency;
+
+      if (conns[i] == NULL)
+        continue;
+
+      method = round % 2 ? GST_RTSP_DESCRIBE : GST_RTSP_OPTIONS;
+
+      start = gst_util_get_timestamp ();
+      if (!do_request (conns[i], method, uri, round + 1)) {
+        worker->n_errors++;
+        gst_rtsp_connection_free (conns[i]);
+        conns[i] = NULL;
+        continue;
+      }
+      latency = gst_util_get_timestamp () - start;
+
+      worker->n_requests++;
+      worker->total_latency += latency;
+      worker->max_latency = MAX (worker->max_latency, latency);
+    }
+  }
+
+  for (i = 0; i < worker->n_clients; i++) {
+    if (conns[i])
+      gst_rtsp_connection_free (conns[i]);
+  }
+  g_free (conns);
+  gst_rtsp_url_free (url);
+  g_free (uri);
+
+  if (g_atomic_int_dec_and_test (&workers_running))
+    g_main_loop_quit (loop);
+
+  return NULL;
+}
+
+static gboolean
+start_workers (Worker * workers)
+{
+  gint i;
+
+  for (i = 0; i < n_workers; i++) {
+    gchar *name = g_strdup_printf ("client-load-%d", i);
+
+    workers[i].thread = g_thread_new (name, (GThreadFunc) run_worker,
+        &workers[i]);
+    g_free (name);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+int
+main (int argc, char *argv[])
+{
+  GstRTSPServer *server;
+  GstRTSPMountPoints *mounts;
+  GstRTSPMediaFactory *factory;
+  GstRTSPThreadPool *pool;
+  GOptionContext *optctx;
+  GError *error = NULL;
+  Worker *workers;
+  GstClockTime start, elapsed, total_latency = 0, max_latency = 0;
+  guint n_requests = 0, n_errors = 0;
+  gint i;
+
+  optctx = g_option_context_new ("- Test RTSP Server client load");
+  g_option_context_add_main_entries (optctx, entries, NULL);
+  g_option_context_add_group (optctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (optctx, &argc, &argv, &error)) {
+    g_printerr ("Error parsing options: %s\n", error->message);
+    g_option_context_free (optctx);
+    g_clear_error (&error);
+    return -1;
+  }
+  g_option_context_free (optctx);
+
+  if (n_clients <= 0 || n_workers <= 0 || n_rounds <= 0) {
+    g_printerr ("clients, workers and rounds must be positive\n");
+    return -1;
+  }
+  n_workers = MIN (n_workers, n_clients);
+  if (max_threads < 0)
+    max_threads = g_get_num_processors ();
+
+  loop = g_main_loop_new (NULL, FALSE);
+
+  server = gst_rtsp_server_new ();
+  g_object_set (server, "service", port, NULL);
+  /* the server listens with a backlog, make room for all clients */
+  gst_rtsp_server_set_backlog (server, n_clients);
+
+  pool = gst_rtsp_thread_pool_new ();
+  gst_rtsp_thread_pool_set_max_threads (pool, max_threads);
+  gst_rtsp_thread_pool_set_load_balancing (pool, load_balancing);
+  gst_rtsp_server_set_thread_pool (server, pool);
+  g_object_unref (pool);
+
+  mounts = gst_rtsp_server_get_mount_points (server);
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc is-live=true ! video/x-raw,width=320,height=240 ! "
+      "rtpvrawpay name=pay0 pt=96 )");
+  gst_rtsp_media_factory_set_shared (factory, TRUE);
+  gst_rtsp_mount_points_add_factory (mounts, "/test", factory);
+  g_object_unref (mounts);
+
+  if (gst_rtsp_server_attach (server, NULL) == 0) {
+    g_printerr ("failed to attach the server\n");
+    g_object_unref (server);
+    return -1;
+  }
+
+  workers = g_new0 (Worker, n_workers);
+  for (i = 0; i < n_workers; i++) {
+    workers[i].n_clients = n_clients / n_workers +
+        (i < n_clients % n_workers ? 1 : 0);
+  }
+  workers_running = n_workers;
+
+  g_print ("%d clients on %d workers, server uses %d client threads%s\n",
+      n_clients, n_workers, max_threads,
+      load_balancing ? " with load balancing" : "");
+
+  start = gst_util_get_timestamp ();
+  g_idle_add ((GSourceFunc) start_workers, workers);
+  g_main_loop_run (loop);
+  elapsed = gst_util_get_timestamp () - start;
+
+  for (i = 0; i < n_workers; i++) {
+    g_thread_join (workers[i].thread);
+    n_requests += workers[i].n_requests;
+    n_errors += workers[i].n_errors;
+    total_latency += workers[i].total_latency;
+    max_latency = MAX (max_latency, workers[i].max_latency);
+  }
+
+  g_print ("%u requests in %" GST_TIME_FORMAT ", %.1f requests/s, "
+      "%u errors\n", n_requests, GST_TIME_ARGS (elapsed),
+      n_requests * (gdouble) GST_SECOND / MAX (elapsed, 1), n_errors);
+  if (n_requests > 0)
+    g_print ("latency: average %" GST_TIME_FORMAT ", max %" GST_TIME_FORMAT
+        "\n", GST_TIME_ARGS (total_latency / n_requests),
+        GST_TIME_ARGS (max_latency));
+
+  g_free (workers);
+  g_object_unref (server);
+  g_main_loop_unref (loop);
+
+  return n_errors > 0 ? 1 : 0;
+}
@@ -127,6 +127,8 @@ static GMutex tunnels_lock;
 static GHashTable *tunnels;     /* protected by tunnels_lock */
 
 #define WATCH_BACKLOG_SIZE              100
+/* more data messages than this are allocated on the heap */
+#define MAX_STACK_DATA_MESSAGES         16
 
 #define DEFAULT_SESSION_POOL            NULL
 #define DEFAULT_MOUNT_POINTS            NULL
@@ -1264,8 +1266,13 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
     return FALSE;
   }
 
-  messages = g_newa (GstRTSPMessage, n);
-  memset (messages, 0, sizeof (GstRTSPMessage) * n);
+  /* a batch of samples can hold many packets, keep big ones off the stack */
+  if (n > MAX_STACK_DATA_MESSAGES) {
+    messages = g_new0 (GstRTSPMessage, n);
+  } else {
+    messages = g_newa (GstRTSPMessage, n);
+    memset (messages, 0, sizeof (GstRTSPMessage) * n);
+  }
   for (i = 0; i < n; i++) {
     GstBuffer *buffer = gst_buffer_list_get (buffer_list, i);
     gst_rtsp_message_init_data (&messages[i], channel);
@@ -1287,6 +1294,8 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
   for (i = 0; i < n; i++) {
     gst_rtsp_message_unset (&messages[i]);
   }
+  if (n > MAX_STACK_DATA_MESSAGES)
+    g_free (messages);
 
   if (!ret) {
     GSource *idle_src;
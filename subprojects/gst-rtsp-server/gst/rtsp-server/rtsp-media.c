@@ -162,6 +162,7 @@ struct _GstRTSPMediaPrivate
   guint latency;                /* protected by lock */
   GstClock *clock;              /* protected by lock */
   gboolean do_rate_control;     /* protected by lock */
+  guint tcp_batch_size;         /* protected by lock */
   GstRTSPPublishClockMode publish_clock_mode;
 
   /* Dynamic element handling */
@@ -189,6 +190,8 @@ struct _GstRTSPMediaPrivate
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP     TRUE
+#define DEFAULT_TCP_BATCH_SIZE  1
+#define MAX_TCP_BATCH_SIZE      64
 
 #define DEFAULT_DO_RETRANSMISSION FALSE
 
@@ -566,6 +569,7 @@ gst_rtsp_media_init (GstRTSPMedia * media)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
+  priv->tcp_batch_size = DEFAULT_TCP_BATCH_SIZE;
   priv->dscp_qos = DEFAULT_DSCP_QOS;
   priv->expected_async_done = FALSE;
   priv->blocking_msg_received = 0;
@@ -2713,6 +2717,7 @@ gst_rtsp_media_create_stream (GstRTSPMedia * media, GstElement * payloader,
   gst_rtsp_stream_set_drop_delta_units (stream, priv->ensure_keyunit_on_start);
   gst_rtsp_stream_set_publish_clock_mode (stream, priv->publish_clock_mode);
   gst_rtsp_stream_set_rate_control (stream, priv->do_rate_control);
+  gst_rtsp_stream_set_tcp_batch_size (stream, priv->tcp_batch_size);
 
   g_ptr_array_add (priv->streams, stream);
 
@@ -5630,3 +5635,70 @@ gst_rtsp_media_get_rate_control (GstRTSPMedia * media)
 
   return res;
 }
+
+/**
+ * gst_rtsp_media_set_tcp_batch_size:
+ * @media: a #GstRTSPMedia
+ * @batch_size: the maximum number of RTP samples to send at once
+ *
+ * Set the maximum number of RTP samples that the streams of @media send at
+ * once to their TCP transports. See gst_rtsp_stream_set_tcp_batch_size().
+ *
+ * @batch_size is clamped to 64 samples.
+ *
+ * Since: 1.28
+ */
+void
+gst_rtsp_media_set_tcp_batch_size (GstRTSPMedia * media, guint batch_size)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+  g_return_if_fail (batch_size > 0);
+
+  if (batch_size > MAX_TCP_BATCH_SIZE) {
+    GST_WARNING_OBJECT (media, "TCP batch size %u too big, using %u",
+        batch_size, MAX_TCP_BATCH_SIZE);
+    batch_size = MAX_TCP_BATCH_SIZE;
+  }
+
+  GST_LOG_OBJECT (media, "TCP batch size %u", batch_size);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->tcp_batch_size = batch_size;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+
+    gst_rtsp_stream_set_tcp_batch_size (stream, batch_size);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_tcp_batch_size:
+ * @media: a #GstRTSPMedia
+ *
+ * Returns: the maximum number of RTP samples that the streams of @media send
+ * at once to their TCP transports.
+ *
+ * Since: 1.28
+ */
+guint
+gst_rtsp_media_get_tcp_batch_size (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+  guint res;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA (media), 0);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  res = priv->tcp_batch_size;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
@@ -457,6 +457,12 @@ void                  gst_rtsp_media_set_rate_control (GstRTSPMedia * media, gbo
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_get_rate_control (GstRTSPMedia * media);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_tcp_batch_size (GstRTSPMedia * media, guint batch_size);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_get_tcp_batch_size (GstRTSPMedia * media);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTSPMedia, gst_object_unref)
 #endif
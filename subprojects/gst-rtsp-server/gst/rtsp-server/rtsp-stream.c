@@ -153,6 +153,9 @@ struct _GstRTSPStreamPrivate
   /* rate control */
   gboolean do_rate_control;
 
+  /* maximum number of RTP samples sent at once to TCP transports */
+  guint tcp_batch_size;
+
   /* Forward Error Correction with RFC 5109 */
   GstElement *ulpfec_decoder;
   GstElement *ulpfec_encoder;
@@ -248,6 +251,8 @@ struct _GstRTSPStreamPrivate
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP TRUE
+#define DEFAULT_TCP_BATCH_SIZE 1
+#define MAX_TCP_BATCH_SIZE 64
 
 enum
 {
@@ -348,6 +353,7 @@ gst_rtsp_stream_init (GstRTSPStream * stream)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
+  priv->tcp_batch_size = DEFAULT_TCP_BATCH_SIZE;
 
   g_mutex_init (&priv->lock);
 
@@ -2680,6 +2686,47 @@ check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
   }
 }
 
+/* Must be called with priv->lock. Collects the RTP samples queued in @sink,
+ * up to the TCP batch size, into one buffer list. The packets are only
+ * referenced, so they are serialized once for all TCP transports and every
+ * transport writes the whole batch as a single message. */
+static GstBufferList *
+pull_tcp_batch (GstRTSPStream * stream, GstAppSink * sink, GstSample * sample)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstBufferList *batch;
+  guint n_samples = 0;
+
+  batch = gst_buffer_list_new ();
+  gst_sample_ref (sample);
+
+  do {
+    GstBuffer *buffer = gst_sample_get_buffer (sample);
+    GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+
+    if (buffer_list) {
+      guint i, n = gst_buffer_list_length (buffer_list);
+
+      for (i = 0; i < n; i++)
+        gst_buffer_list_add (batch,
+            gst_buffer_ref (gst_buffer_list_get (buffer_list, i)));
+    } else if (buffer) {
+      gst_buffer_list_add (batch, gst_buffer_ref (buffer));
+    }
+    gst_sample_unref (sample);
+  } while (++n_samples < priv->tcp_batch_size &&
+      (sample = gst_app_sink_try_pull_sample (sink, 0)) != NULL);
+
+  /* there might be more samples queued, check again on the next round */
+  if (n_samples == priv->tcp_batch_size)
+    priv->have_buffer[0] = TRUE;
+
+  GST_LOG_OBJECT (stream, "sending %u samples, %u buffers in one batch",
+      n_samples, gst_buffer_list_length (batch));
+
+  return batch;
+}
+
 /* Must be called with priv->lock */
 static void
 send_tcp_message (GstRTSPStream * stream, gint idx)
@@ -2689,6 +2736,7 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
   GstSample *sample;
   GstBuffer *buffer;
   GstBufferList *buffer_list;
+  GstBufferList *batch = NULL;
   gboolean is_rtp;
   GPtrArray *transports;
 
@@ -2710,13 +2758,24 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
   }
 
   sink = GST_APP_SINK (priv->appsink[idx]);
-  sample = gst_app_sink_pull_sample (sink);
+  if (is_rtp && priv->tcp_batch_size > 1) {
+    /* samples might have been pulled already by a previous batch */
+    sample = gst_app_sink_try_pull_sample (sink, 0);
+  } else {
+    sample = gst_app_sink_pull_sample (sink);
+  }
   if (!sample) {
     return;
   }
 
-  buffer = gst_sample_get_buffer (sample);
-  buffer_list = gst_sample_get_buffer_list (sample);
+  if (is_rtp && priv->tcp_batch_size > 1) {
+    batch = pull_tcp_batch (stream, sink, sample);
+    buffer = NULL;
+    buffer_list = batch;
+  } else {
+    buffer = gst_sample_get_buffer (sample);
+    buffer_list = gst_sample_get_buffer_list (sample);
+  }
 
   /* We will get one message-sent notification per buffer or
    * complete buffer-list. We handle each buffer-list as a unit */
@@ -2751,6 +2810,7 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
     }
   }
   gst_sample_unref (sample);
+  gst_clear_buffer_list (&batch);
 
   g_mutex_unlock (&priv->lock);
 
@@ -3643,7 +3703,7 @@ create_sender_part (GstRTSPStream * stream, const GstRTSPTransport * transport)
       /* make appsink */
       priv->appsink[i] = gst_element_factory_make ("appsink", NULL);
       g_object_set (priv->appsink[i], "emit-signals", FALSE, "buffer-list",
-          TRUE, "max-buffers", 1, NULL);
+          TRUE, "max-buffers", (i == 0) ? priv->tcp_batch_size : 1, NULL);
 
       if (i == 0)
         g_object_set (priv->appsink[i], "sync", priv->do_rate_control, NULL);
@@ -6500,6 +6560,66 @@ gst_rtsp_stream_get_rate_control (GstRTSPStream * stream)
   return ret;
 }
 
+/**
+ * gst_rtsp_stream_set_tcp_batch_size:
+ * @stream: a #GstRTSPStream
+ * @batch_size: the maximum number of RTP samples to send at once
+ *
+ * Set the maximum number of RTP samples that are sent at once to the TCP
+ * transports of @stream. When the TCP transports can't keep up with the media,
+ * up to @batch_size samples are queued and then written to every transport as
+ * a single batch, so that each packet is only serialized once and each client
+ * gets one write for the whole batch. Transports that still fall behind are
+ * dropped when their backlog is full, the media is not blocked by them.
+ *
+ * @batch_size is clamped to 64 samples.
+ *
+ * Since: 1.28
+ */
+void
+gst_rtsp_stream_set_tcp_batch_size (GstRTSPStream * stream, guint batch_size)
+{
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+  g_return_if_fail (batch_size > 0);
+
+  if (batch_size > MAX_TCP_BATCH_SIZE) {
+    GST_WARNING_OBJECT (stream, "TCP batch size %u too big, using %u",
+        batch_size, MAX_TCP_BATCH_SIZE);
+    batch_size = MAX_TCP_BATCH_SIZE;
+  }
+
+  GST_DEBUG_OBJECT (stream, "TCP batch size %u", batch_size);
+
+  g_mutex_lock (&stream->priv->lock);
+  stream->priv->tcp_batch_size = batch_size;
+  if (stream->priv->appsink[0])
+    g_object_set (stream->priv->appsink[0], "max-buffers", batch_size, NULL);
+  g_mutex_unlock (&stream->priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_tcp_batch_size:
+ * @stream: a #GstRTSPStream
+ *
+ * Returns: the maximum number of RTP samples sent at once to the TCP
+ * transports of @stream.
+ *
+ * Since: 1.28
+ */
+guint
+gst_rtsp_stream_get_tcp_batch_size (GstRTSPStream * stream)
+{
+  guint ret;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), 0);
+
+  g_mutex_lock (&stream->priv->lock);
+  ret = stream->priv->tcp_batch_size;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return ret;
+}
+
 /**
  * gst_rtsp_stream_unblock_rtcp:
  *
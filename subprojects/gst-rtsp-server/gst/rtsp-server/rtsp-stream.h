@@ -365,6 +365,12 @@ void               gst_rtsp_stream_set_rate_control (GstRTSPStream * stream, gbo
 GST_RTSP_SERVER_API
 gboolean           gst_rtsp_stream_get_rate_control (GstRTSPStream * stream);
 
+GST_RTSP_SERVER_API
+void               gst_rtsp_stream_set_tcp_batch_size (GstRTSPStream * stream, guint batch_size);
+
+GST_RTSP_SERVER_API
+guint              gst_rtsp_stream_get_tcp_batch_size (GstRTSPStream * stream);
+
 GST_RTSP_SERVER_API
 void               gst_rtsp_stream_unblock_rtcp (GstRTSPStream * stream);
 
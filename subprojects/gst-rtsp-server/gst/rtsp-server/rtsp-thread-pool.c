@@ -29,6 +29,12 @@
  * number of threads can be set after which the pool will start to reuse the
  * same thread for multiple clients.
  *
+ * By default clients are assigned to the reused threads in a round-robin
+ * fashion. With gst_rtsp_thread_pool_set_load_balancing() each new client is
+ * instead given to the thread that currently serves the least clients. Setting
+ * the maximum number of threads to g_get_num_processors() then spreads the
+ * clients over one mainloop per core.
+ *
  * Threads of type #GST_RTSP_THREAD_TYPE_MEDIA will be used to perform the state
  * changes of the media pipelines and handle its bus messages.
  *
@@ -192,16 +198,19 @@ struct _GstRTSPThreadPoolPrivate
   GMutex lock;
 
   gint max_threads;
+  gboolean load_balancing;
   /* currently used mainloops */
   GQueue threads;
 };
 
 #define DEFAULT_MAX_THREADS 1
+#define DEFAULT_LOAD_BALANCING FALSE
 
 enum
 {
   PROP_0,
   PROP_MAX_THREADS,
+  PROP_LOAD_BALANCING,
   PROP_LAST
 };
 
@@ -247,6 +256,20 @@ gst_rtsp_thread_pool_class_init (GstRTSPThreadPoolClass * klass)
           "(0 = only mainloop, -1 = unlimited)", -1, G_MAXINT,
           DEFAULT_MAX_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPThreadPool::load-balancing:
+   *
+   * When the maximum amount of client threads is reached, give new clients
+   * to the thread that serves the least clients instead of reusing the
+   * threads in a round-robin fashion.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_LOAD_BALANCING,
+      g_param_spec_boolean ("load-balancing", "Load Balancing",
+          "Give new clients to the least loaded client thread",
+          DEFAULT_LOAD_BALANCING, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   klass->get_thread = default_get_thread;
 
   GST_DEBUG_CATEGORY_INIT (rtsp_thread_pool_debug, "rtspthreadpool", 0,
@@ -264,6 +287,7 @@ gst_rtsp_thread_pool_init (GstRTSPThreadPool * pool)
 
   g_mutex_init (&priv->lock);
   priv->max_threads = DEFAULT_MAX_THREADS;
+  priv->load_balancing = DEFAULT_LOAD_BALANCING;
   g_queue_init (&priv->threads);
 }
 
@@ -291,6 +315,10 @@ gst_rtsp_thread_pool_get_property (GObject * object, guint propid,
     case PROP_MAX_THREADS:
       g_value_set_int (value, gst_rtsp_thread_pool_get_max_threads (pool));
       break;
+    case PROP_LOAD_BALANCING:
+      g_value_set_boolean (value,
+          gst_rtsp_thread_pool_get_load_balancing (pool));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -306,6 +334,10 @@ gst_rtsp_thread_pool_set_property (GObject * object, guint propid,
     case PROP_MAX_THREADS:
       gst_rtsp_thread_pool_set_max_threads (pool, g_value_get_int (value));
       break;
+    case PROP_LOAD_BALANCING:
+      gst_rtsp_thread_pool_set_load_balancing (pool,
+          g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -409,6 +441,94 @@ gst_rtsp_thread_pool_get_max_threads (GstRTSPThreadPool * pool)
   return res;
 }
 
+/**
+ * gst_rtsp_thread_pool_set_load_balancing:
+ * @pool: a #GstRTSPThreadPool
+ * @load_balancing: the new value
+ *
+ * Configure how client threads are reused once the maximum number of threads
+ * is reached. When @load_balancing is %TRUE, a new client is handled by the
+ * thread that serves the least clients, otherwise the threads are reused in a
+ * round-robin fashion.
+ *
+ * Since: 1.28
+ */
+void
+gst_rtsp_thread_pool_set_load_balancing (GstRTSPThreadPool * pool,
+    gboolean load_balancing)
+{
+  GstRTSPThreadPoolPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_THREAD_POOL (pool));
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->load_balancing = load_balancing;
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_thread_pool_get_load_balancing:
+ * @pool: a #GstRTSPThreadPool
+ *
+ * Check if client threads are reused based on their load.
+ * See gst_rtsp_thread_pool_set_load_balancing().
+ *
+ * Returns: %TRUE if new clients go to the least loaded thread.
+ *
+ * Since: 1.28
+ */
+gboolean
+gst_rtsp_thread_pool_get_load_balancing (GstRTSPThreadPool * pool)
+{
+  GstRTSPThreadPoolPrivate *priv;
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_RTSP_THREAD_POOL (pool), FALSE);
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  res = priv->load_balancing;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/* with priv->lock. Removes the thread that serves the least clients from the
+ * queue. The reuse counter of a client thread is the number of clients that
+ * are attached to its mainloop. */
+static GstRTSPThread *
+pop_least_loaded (GstRTSPThreadPool * pool)
+{
+  GstRTSPThreadPoolPrivate *priv = pool->priv;
+  GstRTSPThread *thread;
+  GList *walk, *best = NULL;
+  gint best_load = G_MAXINT;
+
+  for (walk = priv->threads.head; walk; walk = walk->next) {
+    GstRTSPThreadImpl *impl = walk->data;
+    gint load = g_atomic_int_get (&impl->reused);
+
+    if (load < best_load) {
+      best = walk;
+      best_load = load;
+    }
+  }
+
+  if (best == NULL)
+    return NULL;
+
+  GST_DEBUG_OBJECT (pool, "least loaded thread %p has %d clients", best->data,
+      best_load);
+
+  thread = best->data;
+  g_queue_delete_link (&priv->threads, best);
+
+  return thread;
+}
+
 static GstRTSPThread *
 make_thread (GstRTSPThreadPool * pool, GstRTSPThreadType type,
     GstRTSPContext * ctx)
@@ -453,7 +573,10 @@ default_get_thread (GstRTSPThreadPool * pool,
         if (priv->max_threads > 0 &&
             g_queue_get_length (&priv->threads) >= priv->max_threads) {
           /* max threads reached, recycle from queue */
-          thread = g_queue_pop_head (&priv->threads);
+          if (priv->load_balancing)
+            thread = pop_least_loaded (pool);
+          else
+            thread = g_queue_pop_head (&priv->threads);
           GST_DEBUG_OBJECT (pool, "recycle client thread %p", thread);
           if (!gst_rtsp_thread_reuse (thread)) {
             GST_DEBUG_OBJECT (pool, "thread %p stopping, retry", thread);
@@ -171,6 +171,13 @@ void                gst_rtsp_thread_pool_set_max_threads (GstRTSPThreadPool * po
 GST_RTSP_SERVER_API
 gint                gst_rtsp_thread_pool_get_max_threads (GstRTSPThreadPool * pool);
 
+GST_RTSP_SERVER_API
+void                gst_rtsp_thread_pool_set_load_balancing (GstRTSPThreadPool * pool,
+                                                             gboolean load_balancing);
+
+GST_RTSP_SERVER_API
+gboolean            gst_rtsp_thread_pool_get_load_balancing (GstRTSPThreadPool * pool);
+
 GST_RTSP_SERVER_API
 GstRTSPThread *     gst_rtsp_thread_pool_get_thread      (GstRTSPThreadPool *pool,
                                                           GstRTSPThreadType type,
@@ -18,6 +18,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/rtp/gstrtpbuffer.h>
 
 #include <rtsp-stream.h>
 #include <rtsp-address-pool.h>
@@ -498,6 +499,200 @@ GST_START_TEST (test_tcp_transport)
 
 GST_END_TEST;
 
+GST_START_TEST (test_tcp_batch_size)
+{
+  GstPad *srcpad;
+  GstElement *pay;
+  GstRTSPStream *stream;
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  gst_object_unref (srcpad);
+
+  fail_unless_equals_int (gst_rtsp_stream_get_tcp_batch_size (stream), 1);
+  gst_rtsp_stream_set_tcp_batch_size (stream, 32);
+  fail_unless_equals_int (gst_rtsp_stream_get_tcp_batch_size (stream), 32);
+  gst_rtsp_stream_set_tcp_batch_size (stream, G_MAXUINT);
+  fail_unless_equals_int (gst_rtsp_stream_get_tcp_batch_size (stream), 64);
+
+  gst_object_unref (stream);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  gboolean release;
+  GArray *list_lengths;
+  GArray *seqnums;
+} TcpBatchData;
+
+static gboolean
+tcp_batch_send_rtp_list (GstBufferList * buffer_list, guint8 channel,
+    gpointer user_data)
+{
+  TcpBatchData *data = user_data;
+  guint i, len;
+
+  len = gst_buffer_list_length (buffer_list);
+
+  g_mutex_lock (&data->lock);
+  for (i = 0; i < len; i++) {
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    guint16 seqnum;
+
+    fail_unless (gst_rtp_buffer_map (gst_buffer_list_get (buffer_list, i),
+            GST_MAP_READ, &rtp));
+    seqnum = gst_rtp_buffer_get_seq (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+    g_array_append_val (data->seqnums, seqnum);
+  }
+  g_array_append_val (data->list_lengths, len);
+  g_cond_broadcast (&data->cond);
+
+  /* keep the send thread busy until the test has queued more samples */
+  while (!data->release)
+    g_cond_wait (&data->cond, &data->lock);
+  g_mutex_unlock (&data->lock);
+
+  return TRUE;
+}
+
+static GstBuffer *
+generate_rtp_buffer (guint16 seqnum)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf;
+
+  buf = gst_rtp_buffer_new_allocate (10, 0, 0);
+  GST_BUFFER_PTS (buf) = seqnum * 10 * GST_MSECOND;
+
+  gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_payload_type (&rtp, 96);
+  gst_rtp_buffer_set_seq (&rtp, seqnum);
+  gst_rtp_buffer_set_timestamp (&rtp, seqnum * 900);
+  gst_rtp_buffer_set_ssrc (&rtp, 0x12345678);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buf;
+}
+
+GST_START_TEST (test_tcp_batch_send)
+{
+  TcpBatchData data;
+  GstRTSPTransport *transport;
+  GstRTSPStreamTransport *tr;
+  GstRTSPStream *stream;
+  GstPad *srcpad;
+  GstElement *pay;
+  GstBin *bin;
+  GstElement *rtpbin;
+  GstCaps *caps;
+  GstSegment segment;
+  guint i;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.release = FALSE;
+  data.list_lengths = g_array_new (FALSE, FALSE, sizeof (guint));
+  data.seqnums = g_array_new (FALSE, FALSE, sizeof (guint16));
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  rtpbin = gst_element_factory_make ("rtpbin", "testrtpbin");
+  fail_unless (rtpbin != NULL);
+  bin = GST_BIN (gst_bin_new ("testbin"));
+  fail_unless (bin != NULL);
+  fail_unless (gst_bin_add (bin, rtpbin));
+
+  /* TCP transport, batches of up to 4 samples */
+  gst_rtsp_stream_set_protocols (stream, GST_RTSP_LOWER_TRANS_TCP);
+  gst_rtsp_stream_set_enable_rtcp (stream, FALSE);
+  gst_rtsp_stream_set_rate_control (stream, FALSE);
+  gst_rtsp_stream_set_tcp_batch_size (stream, 4);
+  fail_unless (gst_rtsp_stream_join_bin (stream, bin, rtpbin, GST_STATE_NULL));
+
+  fail_unless (gst_rtsp_transport_new (&transport) == GST_RTSP_OK);
+  transport->lower_transport = GST_RTSP_LOWER_TRANS_TCP;
+  transport->interleaved.min = 0;
+  transport->interleaved.max = 1;
+  fail_unless (gst_rtsp_stream_complete_stream (stream, transport));
+
+  tr = gst_rtsp_stream_transport_new (stream, transport);
+  fail_unless (tr);
+  gst_rtsp_stream_transport_set_list_callbacks (tr, tcp_batch_send_rtp_list,
+      NULL, &data, NULL);
+  fail_unless (gst_rtsp_stream_add_transport (stream, tr));
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (bin), GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_simple ("application/x-rtp",
+      "media", G_TYPE_STRING, "application", "clock-rate", G_TYPE_INT, 90000,
+      "encoding-name", G_TYPE_STRING, "X-GST", "payload", G_TYPE_INT, 96,
+      NULL);
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  /* the first sample is sent on its own and blocks the send thread */
+  fail_unless_equals_int (gst_pad_push (srcpad, generate_rtp_buffer (0)),
+      GST_FLOW_OK);
+  g_mutex_lock (&data.lock);
+  while (data.list_lengths->len < 1)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  /* these are queued meanwhile and must be sent as one batch */
+  for (i = 1; i < 5; i++)
+    fail_unless_equals_int (gst_pad_push (srcpad, generate_rtp_buffer (i)),
+        GST_FLOW_OK);
+
+  g_mutex_lock (&data.lock);
+  data.release = TRUE;
+  g_cond_broadcast (&data.cond);
+  while (data.seqnums->len < 5)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  fail_unless_equals_int (data.list_lengths->len, 2);
+  fail_unless_equals_int (g_array_index (data.list_lengths, guint, 0), 1);
+  fail_unless_equals_int (g_array_index (data.list_lengths, guint, 1), 4);
+  for (i = 0; i < 5; i++)
+    fail_unless_equals_int (g_array_index (data.seqnums, guint16, i), i);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (bin), GST_STATE_NULL) ==
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_rtsp_stream_remove_transport (stream, tr));
+  fail_unless (gst_rtsp_stream_leave_bin (stream, bin, rtpbin));
+  g_object_unref (tr);
+  gst_object_unref (bin);
+  gst_object_unref (stream);
+  gst_object_unref (srcpad);
+
+  g_array_unref (data.list_lengths);
+  g_array_unref (data.seqnums);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
 static void
 check_multicast_client_address (const gchar * destination, guint port,
     const gchar * expected_addr_str, gboolean expected_res)
@@ -695,6 +890,8 @@ rtspstream_suite (void)
   tcase_add_test (tc, test_allocate_udp_ports_multicast);
   tcase_add_test (tc, test_allocate_udp_ports_client_settings);
   tcase_add_test (tc, test_tcp_transport);
+  tcase_add_test (tc, test_tcp_batch_size);
+  tcase_add_test (tc, test_tcp_batch_send);
   tcase_add_test (tc, test_multicast_client_address);
   tcase_add_test (tc, test_multicast_client_address_invalid);
   tcase_add_test (tc, test_add_transport_twice);
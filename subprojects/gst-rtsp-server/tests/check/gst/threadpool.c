@@ -189,6 +189,59 @@ GST_START_TEST (test_pool_max_threads_property)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pool_load_balancing)
+{
+  GstRTSPThreadPool *pool;
+  GstRTSPThread *thread1;
+  GstRTSPThread *thread2;
+  GstRTSPThread *thread3;
+  GstRTSPThread *thread4;
+  GstRTSPThread *thread5;
+  gboolean load_balancing;
+
+  pool = gst_rtsp_thread_pool_new ();
+  fail_unless (GST_IS_RTSP_THREAD_POOL (pool));
+
+  fail_if (gst_rtsp_thread_pool_get_load_balancing (pool));
+  g_object_set (pool, "load-balancing", TRUE, NULL);
+  g_object_get (pool, "load-balancing", &load_balancing, NULL);
+  fail_unless (load_balancing);
+
+  gst_rtsp_thread_pool_set_max_threads (pool, 2);
+
+  thread1 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (GST_IS_RTSP_THREAD (thread1));
+  thread2 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (GST_IS_RTSP_THREAD (thread2));
+  fail_unless (thread2 != thread1);
+
+  thread3 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread3 == thread1);
+  thread4 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread4 == thread2);
+
+  /* thread2 now serves one client less than thread1, round-robin would pick
+   * thread1 here */
+  gst_rtsp_thread_stop (thread4);
+  thread5 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread5 == thread2);
+
+  gst_rtsp_thread_stop (thread1);
+  gst_rtsp_thread_stop (thread2);
+  gst_rtsp_thread_stop (thread3);
+  gst_rtsp_thread_stop (thread5);
+  g_object_unref (pool);
+
+  gst_rtsp_thread_pool_cleanup ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_pool_thread_copy)
 {
   GstRTSPThreadPool *pool;
@@ -228,6 +281,7 @@ rtspthreadpool_suite (void)
   tcase_add_test (tc, test_pool_get_thread_reuse);
   tcase_add_test (tc, test_pool_max_threads);
   tcase_add_test (tc, test_pool_max_threads_property);
+  tcase_add_test (tc, test_pool_load_balancing);
   tcase_add_test (tc, test_pool_thread_copy);
 
   return s;